@@ -8,12 +8,21 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include "third_party/googletest/src/include/gtest/gtest.h"
 
 #include "./vpx_config.h"
 #include "test/ivf_video_source.h"
+#include "test/md5_helper.h"
 #include "vpx/vp8dx.h"
 #include "vpx/vpx_decoder.h"
+#include "vpx_util/vpx_thread.h"
+#if CONFIG_VP9_DECODER
+#include "vp9/vp9_dx_iface.h"
+#endif
 
 namespace {
 
@@ -170,6 +179,959 @@ TEST(DecodeAPI, Vp9PeekSI) {
               vpx_codec_peek_stream_info(codec, data, data_sz, &si));
   }
 }
+
+// Each compressed frame is handed to the decoder in its own heap buffer,
+// passed as user_priv. The release callback scribbles over the buffer before
+// freeing it, so a buffer released too early corrupts the decoded output.
+void ReleaseInput(void *release_state, const unsigned char *data,
+                  void *user_priv) {
+  std::vector<uint8_t> *const buf =
+      reinterpret_cast<std::vector<uint8_t> *>(user_priv);
+  EXPECT_EQ(&(*buf)[0], data);
+  memset(&(*buf)[0], 0xff, buf->size());
+  delete buf;
+  ++*reinterpret_cast<int *>(release_state);
+}
+
+void DecodeWithInputRelease(int threads, vpx_codec_flags_t flags,
+                            bool release_cb, std::string *md5_out) {
+  const vpx_codec_iface_t *const codec = &vpx_codec_vp9_dx_algo;
+  libvpx_test::IVFVideoSource video("vp90-2-05-resize.ivf");
+  video.Init();
+  ASSERT_NO_FATAL_FAILURE(video.Begin());
+
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  cfg.threads = threads;
+  vpx_codec_ctx_t dec;
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&dec, codec, &cfg, flags));
+  int released = 0;
+  vpx_release_input_init init = { ReleaseInput, &released };
+  if (release_cb) {
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&dec, VP9D_SET_INPUT_RELEASE_CB, &init));
+  }
+
+  libvpx_test::MD5 md5;
+  int submitted = 0;
+  bool flushed = false;
+  while (!flushed) {
+    if (video.cxdata() != NULL) {
+      std::vector<uint8_t> *const buf = new std::vector<uint8_t>(
+          video.cxdata(), video.cxdata() + video.frame_size());
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_decode(&dec, &(*buf)[0],
+                                 static_cast<unsigned int>(buf->size()), buf,
+                                 0));
+      ++submitted;
+      if (!release_cb) delete buf;
+      video.Next();
+    } else {
+      EXPECT_EQ(VPX_CODEC_OK, vpx_codec_decode(&dec, NULL, 0, NULL, 0));
+      flushed = true;
+    }
+    vpx_codec_iter_t iter = NULL;
+    const vpx_image_t *img;
+    while ((img = vpx_codec_get_frame(&dec, &iter)) != NULL) md5.Add(img);
+  }
+
+  // The decoder must still hold the buffers the release callback has not been
+  // invoked for, so they can only all be released once it is destroyed.
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+  if (release_cb) {
+    EXPECT_EQ(submitted, released);
+  }
+  *md5_out = md5.Get();
+}
+
+TEST(DecodeAPI, Vp9InputReleaseCallback) {
+  std::string expected_md5;
+  std::string md5;
+  ASSERT_NO_FATAL_FAILURE(DecodeWithInputRelease(1, 0, false, &expected_md5));
+  ASSERT_NO_FATAL_FAILURE(DecodeWithInputRelease(1, 0, true, &md5));
+  EXPECT_EQ(expected_md5, md5);
+  for (int threads = 2; threads <= 4; ++threads) {
+    ASSERT_NO_FATAL_FAILURE(DecodeWithInputRelease(
+        threads, VPX_CODEC_USE_FRAME_THREADING, true, &md5));
+    EXPECT_EQ(expected_md5, md5) << "threads = " << threads;
+  }
+}
+
+// Decodes vp90-2-05-resize.ivf with every 'period'th frame truncated to half
+// its size, and counts the calls to decode, including the flush, that fail.
+void DecodeTruncatedFrames(int threads, vpx_codec_flags_t flags, int period,
+                           int *errors) {
+  const vpx_codec_iface_t *const codec = &vpx_codec_vp9_dx_algo;
+  libvpx_test::IVFVideoSource video("vp90-2-05-resize.ivf");
+  video.Init();
+  ASSERT_NO_FATAL_FAILURE(video.Begin());
+
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  cfg.threads = threads;
+  vpx_codec_ctx_t dec;
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&dec, codec, &cfg, flags));
+
+  *errors = 0;
+  for (int frame = 0;; ++frame) {
+    vpx_codec_err_t res;
+    if (video.cxdata() != NULL) {
+      unsigned int frame_size = static_cast<unsigned int>(video.frame_size());
+      if (frame > 0 && frame % period == 0) frame_size /= 2;
+      res = vpx_codec_decode(&dec, video.cxdata(), frame_size, NULL, 0);
+    } else {
+      res = vpx_codec_decode(&dec, NULL, 0, NULL, 0);
+    }
+    if (res != VPX_CODEC_OK) ++*errors;
+    vpx_codec_iter_t iter = NULL;
+    while (vpx_codec_get_frame(&dec, &iter) != NULL) {
+    }
+    if (video.cxdata() == NULL) break;
+    video.Next();
+  }
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+}
+
+// Frames that fail to decode on a frame worker must be reported by a later
+// call to decode rather than dropped.
+TEST(DecodeAPI, Vp9FrameParallelCorruptFrames) {
+  const int kPeriod = 5;
+  int serial_errors;
+  ASSERT_NO_FATAL_FAILURE(DecodeTruncatedFrames(1, 0, kPeriod, &serial_errors));
+  ASSERT_GT(serial_errors, 0);
+  for (int threads = 2; threads <= 4; ++threads) {
+    int errors;
+    ASSERT_NO_FATAL_FAILURE(DecodeTruncatedFrames(
+        threads, VPX_CODEC_USE_FRAME_THREADING, kPeriod, &errors));
+    EXPECT_GT(errors, 0) << "threads = " << threads;
+    EXPECT_LE(errors, serial_errors) << "threads = " << threads;
+  }
+}
+
+// Returns the decoder's frame size dependent context buffers.
+std::vector<const void *> GetVp9ContextBuffers(vpx_codec_ctx_t *dec) {
+  const vpx_codec_alg_priv_t *const ctx =
+      reinterpret_cast<vpx_codec_alg_priv_t *>(dec->priv);
+  const FrameWorkerData *const frame_worker_data =
+      reinterpret_cast<FrameWorkerData *>(ctx->frame_workers[0].data1);
+  const VP9_COMMON *const cm = &frame_worker_data->pbi->common;
+  std::vector<const void *> buffers;
+  buffers.push_back(cm->mip);
+  buffers.push_back(cm->seg_map_array[0]);
+  buffers.push_back(cm->lf.lfm);
+  buffers.push_back(cm->above_context);
+  buffers.push_back(cm->above_seg_context);
+  return buffers;
+}
+
+// Decodes the stream with a frame size hint of w x h. While the frames fit
+// in the hint, the context buffers must stay those of the first frame.
+void DecodeWithFrameSizeHint(int threads, int row_mt, unsigned int w,
+                             unsigned int h, std::string *md5_out) {
+  const vpx_codec_iface_t *const codec = &vpx_codec_vp9_dx_algo;
+  libvpx_test::IVFVideoSource video("vp90-2-05-resize.ivf");
+  video.Init();
+  ASSERT_NO_FATAL_FAILURE(video.Begin());
+
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  cfg.threads = threads;
+  cfg.w = w;
+  cfg.h = h;
+  vpx_codec_ctx_t dec;
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&dec, codec, &cfg, 0));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_SET_ROW_MT, row_mt));
+
+  libvpx_test::MD5 md5;
+  std::vector<const void *> buffers;
+  for (; video.cxdata() != NULL; video.Next()) {
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec, video.cxdata(),
+                               static_cast<unsigned int>(video.frame_size()),
+                               NULL, 0));
+    vpx_codec_iter_t iter = NULL;
+    const vpx_image_t *img;
+    while ((img = vpx_codec_get_frame(&dec, &iter)) != NULL) {
+      md5.Add(img);
+      if (img->d_w > w || img->d_h > h) continue;
+      if (buffers.empty()) {
+        buffers = GetVp9ContextBuffers(&dec);
+      } else {
+        EXPECT_TRUE(buffers == GetVp9ContextBuffers(&dec))
+            << "Reallocated at " << img->d_w << "x" << img->d_h;
+      }
+    }
+  }
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+  *md5_out = md5.Get();
+}
+
+// The frame size hint only changes how the context buffers are allocated, so
+// hints both smaller and larger than the stream must decode identically, and
+// frame size changes within the hint must not reallocate them.
+TEST(DecodeAPI, Vp9FrameSizeHint) {
+  static const unsigned int kHints[][2] = { { 0, 0 },
+                                            { 320, 240 },
+                                            { 1920, 1080 } };
+  std::string expected_md5;
+  ASSERT_NO_FATAL_FAILURE(DecodeWithFrameSizeHint(1, 0, 0, 0, &expected_md5));
+  for (int threads = 1; threads <= 4; threads += 3) {
+    for (int row_mt = 0; row_mt <= 1; ++row_mt) {
+      for (int i = 0; i < NELEMENTS(kHints); ++i) {
+        std::string md5;
+        DecodeWithFrameSizeHint(threads, row_mt, kHints[i][0], kHints[i][1],
+                                &md5);
+        EXPECT_EQ(expected_md5, md5)
+            << "threads = " << threads << ", row_mt = " << row_mt
+            << ", hint = " << kHints[i][0] << "x" << kHints[i][1];
+      }
+    }
+  }
+}
+
+void DecodeLuma(int threads, int row_mt, int luma_only, std::string *md5_out) {
+  const vpx_codec_iface_t *const codec = &vpx_codec_vp9_dx_algo;
+  libvpx_test::IVFVideoSource video("vp90-2-05-resize.ivf");
+  video.Init();
+  ASSERT_NO_FATAL_FAILURE(video.Begin());
+
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  cfg.threads = threads;
+  vpx_codec_ctx_t dec;
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&dec, codec, &cfg, 0));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_SET_ROW_MT, row_mt));
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&dec, VP9D_SET_LUMA_ONLY, luma_only));
+
+  libvpx_test::MD5 md5;
+  for (; video.cxdata() != NULL; video.Next()) {
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec, video.cxdata(),
+                               static_cast<unsigned int>(video.frame_size()),
+                               NULL, 0));
+    vpx_codec_iter_t iter = NULL;
+    const vpx_image_t *img;
+    while ((img = vpx_codec_get_frame(&dec, &iter)) != NULL) {
+      if (luma_only) {
+        EXPECT_TRUE(img->planes[VPX_PLANE_U] == NULL);
+        EXPECT_TRUE(img->planes[VPX_PLANE_V] == NULL);
+      }
+      const uint8_t *buf = img->planes[VPX_PLANE_Y];
+      for (unsigned int y = 0; y < img->d_h; ++y) {
+        md5.Add(buf, img->d_w);
+        buf += img->stride[VPX_PLANE_Y];
+      }
+    }
+  }
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+  *md5_out = md5.Get();
+}
+
+// Skipping the chroma must not change the decoded luma.
+TEST(DecodeAPI, Vp9LumaOnly) {
+  std::string expected_md5;
+  ASSERT_NO_FATAL_FAILURE(DecodeLuma(1, 0, 0, &expected_md5));
+  for (int threads = 1; threads <= 4; threads += 3) {
+    for (int row_mt = 0; row_mt <= 1; ++row_mt) {
+      std::string md5;
+      DecodeLuma(threads, row_mt, 1, &md5);
+      EXPECT_EQ(expected_md5, md5)
+          << "threads = " << threads << ", row_mt = " << row_mt;
+    }
+  }
+}
+
+#if CONFIG_VP9_POSTPROC
+void DecodeWithPostProc(int threads, int row_mt, int pp_flags,
+                        std::string *md5_out) {
+  const vpx_codec_iface_t *const codec = &vpx_codec_vp9_dx_algo;
+  libvpx_test::IVFVideoSource video("vp90-2-05-resize.ivf");
+  video.Init();
+  ASSERT_NO_FATAL_FAILURE(video.Begin());
+
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  cfg.threads = threads;
+  vpx_codec_ctx_t dec;
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(&dec, codec, &cfg, VPX_CODEC_USE_POSTPROC));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_SET_ROW_MT, row_mt));
+  vp8_postproc_cfg_t pp_cfg = { pp_flags, 3, 0 };
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP8_SET_POSTPROC, &pp_cfg));
+
+  libvpx_test::MD5 md5;
+  for (; video.cxdata() != NULL; video.Next()) {
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec, video.cxdata(),
+                               static_cast<unsigned int>(video.frame_size()),
+                               NULL, 0));
+    vpx_codec_iter_t iter = NULL;
+    const vpx_image_t *img;
+    while ((img = vpx_codec_get_frame(&dec, &iter)) != NULL) md5.Add(img);
+  }
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+  *md5_out = md5.Get();
+}
+
+// Postprocessing split between the tile workers must match the serial output.
+TEST(DecodeAPI, Vp9PostProcThreads) {
+  static const int kPostProcFlags[] = { VP8_DEBLOCK, VP8_DEMACROBLOCK,
+                                        VP8_MFQE | VP8_DEMACROBLOCK };
+  for (int i = 0; i < NELEMENTS(kPostProcFlags); ++i) {
+    std::string expected_md5;
+    ASSERT_NO_FATAL_FAILURE(
+        DecodeWithPostProc(1, 0, kPostProcFlags[i], &expected_md5));
+    for (int threads = 2; threads <= 4; threads += 2) {
+      for (int row_mt = 0; row_mt <= 1; ++row_mt) {
+        std::string md5;
+        ASSERT_NO_FATAL_FAILURE(
+            DecodeWithPostProc(threads, row_mt, kPostProcFlags[i], &md5));
+        EXPECT_EQ(expected_md5, md5)
+            << "flags = " << kPostProcFlags[i] << ", threads = " << threads
+            << ", row_mt = " << row_mt;
+      }
+    }
+  }
+}
+#endif  // CONFIG_VP9_POSTPROC
+
+void DecodeWithPerfStats(int threads, int row_mt, int enable) {
+  const vpx_codec_iface_t *const codec = &vpx_codec_vp9_dx_algo;
+  libvpx_test::IVFVideoSource video("vp90-2-05-resize.ivf");
+  video.Init();
+  ASSERT_NO_FATAL_FAILURE(video.Begin());
+
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  cfg.threads = threads;
+  vpx_codec_ctx_t dec;
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&dec, codec, &cfg, 0));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_SET_ROW_MT, row_mt));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_SET_PERF_STATS, enable));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_control(&dec, VP9D_GET_PERF_STATS, NULL));
+
+  for (; video.cxdata() != NULL; video.Next()) {
+    const unsigned int frame_size =
+        static_cast<unsigned int>(video.frame_size());
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec, video.cxdata(), frame_size, NULL, 0));
+    vpx_decoder_perf_stats stats;
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&dec, VP9D_GET_PERF_STATS, &stats));
+
+    uint64_t tile_bytes = 0;
+    for (int row = 0; row < stats.tile_rows; ++row) {
+      for (int col = 0; col < stats.tile_cols; ++col)
+        tile_bytes += stats.tile_bytes[row][col];
+    }
+    const int64_t times[] = { stats.header_us,     stats.mode_info_us,
+                              stats.detokenize_us, stats.inverse_transform_us,
+                              stats.prediction_us, stats.loop_filter_us,
+                              stats.adapt_us,      stats.thread_idle_us };
+    for (int i = 0; i < NELEMENTS(times); ++i) {
+      if (enable)
+        EXPECT_GE(times[i], 0);
+      else
+        EXPECT_EQ(0, times[i]);
+    }
+    if (enable) {
+      EXPECT_GE(stats.tile_rows, 1);
+      EXPECT_GE(stats.tile_cols, 1);
+      EXPECT_GT(tile_bytes, 0u);
+      EXPECT_LT(tile_bytes, frame_size);
+    } else {
+      EXPECT_EQ(0u, tile_bytes);
+    }
+  }
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+}
+
+TEST(DecodeAPI, Vp9PerfStats) {
+  for (int threads = 1; threads <= 4; threads += 3) {
+    for (int row_mt = 0; row_mt <= 1; ++row_mt) {
+      ASSERT_NO_FATAL_FAILURE(DecodeWithPerfStats(threads, row_mt, 0));
+      DecodeWithPerfStats(threads, row_mt, 1);
+    }
+  }
+}
+
+void DecodeWithMemoryUsage(int threads, int row_mt, int frame_parallel) {
+  const vpx_codec_iface_t *const codec = &vpx_codec_vp9_dx_algo;
+  libvpx_test::IVFVideoSource video("vp90-2-05-resize.ivf");
+  video.Init();
+  ASSERT_NO_FATAL_FAILURE(video.Begin());
+
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  cfg.threads = threads;
+  vpx_codec_ctx_t dec;
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(&dec, codec, &cfg,
+                               frame_parallel ? VPX_CODEC_USE_FRAME_THREADING
+                                              : 0));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_SET_ROW_MT, row_mt));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_control(&dec, VP9D_GET_MEMORY_USAGE, NULL));
+
+  vpx_decoder_memory_usage usage;
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&dec, VP9D_GET_MEMORY_USAGE, &usage));
+  EXPECT_EQ(0u, usage.total);
+
+  size_t max_mi_rows = 0;
+  size_t max_mi_cols = 0;
+  for (; video.cxdata() != NULL; video.Next()) {
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec, video.cxdata(),
+                               static_cast<unsigned int>(video.frame_size()),
+                               NULL, 0));
+    vpx_codec_iter_t iter = NULL;
+    const vpx_image_t *img;
+    while ((img = vpx_codec_get_frame(&dec, &iter)) != NULL) {
+      max_mi_rows = std::max(max_mi_rows, size_t((img->d_h + 7) >> 3));
+      max_mi_cols = std::max(max_mi_cols, size_t((img->d_w + 7) >> 3));
+    }
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&dec, VP9D_GET_MEMORY_USAGE, &usage));
+    EXPECT_EQ(usage.frame_buffers + usage.mode_info + usage.motion_vectors +
+                  usage.loop_filter + usage.row_mt + usage.other,
+              usage.total);
+    if (!row_mt) EXPECT_EQ(0u, usage.row_mt);
+    // Frame parallel decode may not have started decoding yet.
+    if (max_mi_rows == 0) continue;
+    EXPECT_GT(usage.frame_buffers, 0u);
+    EXPECT_GT(usage.mode_info, 0u);
+    EXPECT_GT(usage.motion_vectors, 0u);
+    EXPECT_GT(usage.loop_filter, 0u);
+    EXPECT_GT(usage.other, 0u);
+    // Serial decode keeps the motion vectors of two frames at most.
+    if (!frame_parallel) {
+      EXPECT_LE(usage.motion_vectors,
+                2 * max_mi_rows * max_mi_cols * sizeof(MV_REF));
+    }
+  }
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+}
+
+TEST(DecodeAPI, Vp9MemoryUsage) {
+  for (int threads = 1; threads <= 4; threads += 3) {
+    for (int row_mt = 0; row_mt <= 1; ++row_mt)
+      DecodeWithMemoryUsage(threads, row_mt, 0);
+  }
+  DecodeWithMemoryUsage(4, 0, 1);
+}
+
+// Appends the md5 and user_priv of the frames output by dec.
+void GetFrames(vpx_codec_ctx_t *dec, std::vector<std::string> *md5s,
+               std::vector<void *> *user_privs) {
+  vpx_codec_iter_t iter = NULL;
+  const vpx_image_t *img;
+  while ((img = vpx_codec_get_frame(dec, &iter)) != NULL) {
+    libvpx_test::MD5 md5;
+    md5.Add(img);
+    md5s->push_back(md5.Get());
+    user_privs->push_back(img->user_priv);
+  }
+}
+
+// Decodes vp90-2-05-resize.ivf with VP9D_DECODE_FRAMES in batches of up to
+// batch_size frames, or one frame per vpx_codec_decode() call if 0.
+void DecodeBatches(int threads, vpx_codec_flags_t flags, int batch_size,
+                   std::vector<std::string> *md5s,
+                   std::vector<void *> *user_privs) {
+  const vpx_codec_iface_t *const codec = &vpx_codec_vp9_dx_algo;
+  libvpx_test::IVFVideoSource video("vp90-2-05-resize.ivf");
+  video.Init();
+  ASSERT_NO_FATAL_FAILURE(video.Begin());
+
+  std::vector<std::vector<uint8_t> > data;
+  for (; video.cxdata() != NULL; video.Next()) {
+    data.push_back(std::vector<uint8_t>(video.cxdata(),
+                                        video.cxdata() + video.frame_size()));
+  }
+  std::vector<vpx_coded_frame> frames(data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    frames[i].data = &data[i][0];
+    frames[i].data_sz = static_cast<unsigned int>(data[i].size());
+    frames[i].user_priv = &data[i];
+  }
+
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  cfg.threads = threads;
+  vpx_codec_ctx_t dec;
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&dec, codec, &cfg, flags));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_control(&dec, VP9D_DECODE_FRAMES, NULL));
+
+  const int num_frames = static_cast<int>(frames.size());
+  for (int i = 0; i < num_frames;) {
+    if (batch_size == 0) {
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_decode(&dec, frames[i].data, frames[i].data_sz,
+                                 frames[i].user_priv, 0));
+      ++i;
+    } else {
+      vpx_decode_batch batch;
+      batch.frames = &frames[i];
+      batch.num_frames = std::min(batch_size, num_frames - i);
+      batch.num_decoded = -1;
+      ASSERT_EQ(VPX_CODEC_OK,
+                vpx_codec_control(&dec, VP9D_DECODE_FRAMES, &batch));
+      // The queue holds at least a few frames.
+      ASSERT_GE(batch.num_decoded, std::min(batch.num_frames, 4));
+      i += batch.num_decoded;
+    }
+    GetFrames(&dec, md5s, user_privs);
+  }
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_decode(&dec, NULL, 0, NULL, 0));
+  GetFrames(&dec, md5s, user_privs);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+}
+
+TEST(DecodeAPI, Vp9DecodeBatches) {
+  std::vector<std::string> expected_md5s;
+  std::vector<void *> expected_user_privs;
+  ASSERT_NO_FATAL_FAILURE(
+      DecodeBatches(1, 0, 0, &expected_md5s, &expected_user_privs));
+  const int kBatchSizes[] = { 1, 3, 1000 };
+  for (int i = 0; i < 3; ++i) {
+    for (int frame_parallel = 0; frame_parallel <= 1; ++frame_parallel) {
+      std::vector<std::string> md5s;
+      std::vector<void *> user_privs;
+      ASSERT_NO_FATAL_FAILURE(DecodeBatches(
+          frame_parallel ? 4 : 1,
+          frame_parallel ? VPX_CODEC_USE_FRAME_THREADING : 0, kBatchSizes[i],
+          &md5s, &user_privs));
+      EXPECT_TRUE(expected_md5s == md5s)
+          << "batch size = " << kBatchSizes[i]
+          << ", frame parallel = " << frame_parallel;
+      EXPECT_TRUE(expected_user_privs == user_privs);
+    }
+  }
+}
+#endif  // CONFIG_VP9_DECODER
+
+typedef std::pair<unsigned int, unsigned int> FrameSize;
+
+// Appends the md5 of the frames output for the key frames of 'filename', and
+// their sizes.
+void DecodeKeyFrames(const vpx_codec_iface_t *codec, const char *filename,
+                     int keyframe_only, int downscale,
+                     std::vector<std::string> *md5s,
+                     std::vector<FrameSize> *sizes) {
+  libvpx_test::IVFVideoSource video(filename);
+  video.Init();
+  ASSERT_NO_FATAL_FAILURE(video.Begin());
+
+  vpx_codec_ctx_t dec;
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&dec, codec, NULL, 0));
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&dec, VPXD_SET_KEYFRAME_ONLY, keyframe_only));
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&dec, VPXD_SET_OUTPUT_DOWNSCALE, downscale));
+
+  for (; video.cxdata() != NULL; video.Next()) {
+    const unsigned int frame_size =
+        static_cast<unsigned int>(video.frame_size());
+    vpx_codec_stream_info_t si = vpx_codec_stream_info_t();
+    si.sz = sizeof(si);
+    vpx_codec_peek_stream_info(codec, video.cxdata(), frame_size, &si);
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec, video.cxdata(), frame_size, NULL, 0));
+    vpx_codec_iter_t iter = NULL;
+    const vpx_image_t *img;
+    while ((img = vpx_codec_get_frame(&dec, &iter)) != NULL) {
+      if (!si.is_kf) {
+        EXPECT_EQ(0, keyframe_only) << "Output for a dropped frame";
+        continue;
+      }
+      libvpx_test::MD5 md5;
+      md5.Add(img);
+      md5s->push_back(md5.Get());
+      sizes->push_back(FrameSize(img->d_w, img->d_h));
+    }
+  }
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+}
+
+void TestKeyFrameOnly(const vpx_codec_iface_t *codec, const char *filename) {
+  std::vector<std::string> expected_md5s;
+  std::vector<FrameSize> expected_sizes;
+  ASSERT_NO_FATAL_FAILURE(DecodeKeyFrames(codec, filename, 0, 1,
+                                          &expected_md5s, &expected_sizes));
+  ASSERT_FALSE(expected_md5s.empty());
+
+  std::vector<std::string> md5s;
+  std::vector<FrameSize> sizes;
+  DecodeKeyFrames(codec, filename, 1, 1, &md5s, &sizes);
+  EXPECT_EQ(expected_md5s, md5s);
+  EXPECT_EQ(expected_sizes, sizes);
+
+  for (int downscale = 2; downscale <= 8; downscale *= 2) {
+    md5s.clear();
+    sizes.clear();
+    DecodeKeyFrames(codec, filename, 1, downscale, &md5s, &sizes);
+    ASSERT_EQ(expected_sizes.size(), sizes.size());
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      EXPECT_EQ((expected_sizes[i].first + downscale - 1) / downscale,
+                sizes[i].first);
+      EXPECT_EQ((expected_sizes[i].second + downscale - 1) / downscale,
+                sizes[i].second);
+    }
+  }
+}
+
+#if CONFIG_VP8_DECODER
+TEST(DecodeAPI, Vp8KeyFrameOnly) {
+  TestKeyFrameOnly(&vpx_codec_vp8_dx_algo, "vp80-00-comprehensive-001.ivf");
+}
+#endif  // CONFIG_VP8_DECODER
+
+#if CONFIG_VP9_DECODER
+TEST(DecodeAPI, Vp9KeyFrameOnly) {
+  TestKeyFrameOnly(&vpx_codec_vp9_dx_algo, "vp90-2-05-resize.ivf");
+}
+#endif  // CONFIG_VP9_DECODER
+
+#if CONFIG_VP8_DECODER && CONFIG_VP9_DECODER
+// Decodes a stream a frame at a time, so that several decoders can be stepped
+// in turn, and accumulates the md5 of the frames output.
+class StreamDecoder {
+ public:
+  StreamDecoder(const vpx_codec_iface_t *codec, const char *filename)
+      : codec_(codec), video_(filename), initialized_(false) {}
+
+  ~StreamDecoder() {
+    if (initialized_) {
+      EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec_));
+    }
+  }
+
+  void Init(int threads, int row_mt, vpx_thread_pool_t *pool,
+            vpx_codec_flags_t flags = 0) {
+    video_.Init();
+    ASSERT_NO_FATAL_FAILURE(video_.Begin());
+
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = threads;
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&dec_, codec_, &cfg, flags));
+    initialized_ = true;
+    if (codec_ == &vpx_codec_vp9_dx_algo) {
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_control(&dec_, VP9D_SET_ROW_MT, row_mt));
+    }
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&dec_, VPXD_SET_THREAD_POOL, pool));
+  }
+
+  // Returns false once the whole stream has been decoded.
+  bool DecodeFrame() {
+    if (video_.cxdata() == NULL) return false;
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec_, video_.cxdata(),
+                               static_cast<unsigned int>(video_.frame_size()),
+                               NULL, 0));
+    vpx_codec_iter_t iter = NULL;
+    const vpx_image_t *img;
+    while ((img = vpx_codec_get_frame(&dec_, &iter)) != NULL) md5_.Add(img);
+    video_.Next();
+    return true;
+  }
+
+  vpx_codec_ctx_t *dec() { return &dec_; }
+  std::string md5() { return md5_.Get(); }
+
+ private:
+  const vpx_codec_iface_t *codec_;
+  libvpx_test::IVFVideoSource video_;
+  vpx_codec_ctx_t dec_;
+  bool initialized_;
+  libvpx_test::MD5 md5_;
+};
+
+const struct {
+  const vpx_codec_iface_t *codec;
+  const char *filename;
+  int threads;
+  int row_mt;
+} kPoolStreams[] = {
+  { &vpx_codec_vp8_dx_algo, "vp80-00-comprehensive-001.ivf", 4, 0 },
+  { &vpx_codec_vp9_dx_algo, "vp90-2-05-resize.ivf", 4, 0 },
+  { &vpx_codec_vp9_dx_algo, "vp90-2-05-resize.ivf", 4, 1 },
+  { &vpx_codec_vp9_dx_algo, "vp90-2-05-resize.ivf", 2, 1 },
+};
+
+// Decodes each of kPoolStreams on its own, with a single thread.
+void DecodePoolStreams(std::vector<std::string> *md5s) {
+  for (int i = 0; i < NELEMENTS(kPoolStreams); ++i) {
+    StreamDecoder decoder(kPoolStreams[i].codec, kPoolStreams[i].filename);
+    ASSERT_NO_FATAL_FAILURE(decoder.Init(1, 0, NULL));
+    while (decoder.DecodeFrame()) {
+    }
+    md5s->push_back(decoder.md5());
+  }
+}
+
+TEST(DecodeAPI, SharedThreadPool) {
+  vpx_thread_pool_t *const pool = vpx_thread_pool_create(2);
+  if (pool == NULL) return;  // Built without thread support.
+
+  std::vector<std::string> expected_md5s;
+  DecodePoolStreams(&expected_md5s);
+  if (HasFatalFailure()) {
+    vpx_thread_pool_destroy(pool);
+    return;
+  }
+
+  {
+    std::vector<StreamDecoder *> decoders;
+    for (int i = 0; i < NELEMENTS(kPoolStreams); ++i) {
+      decoders.push_back(
+          new StreamDecoder(kPoolStreams[i].codec, kPoolStreams[i].filename));
+      decoders.back()->Init(kPoolStreams[i].threads, kPoolStreams[i].row_mt,
+                            pool);
+    }
+    // Interleave the decoders so that they all share the pool.
+    bool decoding = true;
+    while (decoding) {
+      decoding = false;
+      for (size_t i = 0; i < decoders.size(); ++i) {
+        if (decoders[i]->DecodeFrame()) decoding = true;
+      }
+    }
+    for (size_t i = 0; i < decoders.size(); ++i) {
+      EXPECT_EQ(expected_md5s[i], decoders[i]->md5()) << "stream " << i;
+      // The pool can only be changed before the first frame.
+      EXPECT_EQ(VPX_CODEC_ERROR,
+                vpx_codec_control(decoders[i]->dec(), VPXD_SET_THREAD_POOL,
+                                  static_cast<vpx_thread_pool_t *>(NULL)));
+      delete decoders[i];
+    }
+  }
+  vpx_thread_pool_destroy(pool);
+}
+
+#if CONFIG_MULTITHREAD
+static THREADFN DecodeStreamThread(void *arg) {
+  StreamDecoder *const decoder = static_cast<StreamDecoder *>(arg);
+  while (decoder->DecodeFrame()) {
+  }
+  return THREAD_RETURN(NULL);
+}
+
+// Same as SharedThreadPool, with each decoder driven by a thread of its own
+// so that they queue work on the pool at the same time.
+TEST(DecodeAPI, SharedThreadPoolConcurrent) {
+  vpx_thread_pool_t *const pool = vpx_thread_pool_create(2);
+  ASSERT_TRUE(pool != NULL);
+
+  std::vector<std::string> expected_md5s;
+  DecodePoolStreams(&expected_md5s);
+  if (HasFatalFailure()) {
+    vpx_thread_pool_destroy(pool);
+    return;
+  }
+
+  {
+    std::vector<StreamDecoder *> decoders;
+    std::vector<pthread_t> threads(NELEMENTS(kPoolStreams));
+    std::vector<bool> started(NELEMENTS(kPoolStreams));
+    for (int i = 0; i < NELEMENTS(kPoolStreams); ++i) {
+      decoders.push_back(
+          new StreamDecoder(kPoolStreams[i].codec, kPoolStreams[i].filename));
+      decoders.back()->Init(kPoolStreams[i].threads, kPoolStreams[i].row_mt,
+                            pool);
+    }
+    for (size_t i = 0; i < decoders.size(); ++i) {
+      started[i] = pthread_create(&threads[i], NULL, DecodeStreamThread,
+                                  decoders[i]) == 0;
+      EXPECT_TRUE(started[i]) << "stream " << i;
+    }
+    for (size_t i = 0; i < decoders.size(); ++i) {
+      if (started[i]) EXPECT_EQ(0, pthread_join(threads[i], NULL));
+      EXPECT_EQ(expected_md5s[i], decoders[i]->md5()) << "stream " << i;
+      delete decoders[i];
+    }
+  }
+  vpx_thread_pool_destroy(pool);
+}
+
+// The VP8 decoder uses more threads than token partitions, and more than 8,
+// when the pool has them, whatever the number of cores.
+TEST(DecodeAPI, Vp8ThreadsAboveTokenPartitions) {
+  const char kFilename[] = "vp80-00-comprehensive-001.ivf";
+  vpx_thread_pool_t *const pool = vpx_thread_pool_create(11);
+  ASSERT_TRUE(pool != NULL);
+
+  std::string expected_md5;
+  {
+    StreamDecoder decoder(&vpx_codec_vp8_dx_algo, kFilename);
+    decoder.Init(1, 0, NULL);
+    while (decoder.DecodeFrame()) {
+    }
+    expected_md5 = decoder.md5();
+  }
+  for (int threads = 2; threads <= 12; threads += 5) {
+    StreamDecoder decoder(&vpx_codec_vp8_dx_algo, kFilename);
+    decoder.Init(threads, 0, pool);
+    while (decoder.DecodeFrame()) {
+    }
+    EXPECT_EQ(expected_md5, decoder.md5()) << "threads = " << threads;
+  }
+  vpx_thread_pool_destroy(pool);
+}
+
+#if CONFIG_POSTPROC
+// The VP8 postprocessing runs in bands on the decoding threads and must match
+// the serial output.
+TEST(DecodeAPI, Vp8PostProcThreads) {
+  const char kFilename[] = "vp80-00-comprehensive-001.ivf";
+  static const int kPostProcFlags[] = { VP8_DEBLOCK, VP8_DEMACROBLOCK,
+                                        VP8_DEBLOCK | VP8_DEMACROBLOCK };
+  vpx_thread_pool_t *const pool = vpx_thread_pool_create(4);
+  ASSERT_TRUE(pool != NULL);
+
+  for (int i = 0; i < NELEMENTS(kPostProcFlags); ++i) {
+    vp8_postproc_cfg_t pp_cfg = { kPostProcFlags[i], 6, 0 };
+    std::string expected_md5;
+    {
+      StreamDecoder decoder(&vpx_codec_vp8_dx_algo, kFilename);
+      decoder.Init(1, 0, NULL, VPX_CODEC_USE_POSTPROC);
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_control(decoder.dec(), VP8_SET_POSTPROC, &pp_cfg));
+      while (decoder.DecodeFrame()) {
+      }
+      expected_md5 = decoder.md5();
+    }
+    for (int threads = 2; threads <= 5; threads += 3) {
+      StreamDecoder decoder(&vpx_codec_vp8_dx_algo, kFilename);
+      decoder.Init(threads, 0, pool, VPX_CODEC_USE_POSTPROC);
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_control(decoder.dec(), VP8_SET_POSTPROC, &pp_cfg));
+      while (decoder.DecodeFrame()) {
+      }
+      EXPECT_EQ(expected_md5, decoder.md5())
+          << "flags = " << kPostProcFlags[i] << ", threads = " << threads;
+    }
+  }
+  vpx_thread_pool_destroy(pool);
+}
+#endif  // CONFIG_POSTPROC
+#endif  // CONFIG_MULTITHREAD
+#endif  // CONFIG_VP8_DECODER && CONFIG_VP9_DECODER
+
+// Adds the rows [row_start, row_end) of all the planes of 'img' to 'md5'.
+static void AddRows(const vpx_image_t *img, unsigned int row_start,
+                    unsigned int row_end, libvpx_test::MD5 *md5) {
+  const int bytes_per_sample = (img->fmt & VPX_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+  for (int plane = 0; plane < 3; ++plane) {
+    if (img->planes[plane] == NULL) continue;
+    const int shift = plane ? img->y_chroma_shift : 0;
+    const size_t width =
+        ((img->d_w + (plane ? img->x_chroma_shift : 0)) >>
+         (plane ? img->x_chroma_shift : 0)) *
+        bytes_per_sample;
+    for (unsigned int row = row_start >> shift;
+         row < (row_end + shift) >> shift; ++row) {
+      md5->Add(img->planes[plane] + row * img->stride[plane], width);
+    }
+  }
+}
+
+// Rows reported for the last frame decoded, along with the md5 of their
+// content at the time.
+struct RowsDecoded {
+  const uint8_t *frame;
+  int frames;  // Number of frames reported so far.
+  void *user_priv;
+  std::vector<FrameSize> ranges;
+  libvpx_test::MD5 md5;
+};
+
+static void RowsDecodedCallback(void *rows_decoded_state,
+                                const vpx_image_t *img, unsigned int row_start,
+                                unsigned int row_end) {
+  RowsDecoded *const rows = static_cast<RowsDecoded *>(rows_decoded_state);
+  if (row_start == 0) {
+    rows->frame = img->planes[0];
+    ++rows->frames;
+    rows->ranges.clear();
+    rows->md5 = libvpx_test::MD5();
+  }
+  EXPECT_EQ(rows->frame, img->planes[0]);
+  EXPECT_EQ(rows->user_priv, img->user_priv);
+  EXPECT_EQ(rows->ranges.empty() ? 0u : rows->ranges.back().second, row_start);
+  EXPECT_LT(row_start, row_end);
+  EXPECT_LE(row_end, img->d_h);
+  rows->ranges.push_back(FrameSize(row_start, row_end));
+  AddRows(img, row_start, row_end, &rows->md5);
+}
+
+// Checks that the rows of every frame output were reported before the frame
+// was, and did not change afterwards. The test streams show no frame twice,
+// so each frame output must be the last one reported by the same call to
+// vpx_codec_decode().
+static void TestRowsDecoded(const vpx_codec_iface_t *codec,
+                            const char *filename, int threads, int row_mt) {
+  libvpx_test::IVFVideoSource video(filename);
+  video.Init();
+  ASSERT_NO_FATAL_FAILURE(video.Begin());
+
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  cfg.threads = threads;
+  vpx_codec_ctx_t dec;
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&dec, codec, &cfg, 0));
+  if (codec == &vpx_codec_vp9_dx_algo) {
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_SET_ROW_MT, row_mt));
+  }
+  RowsDecoded rows;
+  rows.frame = NULL;
+  rows.frames = 0;
+  vpx_rows_decoded_init init = { RowsDecodedCallback, &rows };
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&dec, VPXD_SET_ROWS_DECODED_CB, &init));
+
+  int frames = 0;
+  for (; video.cxdata() != NULL; video.Next()) {
+    const int frames_reported = rows.frames;
+    rows.user_priv = &video;
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec, video.cxdata(),
+                               static_cast<unsigned int>(video.frame_size()),
+                               &video, 0));
+    vpx_codec_iter_t iter = NULL;
+    const vpx_image_t *img;
+    while ((img = vpx_codec_get_frame(&dec, &iter)) != NULL) {
+      ASSERT_GT(rows.frames, frames_reported) << "frame " << frames;
+      ASSERT_EQ(rows.frame, img->planes[0]) << "frame " << frames;
+      ASSERT_FALSE(rows.ranges.empty());
+      EXPECT_EQ(img->d_h, rows.ranges.back().second) << "frame " << frames;
+      libvpx_test::MD5 md5;
+      for (size_t i = 0; i < rows.ranges.size(); ++i)
+        AddRows(img, rows.ranges[i].first, rows.ranges[i].second, &md5);
+      EXPECT_STREQ(md5.Get(), rows.md5.Get()) << "frame " << frames;
+      ++frames;
+    }
+  }
+  EXPECT_GT(frames, 0);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+}
+
+#if CONFIG_VP8_DECODER
+TEST(DecodeAPI, Vp8RowsDecoded) {
+  for (int threads = 1; threads <= 4; threads += 3) {
+    TestRowsDecoded(&vpx_codec_vp8_dx_algo, "vp80-00-comprehensive-001.ivf",
+                    threads, 0);
+  }
+}
+#endif  // CONFIG_VP8_DECODER
+
+#if CONFIG_VP9_DECODER
+TEST(DecodeAPI, Vp9RowsDecoded) {
+  for (int threads = 1; threads <= 4; threads += 3) {
+    for (int row_mt = 0; row_mt <= 1; ++row_mt) {
+      SCOPED_TRACE(threads);
+      SCOPED_TRACE(row_mt);
+      TestRowsDecoded(&vpx_codec_vp9_dx_algo, "vp90-2-05-resize.ivf", threads,
+                      row_mt);
+    }
+  }
+}
 #endif  // CONFIG_VP9_DECODER
 
 TEST(DecodeAPI, HighBitDepthCapability) {
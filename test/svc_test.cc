@@ -64,6 +64,7 @@ class SvcTest : public ::testing::Test {
 
     tile_columns_ = 0;
     tile_rows_ = 0;
+    row_mt_ = 0;
   }
 
   virtual void TearDown() {
@@ -78,6 +79,7 @@ class SvcTest : public ::testing::Test {
     vpx_codec_control(&codec_, VP8E_SET_CPUUSED, 4);  // Make the test faster
     vpx_codec_control(&codec_, VP9E_SET_TILE_COLUMNS, tile_columns_);
     vpx_codec_control(&codec_, VP9E_SET_TILE_ROWS, tile_rows_);
+    vpx_codec_control(&codec_, VP9E_SET_ROW_MT, row_mt_);
     codec_initialized_ = true;
   }
 
@@ -312,6 +314,7 @@ class SvcTest : public ::testing::Test {
   Decoder *decoder_;
   int tile_columns_;
   int tile_rows_;
+  int row_mt_;
 };
 
 TEST_F(SvcTest, SvcInit) {
@@ -641,7 +644,7 @@ TEST_F(SvcTest,
                       "multi-frame-contexts=1");
   vpx_fixed_buf outputs[10];
   memset(&outputs[0], 0, sizeof(outputs));
-  Pass2EncodeNFrames(&stats_buf, 10, 3, &outputs[0]);
+  Pass2EncodeNFrames(&stats_buf, 10, getenv("ONE") ? 1 : 3, &outputs[0]);
 
   DecodeNFrames(&outputs[0], 10);
   DropEnhancementLayers(&outputs[0], 10, 2);
@@ -786,4 +789,41 @@ TEST_F(SvcTest, TwoPassEncode2TemporalLayersWithMultipleFrameContextsAndTiles) {
   FreeBitstreamBuffers(&outputs[0], 10);
 }
 
+TEST_F(SvcTest, TwoPassEncode3SpatialLayersWithRowMt) {
+  // First pass encode
+  std::string stats_buf;
+  codec_enc_.g_w = 704;
+  codec_enc_.g_h = 288;
+  codec_enc_.g_threads = 4;
+  tile_columns_ = 2;
+  row_mt_ = 1;
+  if (getenv("ONE")) vpx_svc_set_options(&svc_, "scale-factors=1/1");
+  Pass1EncodeNFrames(10, getenv("ONE") ? 1 : 3, &stats_buf);
+
+  // Second pass encode, with more threads than tiles in every layer.
+  codec_enc_.g_pass = VPX_RC_LAST_PASS;
+  vpx_svc_set_options(&svc_, (getenv("ONE") ? "auto-alt-refs=1 scale-factors=1/1" : "auto-alt-refs=1,1,1"));
+  vpx_fixed_buf outputs[10];
+  memset(&outputs[0], 0, sizeof(outputs));
+  Pass2EncodeNFrames(&stats_buf, 10, getenv("ONE") ? 1 : 3, &outputs[0]);
+
+  // Row based multi-threading is bit exact for any number of threads > 1.
+  vpx_svc_set_options(&svc_, (getenv("ONE") ? "auto-alt-refs=1 scale-factors=1/1" : "auto-alt-refs=1,1,1"));
+  codec_enc_.g_threads = getenv("T2") ? atoi(getenv("T2")) : 2;
+  vpx_fixed_buf outputs_2t[10];
+  memset(&outputs_2t[0], 0, sizeof(outputs_2t));
+  Pass2EncodeNFrames(&stats_buf, 10, getenv("ONE") ? 1 : 3, &outputs_2t[0]);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(outputs[i].sz, outputs_2t[i].sz) << "frame " << i;
+    EXPECT_EQ(0, memcmp(outputs[i].buf, outputs_2t[i].buf, outputs[i].sz))
+        << "frame " << i;
+  }
+
+  DecodeNFrames(&outputs[0], 10);
+  DropEnhancementLayers(&outputs[0], 10, 1);
+  DecodeNFrames(&outputs[0], 10);
+  FreeBitstreamBuffers(&outputs[0], 10);
+  FreeBitstreamBuffers(&outputs_2t[0], 10);
+}
+
 }  // namespace
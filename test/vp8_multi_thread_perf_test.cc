@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2017 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include <ctime>
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "./vpx_config.h"
+#include "./vpx_version.h"
+#include "test/i420_video_source.h"
+#include "test/util.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vpx_encoder.h"
+#include "vpx_ports/vpx_timer.h"
+#include "vpx_util/vpx_thread.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const double kUsecsInSec = 1000000.0;
+const char kVideoName[] = "niklas_1280_720_30.yuv";
+const int kWidth = 1280;
+const int kHeight = 720;
+const int kFrames = 100;
+const int kBitrate = 600;
+// Number of encoder instances sharing the machine, each running as many
+// threads as there are cores.
+const int kInstances[] = { 1, 2 };
+
+#define NELEMENTS(x) static_cast<int>(sizeof(x) / sizeof(x[0]))
+
+int GetCpuCount() {
+#if defined(_WIN32)
+  SYSTEM_INFO sysinfo;
+  GetSystemInfo(&sysinfo);
+  return static_cast<int>(sysinfo.dwNumberOfProcessors);
+#elif defined(_SC_NPROCESSORS_ONLN)
+  const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  return cores > 0 ? static_cast<int>(cores) : 1;
+#else
+  return 1;
+#endif
+}
+
+struct EncodeJob {
+  int threads;
+  int frames;
+  vpx_codec_err_t res;
+};
+
+void *EncodeThread(void *arg) {
+  EncodeJob *const job = static_cast<EncodeJob *>(arg);
+  libvpx_test::I420VideoSource video(kVideoName, kWidth, kHeight, 30, 1, 0,
+                                     kFrames);
+  vpx_codec_iface_t *const iface = &vpx_codec_vp8_cx_algo;
+  vpx_codec_enc_cfg_t cfg;
+  vpx_codec_ctx_t enc;
+
+  job->frames = 0;
+  job->res = vpx_codec_enc_config_default(iface, &cfg, 0);
+  if (job->res != VPX_CODEC_OK) return NULL;
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_timebase.num = 1;
+  cfg.g_timebase.den = 30;
+  cfg.g_threads = job->threads;
+  cfg.g_lag_in_frames = 0;
+  cfg.rc_end_usage = VPX_CBR;
+  cfg.rc_target_bitrate = kBitrate;
+  job->res = vpx_codec_enc_init(&enc, iface, &cfg, 0);
+  if (job->res != VPX_CODEC_OK) return NULL;
+  vpx_codec_control(&enc, VP8E_SET_CPUUSED, -6);
+
+  for (video.Begin(); video.img() != NULL && job->res == VPX_CODEC_OK;
+       video.Next()) {
+    vpx_codec_iter_t iter = NULL;
+    job->res = vpx_codec_encode(&enc, video.img(), video.pts(),
+                                video.duration(), 0, VPX_DL_REALTIME);
+    while (vpx_codec_get_cx_data(&enc, &iter) != NULL) {
+    }
+    ++job->frames;
+  }
+  vpx_codec_destroy(&enc);
+  return NULL;
+}
+
+// Encodes the same clip with several VP8 encoders at once, each with one
+// thread per core, and reports the CPU time spent per frame. Rows of a frame
+// wait on the row above, so threads that busy-wait for a descheduled
+// neighbour show up as CPU time that grows with the oversubscription.
+TEST(VP8MultiThreadPerfTest, CpuTimePerFrame) {
+  const int threads = GetCpuCount();
+  for (int i = 0; i < NELEMENTS(kInstances); ++i) {
+    const int instances = kInstances[i];
+    std::vector<EncodeJob> jobs(instances);
+    std::vector<pthread_t> encoders(instances);
+    int frames = 0;
+
+    vpx_usec_timer t;
+    vpx_usec_timer_start(&t);
+    const std::clock_t start = std::clock();
+    for (int j = 0; j < instances; ++j) {
+      jobs[j].threads = threads;
+      ASSERT_EQ(0, pthread_create(&encoders[j], NULL, EncodeThread, &jobs[j]));
+    }
+    for (int j = 0; j < instances; ++j) {
+      ASSERT_EQ(0, pthread_join(encoders[j], NULL));
+      ASSERT_EQ(VPX_CODEC_OK, jobs[j].res);
+      frames += jobs[j].frames;
+    }
+    // std::clock() measures the CPU time of all threads of the process,
+    // except on Windows where it is wall time.
+    const double cpu_secs =
+        static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+    vpx_usec_timer_mark(&t);
+    const double elapsed_secs = vpx_usec_timer_elapsed(&t) / kUsecsInSec;
+    ASSERT_GT(frames, 0);
+
+    printf("{\n");
+    printf("\t\"type\" : \"vp8_multi_thread_perf_test\",\n");
+    printf("\t\"version\" : \"%s\",\n", VERSION_STRING_NOSP);
+    printf("\t\"videoName\" : \"%s\",\n", kVideoName);
+    printf("\t\"instances\" : %d,\n", instances);
+    printf("\t\"threads\" : %d,\n", threads);
+    printf("\t\"totalFrames\" : %d,\n", frames);
+    printf("\t\"encodeTimeSecs\" : %f,\n", elapsed_secs);
+    printf("\t\"cpuSecs\" : %f,\n", cpu_secs);
+    printf("\t\"cpuSecsPerFrame\" : %f\n", cpu_secs / frames);
+    printf("}\n");
+  }
+}
+}  // namespace
@@ -103,7 +103,7 @@ void DecodeFilesWithPause(const PauseFileList files[]) {
   }
 }
 
-TEST(DISABLED_VP9MultiThreadedFrameParallel, PauseSeekResume) {
+TEST(VP9MultiThreadedFrameParallel, PauseSeekResume) {
   // vp90-2-07-frame_parallel-1.webm is a 40 frame video file with
   // one key frame for every ten frames.
   static const PauseFileList files[] = {
@@ -143,13 +143,9 @@ string DecodeFile(const string &filename, int num_threads,
 
   int out_frames = 0;
   do {
-    const vpx_codec_err_t res =
-        decoder.DecodeFrame(video.cxdata(), video.frame_size());
-    // TODO(hkuang): frame parallel mode should return an error on corruption.
-    if (res != VPX_CODEC_OK) {
-      EXPECT_EQ(VPX_CODEC_OK, res) << decoder.DecodeError();
-      break;
-    }
+    // A corrupted frame is reported by a later call to decode, once its
+    // worker has finished. Keep decoding so the frames after it are output.
+    decoder.DecodeFrame(video.cxdata(), video.frame_size());
 
     video.Next();
 
@@ -183,7 +179,7 @@ void DecodeFiles(const FileList files[]) {
   }
 }
 
-TEST(DISABLED_VP9MultiThreadedFrameParallel, InvalidFileTest) {
+TEST(VP9MultiThreadedFrameParallel, InvalidFileTest) {
   static const FileList files[] = {
     // invalid-vp90-2-07-frame_parallel-1.webm is a 40 frame video file with
     // one key frame for every ten frames. The 11th frame has corrupted data.
@@ -204,7 +200,7 @@ TEST(DISABLED_VP9MultiThreadedFrameParallel, InvalidFileTest) {
   DecodeFiles(files);
 }
 
-TEST(DISABLED_VP9MultiThreadedFrameParallel, ValidFileTest) {
+TEST(VP9MultiThreadedFrameParallel, ValidFileTest) {
   static const FileList files[] = {
 #if CONFIG_VP9_HIGHBITDEPTH
     { "vp92-2-20-10bit-yuv420.webm", "a16b99df180c584e8db2ffeda987d293", 10 },
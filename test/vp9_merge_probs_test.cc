@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "vpx/vpx_integer.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+const int kNumIterations = 1000;
+const int kMaxProbs = 108;
+
+typedef void (*MergeProbsFunc)(const uint8_t *pre_probs,
+                               const unsigned int *counts, int n,
+                               unsigned int count_sat,
+                               unsigned int max_update_factor,
+                               uint8_t *probs);
+
+typedef std::tr1::tuple<MergeProbsFunc, MergeProbsFunc> MergeProbsParam;
+
+// { count_sat, max_update_factor } pairs used by the VP9 adaptation code.
+const unsigned int kUpdateParams[][2] = { { 24, 112 },
+                                          { 24, 128 },
+                                          { 20, 128 } };
+
+unsigned int rnd32(ACMRandom *rnd) {
+  return (static_cast<unsigned int>(rnd->Rand16()) << 16) | rnd->Rand16();
+}
+
+class MergeProbsTest : public ::testing::TestWithParam<MergeProbsParam> {
+ public:
+  virtual ~MergeProbsTest() {}
+  virtual void SetUp() {
+    merge_probs_ = GET_PARAM(0);
+    ref_merge_probs_ = GET_PARAM(1);
+  }
+
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  MergeProbsFunc merge_probs_;
+  MergeProbsFunc ref_merge_probs_;
+};
+
+TEST_P(MergeProbsTest, OperationCheck) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  uint8_t pre_probs[kMaxProbs];
+  unsigned int counts[kMaxProbs * 2];
+  uint8_t probs[kMaxProbs];
+  uint8_t ref_probs[kMaxProbs];
+  int err_count_total = 0;
+  int first_failure = -1;
+  for (int i = 0; i < kNumIterations; ++i) {
+    const unsigned int *const params = kUpdateParams[i % 3];
+    const int n = 1 + rnd(kMaxProbs);
+    // Cycle through small, medium and frame-sized counts.
+    const int count_bits = (i / 3) % 4 == 0 ? 2 : 6 * ((i / 3) % 4);
+    const unsigned int mask = (1u << count_bits) - 1;
+    for (int j = 0; j < n; ++j) {
+      pre_probs[j] = 1 + rnd(255);
+      counts[2 * j] = rnd32(&rnd) & mask;
+      counts[2 * j + 1] = rnd32(&rnd) & mask;
+      // Exercise empty and one-sided branches.
+      if (rnd(8) == 0) counts[2 * j] = 0;
+      if (rnd(8) == 0) counts[2 * j + 1] = 0;
+    }
+    memset(probs, 0, sizeof(probs));
+    memset(ref_probs, 0, sizeof(ref_probs));
+    ref_merge_probs_(pre_probs, counts, n, params[0], params[1], ref_probs);
+    ASM_REGISTER_STATE_CHECK(
+        merge_probs_(pre_probs, counts, n, params[0], params[1], probs));
+    const int err_count = memcmp(probs, ref_probs, sizeof(probs)) != 0;
+    if (err_count && !err_count_total) first_failure = i;
+    err_count_total += err_count;
+  }
+  EXPECT_EQ(0, err_count_total)
+      << "Error: Merge Probs Test, C output doesn't match optimized output. "
+      << "First failed at test case " << first_failure;
+}
+
+TEST_P(MergeProbsTest, ExtremeValues) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  // Branch counts never sum past 32 bits.
+  const unsigned int kExtremes[] = { 0u, 1u, 0x7fffffffu, 0x80000000u };
+  uint8_t pre_probs[kMaxProbs];
+  unsigned int counts[kMaxProbs * 2];
+  uint8_t probs[kMaxProbs];
+  uint8_t ref_probs[kMaxProbs];
+  for (int i = 0; i < kNumIterations; ++i) {
+    const unsigned int *const params = kUpdateParams[i % 3];
+    for (int j = 0; j < kMaxProbs; ++j) {
+      pre_probs[j] = rnd(2) ? 1 : 255;
+      counts[2 * j] = kExtremes[rnd(4)];
+      counts[2 * j + 1] = kExtremes[rnd(4)];
+    }
+    ref_merge_probs_(pre_probs, counts, kMaxProbs, params[0], params[1],
+                     ref_probs);
+    ASM_REGISTER_STATE_CHECK(merge_probs_(pre_probs, counts, kMaxProbs,
+                                          params[0], params[1], probs));
+    ASSERT_EQ(0, memcmp(probs, ref_probs, sizeof(probs)))
+        << "Error: Merge Probs Test, C output doesn't match optimized output "
+        << "at test case " << i;
+  }
+}
+
+using std::tr1::make_tuple;
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(SSE2, MergeProbsTest,
+                        ::testing::Values(make_tuple(&vp9_merge_probs_sse2,
+                                                     &vp9_merge_probs_c)));
+#endif  // HAVE_SSE2
+}  // namespace
@@ -154,14 +154,16 @@ struct FileList {
   const char *expected_md5;
 };
 
-// Decodes |filename| with |num_threads|. Returns the md5 of the decoded frames.
-string DecodeFile(const string &filename, int num_threads) {
+// Decodes |filename| with |num_threads|, using row based multi-threading when
+// |row_mt| is set. Returns the md5 of the decoded frames.
+string DecodeFile(const string &filename, int num_threads, int row_mt = 0) {
   libvpx_test::WebMVideoSource video(filename);
   video.Init();
 
   vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
   cfg.threads = num_threads;
   libvpx_test::VP9Decoder decoder(cfg, 0);
+  if (row_mt) decoder.Control(VP9D_SET_ROW_MT, row_mt);
 
   libvpx_test::MD5 md5;
   for (video.Begin(); video.cxdata(); video.Next()) {
@@ -183,12 +185,12 @@ string DecodeFile(const string &filename, int num_threads) {
   return string(md5.Get());
 }
 
-void DecodeFiles(const FileList files[]) {
+void DecodeFiles(const FileList files[], int row_mt = 0) {
   for (const FileList *iter = files; iter->name != NULL; ++iter) {
     SCOPED_TRACE(iter->name);
     for (int t = 1; t <= 8; ++t) {
-      EXPECT_EQ(iter->expected_md5, DecodeFile(iter->name, t)) << "threads = "
-                                                               << t;
+      EXPECT_EQ(iter->expected_md5, DecodeFile(iter->name, t, row_mt))
+          << "threads = " << t;
     }
   }
 }
@@ -313,6 +315,19 @@ TEST(VP9DecodeMultiThreadedTest, NonFrameParallel) {
 
   DecodeFiles(files);
 }
+
+TEST(VP9DecodeMultiThreadedTest, RowMT) {
+  static const FileList files[] = {
+    { "vp90-2-03-size-226x226.webm", "b35a1b707b28e82be025d960aba039bc" },
+    { "vp90-2-08-tile_1x2.webm", "570b4a5d5a70d58b5359671668328a16" },
+    { "vp90-2-08-tile_1x4.webm", "988d86049e884c66909d2d163a09841a" },
+    { "vp90-2-08-tile-4x1.webm", "06505aade6647c583c8e00a2f582266f" },
+    { "vp90-2-08-tile-4x4.webm", "85c2299892460d76e2c600502d52bfe2" },
+    { NULL, NULL }
+  };
+
+  DecodeFiles(files, 1);
+}
 #endif  // CONFIG_WEBM_IO
 
 INSTANTIATE_TEST_CASE_P(Synchronous, VPxWorkerThreadTest, ::testing::Bool());
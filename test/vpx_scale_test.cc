@@ -15,6 +15,7 @@
 #include "test/clear_system_state.h"
 #include "test/register_state_check.h"
 #include "vpx_mem/vpx_mem.h"
+#include "vpx_scale/vpx_scale.h"
 #include "vpx_scale/yv12config.h"
 
 namespace {
@@ -233,4 +234,64 @@ TEST_P(CopyFrameTest, CopyFrame) { ASSERT_NO_FATAL_FAILURE(RunTest()); }
 
 INSTANTIATE_TEST_CASE_P(C, CopyFrameTest,
                         ::testing::Values(vp8_yv12_copy_frame_c));
+
+class DownscaleFrameTest : public VpxScaleBase, public ::testing::Test {
+ public:
+  virtual ~DownscaleFrameTest() {}
+
+ protected:
+  // Checks every pixel of 'dst' is the rounded average of the pixels of the
+  // (1 << shift) block of 'src' it covers, clipped to the visible area.
+  static void ComparePlane(const uint8_t *src, int src_w, int src_h,
+                           int src_stride, const uint8_t *dst, int dst_w,
+                           int dst_h, int dst_stride, int shift) {
+    for (int y = 0; y < dst_h; ++y) {
+      for (int x = 0; x < dst_w; ++x) {
+        int sum = 0, count = 0;
+        for (int i = y << shift; i < ((y + 1) << shift) && i < src_h; ++i) {
+          for (int j = x << shift; j < ((x + 1) << shift) && j < src_w; ++j) {
+            sum += src[i * src_stride + j];
+            ++count;
+          }
+        }
+        ASSERT_EQ((sum + count / 2) / count, dst[y * dst_stride + x])
+            << "x: " << x << " y: " << y << " shift: " << shift;
+      }
+    }
+  }
+
+  void RunTest() {
+    static const int kSizesToTest[] = { 1, 15, 33, 145, 512 };
+    for (int h = 0; h < 5; ++h) {
+      for (int w = 0; w < 5; ++w) {
+        for (int shift = 1; shift <= 3; ++shift) {
+          const int round = (1 << shift) - 1;
+          YV12_BUFFER_CONFIG dst;
+          memset(&dst, 0, sizeof(dst));
+          ASSERT_NO_FATAL_FAILURE(
+              ResetImage(kSizesToTest[w], kSizesToTest[h]));
+          ASSERT_EQ(0, vp8_yv12_alloc_frame_buffer(
+                           &dst, (width_ + round) >> shift,
+                           (height_ + round) >> shift, VP8BORDERINPIXELS));
+          vpx_yv12_downscale_frame(&img_, &dst, shift);
+          ComparePlane(img_.y_buffer, img_.y_crop_width, img_.y_crop_height,
+                       img_.y_stride, dst.y_buffer, dst.y_crop_width,
+                       dst.y_crop_height, dst.y_stride, shift);
+          ComparePlane(img_.u_buffer, img_.uv_crop_width, img_.uv_crop_height,
+                       img_.uv_stride, dst.u_buffer, dst.uv_crop_width,
+                       dst.uv_crop_height, dst.uv_stride, shift);
+          ComparePlane(img_.v_buffer, img_.uv_crop_width, img_.uv_crop_height,
+                       img_.uv_stride, dst.v_buffer, dst.uv_crop_width,
+                       dst.uv_crop_height, dst.uv_stride, shift);
+          vp8_yv12_de_alloc_frame_buffer(&dst);
+          DeallocImage();
+        }
+      }
+    }
+  }
+};
+
+TEST_F(DownscaleFrameTest, DownscaleFrame) {
+  ASSERT_NO_FATAL_FAILURE(RunTest());
+}
 }  // namespace
@@ -32,6 +32,7 @@ void vp8_de_alloc_frame_buffers(VP8_COMMON *oci) {
 
   vpx_free(oci->pp_limits_buffer);
   oci->pp_limits_buffer = NULL;
+  oci->pp_limits_bands = 0;
 
   vpx_free(oci->postproc_state.generated_noise);
   oci->postproc_state.generated_noise = NULL;
@@ -118,6 +119,7 @@ int vp8_alloc_frame_buffers(VP8_COMMON *oci, int width, int height) {
    */
   oci->pp_limits_buffer = vpx_memalign(16, 24 * ((oci->mb_cols + 1) & ~1));
   if (!oci->pp_limits_buffer) goto allocation_fail;
+  oci->pp_limits_bands = 1;
 #endif
 
   return 0;
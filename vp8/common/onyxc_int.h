@@ -86,6 +86,7 @@ typedef struct VP8Common {
   YV12_BUFFER_CONFIG post_proc_buffer_int;
   int post_proc_buffer_int_used;
   unsigned char *pp_limits_buffer; /* post-processing filter coefficients */
+  int pp_limits_bands; /* number of bands pp_limits_buffer has room for */
 #endif
 
   FRAME_TYPE
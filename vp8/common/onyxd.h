@@ -30,6 +30,7 @@ typedef struct {
   int postprocess;
   int max_threads;
   int error_concealment;
+  struct vpx_thread_pool *thread_pool;
 } VP8D_CONFIG;
 
 typedef enum { VP8D_OK = 0 } VP8D_SETTING;
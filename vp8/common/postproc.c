@@ -52,67 +52,167 @@ static int q2mbl(int x) {
   return x * x / 3;
 }
 
-static void vp8_de_mblock(YV12_BUFFER_CONFIG *post, int q) {
-  vpx_mbpost_proc_across_ip(post->y_buffer, post->y_stride, post->y_height,
-                            post->y_width, q2mbl(q));
-  vpx_mbpost_proc_down(post->y_buffer, post->y_stride, post->y_height,
-                       post->y_width, q2mbl(q));
+static int deblock_ppl(int q) {
+  double level = 6.0e-05 * q * q * q - .0067 * q * q + .306 * q + .0065;
+  return (int)(level + .5);
 }
 
-void vp8_deblock(VP8_COMMON *cm, YV12_BUFFER_CONFIG *source,
-                 YV12_BUFFER_CONFIG *post, int q, int low_var_thresh,
-                 int flag) {
-  double level = 6.0e-05 * q * q * q - .0067 * q * q + .306 * q + .0065;
-  int ppl = (int)(level + .5);
+/* Size of the filter limits of one band in pp_limits_buffer. Rounds up mb_cols
+ * to support SIMD reads. */
+static int pp_limits_size(const VP8_COMMON *cm) {
+  return 24 * ((cm->mb_cols + 1) & ~1);
+}
+
+static void get_band(int size, int band, int num_bands, int *start,
+                     int *end) {
+  *start = size * band / num_bands;
+  *end = size * (band + 1) / num_bands;
+}
 
-  const MODE_INFO *mode_info_context = cm->show_frame_mi;
+static void deblock_mb_rows(VP8_COMMON *cm, YV12_BUFFER_CONFIG *source,
+                            YV12_BUFFER_CONFIG *post, int ppl,
+                            int mb_row_start, int mb_row_end,
+                            unsigned char *limits) {
+  const MODE_INFO *mode_info_context =
+      cm->show_frame_mi + mb_row_start * cm->mode_info_stride;
   int mbr, mbc;
 
   /* The pixel thresholds are adjusted according to if or not the macroblock
    * is a skipped block.  */
-  unsigned char *ylimits = cm->pp_limits_buffer;
-  unsigned char *uvlimits = cm->pp_limits_buffer + 16 * cm->mb_cols;
+  unsigned char *ylimits = limits;
+  unsigned char *uvlimits = limits + 16 * cm->mb_cols;
+
+  for (mbr = mb_row_start; mbr < mb_row_end; ++mbr) {
+    unsigned char *ylptr = ylimits;
+    unsigned char *uvlptr = uvlimits;
+    for (mbc = 0; mbc < cm->mb_cols; ++mbc) {
+      unsigned char mb_ppl;
+
+      if (mode_info_context->mbmi.mb_skip_coeff) {
+        mb_ppl = (unsigned char)ppl >> 1;
+      } else {
+        mb_ppl = (unsigned char)ppl;
+      }
+
+      memset(ylptr, mb_ppl, 16);
+      memset(uvlptr, mb_ppl, 8);
+
+      ylptr += 16;
+      uvlptr += 8;
+      mode_info_context++;
+    }
+    mode_info_context++;
+
+    vpx_post_proc_down_and_across_mb_row(
+        source->y_buffer + 16 * mbr * source->y_stride,
+        post->y_buffer + 16 * mbr * post->y_stride, source->y_stride,
+        post->y_stride, source->y_width, ylimits, 16);
+
+    vpx_post_proc_down_and_across_mb_row(
+        source->u_buffer + 8 * mbr * source->uv_stride,
+        post->u_buffer + 8 * mbr * post->uv_stride, source->uv_stride,
+        post->uv_stride, source->uv_width, uvlimits, 8);
+    vpx_post_proc_down_and_across_mb_row(
+        source->v_buffer + 8 * mbr * source->uv_stride,
+        post->v_buffer + 8 * mbr * post->uv_stride, source->uv_stride,
+        post->uv_stride, source->uv_width, uvlimits, 8);
+  }
+}
+
+void vp8_deblock(VP8_COMMON *cm, YV12_BUFFER_CONFIG *source,
+                 YV12_BUFFER_CONFIG *post, int q, int low_var_thresh,
+                 int flag) {
+  const int ppl = deblock_ppl(q);
   (void)low_var_thresh;
   (void)flag;
 
   if (ppl > 0) {
-    for (mbr = 0; mbr < cm->mb_rows; ++mbr) {
-      unsigned char *ylptr = ylimits;
-      unsigned char *uvlptr = uvlimits;
-      for (mbc = 0; mbc < cm->mb_cols; ++mbc) {
-        unsigned char mb_ppl;
-
-        if (mode_info_context->mbmi.mb_skip_coeff) {
-          mb_ppl = (unsigned char)ppl >> 1;
-        } else {
-          mb_ppl = (unsigned char)ppl;
-        }
-
-        memset(ylptr, mb_ppl, 16);
-        memset(uvlptr, mb_ppl, 8);
-
-        ylptr += 16;
-        uvlptr += 8;
-        mode_info_context++;
-      }
-      mode_info_context++;
+    deblock_mb_rows(cm, source, post, ppl, 0, cm->mb_rows,
+                    cm->pp_limits_buffer);
+  } else {
+    vp8_yv12_copy_frame(source, post);
+  }
+}
 
-      vpx_post_proc_down_and_across_mb_row(
-          source->y_buffer + 16 * mbr * source->y_stride,
-          post->y_buffer + 16 * mbr * post->y_stride, source->y_stride,
-          post->y_stride, source->y_width, ylimits, 16);
+/* Deblocks the macroblock rows of a band, then filters them across for the
+ * demacroblocking. A deblocking level of 0 has been handled as a copy of the
+ * whole frame beforehand. */
+static void deblock_band(const VP8_PP_STAGE *stage, int band) {
+  VP8_COMMON *const cm = stage->cm;
+  YV12_BUFFER_CONFIG *const post = stage->post;
+  const int ppl = deblock_ppl(stage->q);
+  int mb_row_start, mb_row_end;
 
-      vpx_post_proc_down_and_across_mb_row(
-          source->u_buffer + 8 * mbr * source->uv_stride,
-          post->u_buffer + 8 * mbr * post->uv_stride, source->uv_stride,
-          post->uv_stride, source->uv_width, uvlimits, 8);
-      vpx_post_proc_down_and_across_mb_row(
-          source->v_buffer + 8 * mbr * source->uv_stride,
-          post->v_buffer + 8 * mbr * post->uv_stride, source->uv_stride,
-          post->uv_stride, source->uv_width, uvlimits, 8);
-    }
-  } else {
+  get_band(cm->mb_rows, band, stage->num_bands, &mb_row_start, &mb_row_end);
+  if (ppl > 0) {
+    deblock_mb_rows(cm, stage->source, post, ppl, mb_row_start, mb_row_end,
+                    cm->pp_limits_buffer + band * pp_limits_size(cm));
+  }
+  if (stage->demacroblock && mb_row_end > mb_row_start) {
+    vpx_mbpost_proc_across_ip(
+        post->y_buffer + 16 * mb_row_start * post->y_stride, post->y_stride,
+        16 * (mb_row_end - mb_row_start), post->y_width, q2mbl(stage->q));
+  }
+}
+
+/* The vertical demacroblocking filter runs down whole columns, so it is split
+ * in bands of macroblock columns. The post buffers are a whole number of
+ * macroblocks wide and high. */
+static void demacroblock_down_band(const VP8_PP_STAGE *stage, int band) {
+  VP8_COMMON *const cm = stage->cm;
+  YV12_BUFFER_CONFIG *const post = stage->post;
+  int mb_col_start, mb_col_end;
+
+  get_band(cm->mb_cols, band, stage->num_bands, &mb_col_start, &mb_col_end);
+  if (mb_col_end > mb_col_start) {
+    vpx_mbpost_proc_down(post->y_buffer + 16 * mb_col_start, post->y_stride,
+                         post->y_height, 16 * (mb_col_end - mb_col_start),
+                         q2mbl(stage->q));
+  }
+}
+
+static void mfqe_band(const VP8_PP_STAGE *stage, int band) {
+  int mb_row_start, mb_row_end;
+
+  get_band(stage->cm->mb_rows, band, stage->num_bands, &mb_row_start,
+           &mb_row_end);
+  vp8_multiframe_quality_enhance_rows(stage->cm, mb_row_start, mb_row_end);
+}
+
+static void run_stage_serial(void *data, const VP8_PP_STAGE *stage) {
+  int band;
+  (void)data;
+
+  for (band = 0; band < stage->num_bands; ++band) {
+    stage->process_band(stage, band);
+  }
+}
+
+/* Deblocks source into post, filtering across and down the macroblock edges
+ * when demacroblock is set. */
+static void deblock_frame(VP8_COMMON *cm, YV12_BUFFER_CONFIG *source,
+                          YV12_BUFFER_CONFIG *post, int q, int demacroblock,
+                          vp8_pp_run_stage_fn run_stage, void *run_data,
+                          int num_bands) {
+  VP8_PP_STAGE stage;
+
+  stage.cm = cm;
+  stage.source = source;
+  stage.post = post;
+  stage.q = q;
+  stage.demacroblock = demacroblock;
+  stage.num_bands = num_bands;
+
+  if (deblock_ppl(q) <= 0) {
     vp8_yv12_copy_frame(source, post);
+    if (!demacroblock) return;
+  }
+
+  stage.process_band = deblock_band;
+  run_stage(run_data, &stage);
+  if (demacroblock) {
+    stage.process_band = demacroblock_down_band;
+    run_stage(run_data, &stage);
   }
 }
 
@@ -272,6 +372,13 @@ void vp8_blend_b_c(unsigned char *y, unsigned char *u, unsigned char *v,
 #if CONFIG_POSTPROC
 int vp8_post_proc_frame(VP8_COMMON *oci, YV12_BUFFER_CONFIG *dest,
                         vp8_ppflags_t *ppflags) {
+  return vp8_post_proc_frame_mt(oci, dest, ppflags, run_stage_serial, NULL, 1);
+}
+
+int vp8_post_proc_frame_mt(VP8_COMMON *oci, YV12_BUFFER_CONFIG *dest,
+                           vp8_ppflags_t *ppflags,
+                           vp8_pp_run_stage_fn run_stage, void *run_data,
+                           int num_bands) {
   int q = oci->filter_level * 10 / 6;
   int flags = ppflags->post_proc_flag;
   int deblock_level = ppflags->deblocking_level;
@@ -300,6 +407,16 @@ int vp8_post_proc_frame(VP8_COMMON *oci, YV12_BUFFER_CONFIG *dest,
     }
   }
 
+  /* Each band of the deblocking needs its own filter limits. */
+  if ((flags & (VP8D_DEBLOCK | VP8D_DEMACROBLOCK)) &&
+      num_bands > oci->pp_limits_bands) {
+    vpx_free(oci->pp_limits_buffer);
+    oci->pp_limits_bands = 0;
+    oci->pp_limits_buffer = vpx_memalign(16, num_bands * pp_limits_size(oci));
+    if (!oci->pp_limits_buffer) return 1;
+    oci->pp_limits_bands = num_bands;
+  }
+
   /* Allocate post_proc_buffer_int if needed */
   if ((flags & VP8D_MFQE) && !oci->post_proc_buffer_int_used) {
     if ((flags & VP8D_DEBLOCK) || (flags & VP8D_DEMACROBLOCK)) {
@@ -328,30 +445,34 @@ int vp8_post_proc_frame(VP8_COMMON *oci, YV12_BUFFER_CONFIG *dest,
       oci->current_video_frame >= 2 &&
       oci->postproc_state.last_base_qindex < 60 &&
       oci->base_qindex - oci->postproc_state.last_base_qindex >= 20) {
-    vp8_multiframe_quality_enhance(oci);
+    VP8_PP_STAGE stage;
+    stage.process_band = mfqe_band;
+    stage.cm = oci;
+    stage.num_bands = num_bands;
+    run_stage(run_data, &stage);
     if (((flags & VP8D_DEBLOCK) || (flags & VP8D_DEMACROBLOCK)) &&
         oci->post_proc_buffer_int_used) {
       vp8_yv12_copy_frame(&oci->post_proc_buffer, &oci->post_proc_buffer_int);
       if (flags & VP8D_DEMACROBLOCK) {
-        vp8_deblock(oci, &oci->post_proc_buffer_int, &oci->post_proc_buffer,
-                    q + (deblock_level - 5) * 10, 1, 0);
-        vp8_de_mblock(&oci->post_proc_buffer, q + (deblock_level - 5) * 10);
+        deblock_frame(oci, &oci->post_proc_buffer_int, &oci->post_proc_buffer,
+                      q + (deblock_level - 5) * 10, 1, run_stage, run_data,
+                      num_bands);
       } else if (flags & VP8D_DEBLOCK) {
-        vp8_deblock(oci, &oci->post_proc_buffer_int, &oci->post_proc_buffer, q,
-                    1, 0);
+        deblock_frame(oci, &oci->post_proc_buffer_int, &oci->post_proc_buffer,
+                      q, 0, run_stage, run_data, num_bands);
       }
     }
     /* Move partially towards the base q of the previous frame */
     oci->postproc_state.last_base_qindex =
         (3 * oci->postproc_state.last_base_qindex + oci->base_qindex) >> 2;
   } else if (flags & VP8D_DEMACROBLOCK) {
-    vp8_deblock(oci, oci->frame_to_show, &oci->post_proc_buffer,
-                q + (deblock_level - 5) * 10, 1, 0);
-    vp8_de_mblock(&oci->post_proc_buffer, q + (deblock_level - 5) * 10);
-
+    deblock_frame(oci, oci->frame_to_show, &oci->post_proc_buffer,
+                  q + (deblock_level - 5) * 10, 1, run_stage, run_data,
+                  num_bands);
     oci->postproc_state.last_base_qindex = oci->base_qindex;
   } else if (flags & VP8D_DEBLOCK) {
-    vp8_deblock(oci, oci->frame_to_show, &oci->post_proc_buffer, q, 1, 0);
+    deblock_frame(oci, oci->frame_to_show, &oci->post_proc_buffer, q, 0,
+                  run_stage, run_data, num_bands);
     oci->postproc_state.last_base_qindex = oci->base_qindex;
   } else {
     vp8_yv12_copy_frame(oci->frame_to_show, &oci->post_proc_buffer);
@@ -26,9 +26,31 @@ struct postproc_state {
 #ifdef __cplusplus
 extern "C" {
 #endif
+/* A pass of the postprocessing over a frame, split in bands of macroblock rows
+ * (or columns) that can be processed concurrently. */
+typedef struct vp8_pp_stage {
+  void (*process_band)(const struct vp8_pp_stage *stage, int band);
+  struct VP8Common *cm;
+  YV12_BUFFER_CONFIG *source;
+  YV12_BUFFER_CONFIG *post;
+  int q;
+  int demacroblock;
+  int num_bands;
+} VP8_PP_STAGE;
+
+/* Calls stage->process_band() for each band of the stage, possibly on several
+ * threads, and returns once all bands are done. */
+typedef void (*vp8_pp_run_stage_fn)(void *data, const VP8_PP_STAGE *stage);
+
 int vp8_post_proc_frame(struct VP8Common *oci, YV12_BUFFER_CONFIG *dest,
                         vp8_ppflags_t *flags);
 
+/* As vp8_post_proc_frame(), running the deblocking, demacroblocking and MFQE
+ * in num_bands bands through run_stage(). */
+int vp8_post_proc_frame_mt(struct VP8Common *oci, YV12_BUFFER_CONFIG *dest,
+                           vp8_ppflags_t *flags, vp8_pp_run_stage_fn run_stage,
+                           void *run_data, int num_bands);
+
 void vp8_de_noise(struct VP8Common *oci, YV12_BUFFER_CONFIG *source,
                   YV12_BUFFER_CONFIG *post, int q, int low_var_thresh, int flag,
                   int uvfilter);
@@ -39,6 +61,8 @@ void vp8_deblock(struct VP8Common *oci, YV12_BUFFER_CONFIG *source,
 #define MFQE_PRECISION 4
 
 void vp8_multiframe_quality_enhance(struct VP8Common *cm);
+void vp8_multiframe_quality_enhance_rows(struct VP8Common *cm, int mb_row_start,
+                                         int mb_row_end);
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -211,13 +211,40 @@ static INLINE int protected_read(pthread_mutex_t *const mutex, const int *p) {
   return *p;
 }
 
-static INLINE void sync_read(pthread_mutex_t *const mutex, int mb_col,
+/* Number of pause iterations a row waits for the row above before blocking.
+ * Roughly the time to code a few macroblocks, so that a thread trailing
+ * closely behind its neighbour never sleeps, while one that is far behind (or
+ * waiting on a descheduled thread) does not burn a core.
+ */
+#define VP8_SYNC_SPIN_COUNT 1024
+
+/* Waits until the row above has progressed past mb_col + nsync - 1. Row
+ * progress is published with sync_write(), which signals cond under mutex.
+ */
+static INLINE void sync_read(pthread_mutex_t *const mutex,
+                             pthread_cond_t *const cond, int mb_col,
                              const int *last_row_current_mb_col,
                              const int nsync) {
-  while (mb_col > (protected_read(mutex, last_row_current_mb_col) - nsync)) {
+  const volatile int *const last = last_row_current_mb_col;
+  int spin = 0;
+  while (mb_col > *last - nsync && spin++ < VP8_SYNC_SPIN_COUNT)
     x86_pause_hint();
-    thread_sleep(0);
-  }
+
+  /* Taking the mutex also orders the reads of the row above after the write
+   * of its progress.
+   */
+  pthread_mutex_lock(mutex);
+  while (mb_col > *last_row_current_mb_col - nsync)
+    pthread_cond_wait(cond, mutex);
+  pthread_mutex_unlock(mutex);
+}
+
+static INLINE void sync_write(pthread_mutex_t *const mutex,
+                              pthread_cond_t *const cond, int *p, int v) {
+  pthread_mutex_lock(mutex);
+  *p = v;
+  pthread_cond_broadcast(cond);
+  pthread_mutex_unlock(mutex);
 }
 
 static INLINE void protected_write(pthread_mutex_t *mutex, int *p, int v) {
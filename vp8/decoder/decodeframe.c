@@ -433,6 +433,28 @@ static void yv12_extend_frame_left_right_c(YV12_BUFFER_CONFIG *ybf,
   }
 }
 
+void vp8_rows_decoded(VP8D_COMP *pbi, int mb_row) {
+  VP8_COMMON *const pc = &pbi->common;
+
+  if (pbi->rows_decoded_cb == NULL) return;
+#if CONFIG_MULTITHREAD
+  /* the decoding threads report the rows they complete */
+  pthread_mutex_lock(&pbi->rows_decoded_mutex);
+#endif
+  if (mb_row > pbi->rows_reported) {
+    const int row_start = pbi->rows_reported * 16;
+    const int row_end = VPXMIN(mb_row * 16, pc->Height);
+    pbi->rows_reported = mb_row;
+    if (row_end > row_start) {
+      pbi->rows_decoded_cb(pbi->rows_decoded_priv,
+                           pbi->dec_fb_ref[INTRA_FRAME], row_start, row_end);
+    }
+  }
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&pbi->rows_decoded_mutex);
+#endif
+}
+
 static void decode_mb_rows(VP8D_COMP *pbi) {
   VP8_COMMON *const pc = &pbi->common;
   MACROBLOCKD *const xd = &pbi->mb;
@@ -627,8 +649,12 @@ static void decode_mb_rows(VP8D_COMP *pbi) {
         lf_dst[2] += recon_uv_stride * 8;
         lf_mic += pc->mb_cols;
         lf_mic++; /* Skip border mb */
+
+        /* the row above the filtered one is final */
+        vp8_rows_decoded(pbi, mb_row - 1);
       }
     } else {
+      vp8_rows_decoded(pbi, mb_row + 1);
       if (mb_row > 0) {
         /**/
         yv12_extend_frame_left_right_c(yv12_fb_new, eb_dst[0], eb_dst[1],
@@ -795,9 +821,7 @@ static void setup_token_decoder(VP8D_COMP *pbi,
 
 #if CONFIG_MULTITHREAD
   /* Clamp number of decoder threads */
-  if (pbi->decoding_thread_count > num_token_partitions - 1) {
-    pbi->decoding_thread_count = num_token_partitions - 1;
-  }
+  pbi->decoding_thread_count = pbi->allocated_decoding_thread_count;
   if ((int)pbi->decoding_thread_count > pbi->common.mb_rows - 1) {
     assert(pbi->common.mb_rows > 0);
     pbi->decoding_thread_count = pbi->common.mb_rows - 1;
@@ -1023,6 +1047,7 @@ int vp8_decode_frame(VP8D_COMP *pbi) {
   pc->filter_type = (LOOPFILTERTYPE)vp8_read_bit(bc);
   pc->filter_level = vp8_read_literal(bc, 6);
   pc->sharpness_level = vp8_read_literal(bc, 3);
+  if (pbi->skip_loop_filter) pc->filter_level = 0;
 
   /* Read in loop filter deltas applied at the MB level based on mode or ref
    * frame. */
@@ -1197,9 +1222,10 @@ int vp8_decode_frame(VP8D_COMP *pbi) {
 
   memset(pc->above_context, 0, sizeof(ENTROPY_CONTEXT_PLANES) * pc->mb_cols);
   pbi->frame_corrupt_residual = 0;
+  pbi->rows_reported = 0;
 
 #if CONFIG_MULTITHREAD
-  if (pbi->b_multithreaded_rd && pc->multi_token_partition != ONE_PARTITION) {
+  if (pbi->b_multithreaded_rd) {
     unsigned int thread;
     vp8mt_decode_mb_rows(pbi, xd);
     vp8_yv12_extend_frame_borders(yv12_fb_new);
@@ -1228,6 +1254,9 @@ int vp8_decode_frame(VP8D_COMP *pbi) {
     }
   }
 
+  /* Like VP9, the last rows of a corrupt frame are not reported. */
+  if (!yv12_fb_new->corrupted) vp8_rows_decoded(pbi, pc->mb_rows);
+
   /* vpx_log("Decoder: Frame Decoded, Size Roughly:%d bytes
    * \n",bc->pos+pbi->bc2.pos); */
 
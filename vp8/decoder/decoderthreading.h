@@ -21,6 +21,9 @@ void vp8_decoder_remove_threads(VP8D_COMP *pbi);
 void vp8_decoder_create_threads(VP8D_COMP *pbi);
 void vp8mt_alloc_temp_buffers(VP8D_COMP *pbi, int width, int prev_mb_rows);
 void vp8mt_de_alloc_temp_buffers(VP8D_COMP *pbi, int mb_rows);
+#if CONFIG_POSTPROC
+void vp8mt_run_pp_stage(void *data, const VP8_PP_STAGE *stage);
+#endif
 #endif
 
 #ifdef __cplusplus
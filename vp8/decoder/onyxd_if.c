@@ -60,6 +60,7 @@ static void remove_decompressor(VP8D_COMP *pbi) {
   vp8_de_alloc_overlap_lists(pbi);
 #endif
   vp8_remove_common(&pbi->common);
+  vp8_yv12_de_alloc_frame_buffer(&pbi->downscaled_frame);
   vpx_free(pbi);
 }
 
@@ -387,6 +388,33 @@ decode_exit:
   vpx_clear_system_state();
   return retcode;
 }
+static int downscale_frame(VP8D_COMP *pbi, YV12_BUFFER_CONFIG *sd) {
+  const int shift = pbi->downscale_shift;
+  const int round = (1 << shift) - 1;
+  const int width = (sd->y_width + round) >> shift;
+  const int height = (sd->y_height + round) >> shift;
+  YV12_BUFFER_CONFIG *const dst = &pbi->downscaled_frame;
+  YV12_BUFFER_CONFIG src = *sd;
+
+  if ((dst->y_crop_width != width || dst->y_crop_height != height) &&
+      vp8_yv12_alloc_frame_buffer(dst, width, height, VP8BORDERINPIXELS) < 0) {
+    return -1;
+  }
+
+  /* The frame buffers are allocated with the size aligned to 16. */
+  src.y_crop_width = sd->y_width;
+  src.y_crop_height = sd->y_height;
+  src.uv_crop_width = (sd->y_width + 1) / 2;
+  src.uv_crop_height = (sd->y_height + 1) / 2;
+  vpx_yv12_downscale_frame(&src, dst, shift);
+
+  *sd = *dst;
+  sd->y_width = width;
+  sd->y_height = height;
+  sd->uv_height = (height + 1) / 2;
+  return 0;
+}
+
 int vp8dx_get_raw_frame(VP8D_COMP *pbi, YV12_BUFFER_CONFIG *sd,
                         int64_t *time_stamp, int64_t *time_end_stamp,
                         vp8_ppflags_t *flags) {
@@ -402,7 +430,17 @@ int vp8dx_get_raw_frame(VP8D_COMP *pbi, YV12_BUFFER_CONFIG *sd,
   *time_end_stamp = 0;
 
 #if CONFIG_POSTPROC
+#if CONFIG_MULTITHREAD
+  if (pbi->b_multithreaded_rd && pbi->decoding_thread_count > 0) {
+    /* the decoding threads are idle until the next frame */
+    ret = vp8_post_proc_frame_mt(&pbi->common, sd, flags, vp8mt_run_pp_stage,
+                                 pbi, (int)pbi->decoding_thread_count + 1);
+  } else {
+    ret = vp8_post_proc_frame(&pbi->common, sd, flags);
+  }
+#else
   ret = vp8_post_proc_frame(&pbi->common, sd, flags);
+#endif
 #else
   (void)flags;
 
@@ -410,13 +448,14 @@ int vp8dx_get_raw_frame(VP8D_COMP *pbi, YV12_BUFFER_CONFIG *sd,
     *sd = *pbi->common.frame_to_show;
     sd->y_width = pbi->common.Width;
     sd->y_height = pbi->common.Height;
-    sd->uv_height = pbi->common.Height / 2;
+    sd->uv_height = (pbi->common.Height + 1) / 2;
     ret = 0;
   } else {
     ret = -1;
   }
 
 #endif /*!CONFIG_POSTPROC*/
+  if (ret == 0 && pbi->downscale_shift > 0) ret = downscale_frame(pbi, sd);
   vpx_clear_system_state();
   return ret;
 }
@@ -453,6 +492,7 @@ int vp8_create_decoder_instances(struct frame_buffers *fb, VP8D_CONFIG *oxcf) {
 
   fb->pbi[0]->common.error.setjmp = 1;
   fb->pbi[0]->max_threads = oxcf->max_threads;
+  fb->pbi[0]->thread_pool = oxcf->thread_pool;
   vp8_decoder_create_threads(fb->pbi[0]);
   fb->pbi[0]->common.error.setjmp = 0;
 #endif
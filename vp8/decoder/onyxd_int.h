@@ -33,6 +33,14 @@ typedef struct {
 
 typedef struct { MACROBLOCKD mbd; } MB_ROW_DEC;
 
+/* Tokens of a macroblock parsed ahead of its reconstruction. */
+typedef struct {
+  DECLARE_ALIGNED(16, short, qcoeff[400]);
+  char eobs[25];
+  /* Bool decoder error state after the tokens of the macroblock. */
+  char bool_error;
+} MB_TOKENS;
+
 typedef struct {
   int enabled;
   unsigned int count;
@@ -40,6 +48,12 @@ typedef struct {
   unsigned int sizes[MAX_PARTITIONS];
 } FRAGMENT_DATA;
 
+/* Called with the luma rows [row_start, row_end) of 'buf' once they have been
+ * reconstructed and loop filtered. */
+typedef void (*vp8_rows_decoded_cb_fn_t)(void *priv,
+                                         const YV12_BUFFER_CONFIG *buf,
+                                         int row_start, int row_end);
+
 #define MAX_FB_MT_DEC 32
 
 struct frame_buffers {
@@ -77,8 +91,16 @@ typedef struct VP8D_COMP {
   int mt_baseline_filter_level[MAX_MB_SEGMENTS];
   int sync_range;
   int *mt_current_mb_col; /* Each row remembers its already decoded column. */
+  /* Each row remembers its already parsed column when the tokens are parsed
+   * ahead of the reconstruction. */
+  int *mt_parsed_mb_col;
+  /* Tokens of the row being decoded by each thread, 1 + decoding threads x
+   * mb_cols. */
+  MB_TOKENS **mt_row_tokens;
   pthread_mutex_t *pmutex;
+  pthread_cond_t *pcond; /* signalled when a row's progress is written */
   pthread_mutex_t mt_mutex; /* mutex for b_multithreaded_rd */
+  pthread_mutex_t rows_decoded_mutex;
 
   unsigned char **mt_yabove_row; /* mb_rows x width */
   unsigned char **mt_uabove_row;
@@ -91,8 +113,13 @@ typedef struct VP8D_COMP {
   DECODETHREAD_DATA *de_thread_data;
 
   pthread_t *h_decoding_thread;
+  /* Used instead of h_decoding_thread when thread_pool is set. */
+  VPxWorkerPool *thread_pool;
+  VPxWorker *decoding_workers;
   sem_t *h_event_start_decoding;
   sem_t h_event_end_decoding;
+  /* Postprocessing stage run by the threads instead of decoding, if any. */
+  const struct vp8_pp_stage *mt_pp_stage;
 /* end of threading data */
 #endif
 
@@ -115,12 +142,27 @@ typedef struct VP8D_COMP {
   int independent_partitions;
   int frame_corrupt_residual;
 
+  int skip_loop_filter;
+  /* Output frames are downscaled by (1 << downscale_shift) into
+   * downscaled_frame. */
+  int downscale_shift;
+  YV12_BUFFER_CONFIG downscaled_frame;
+
   vpx_decrypt_cb decrypt_cb;
   void *decrypt_state;
+
+  /* The rows of the frame being decoded are reported as they become final,
+   * in order and one range at a time. rows_reported is in MB rows. */
+  vp8_rows_decoded_cb_fn_t rows_decoded_cb;
+  void *rows_decoded_priv;
+  int rows_reported;
 } VP8D_COMP;
 
 int vp8_decode_frame(VP8D_COMP *cpi);
 
+/* Reports the rows above 'mb_row' of the frame being decoded as final. */
+void vp8_rows_decoded(VP8D_COMP *pbi, int mb_row);
+
 int vp8_create_decoder_instances(struct frame_buffers *fb, VP8D_CONFIG *oxcf);
 int vp8_remove_decoder_instances(struct frame_buffers *fb);
 
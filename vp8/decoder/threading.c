@@ -81,18 +81,10 @@ static void setup_decoding_thread_data(VP8D_COMP *pbi, MACROBLOCKD *xd,
   }
 
   for (i = 0; i < pc->mb_rows; ++i) pbi->mt_current_mb_col[i] = -1;
+  for (i = 0; i < pc->mb_rows; ++i) pbi->mt_parsed_mb_col[i] = -1;
 }
 
-static void mt_decode_macroblock(VP8D_COMP *pbi, MACROBLOCKD *xd,
-                                 unsigned int mb_idx) {
-  MB_PREDICTION_MODE mode;
-  int i;
-#if CONFIG_ERROR_CONCEALMENT
-  int corruption_detected = 0;
-#else
-  (void)mb_idx;
-#endif
-
+static void mt_decode_mb_tokens(VP8D_COMP *pbi, MACROBLOCKD *xd) {
   if (xd->mode_info_context->mbmi.mb_skip_coeff) {
     vp8_reset_mb_tokens_context(xd);
   } else if (!vp8dx_bool_error(xd->current_bc)) {
@@ -102,6 +94,97 @@ static void mt_decode_macroblock(VP8D_COMP *pbi, MACROBLOCKD *xd,
     /* Special case:  Force the loopfilter to skip when eobtotal is zero */
     xd->mode_info_context->mbmi.mb_skip_coeff = (eobtotal == 0);
   }
+}
+
+/* Parses the tokens of a macroblock row ahead of its reconstruction, so that
+ * the rows of a token partition can be reconstructed by different threads.
+ * Returns the bool decoder error state before the first macroblock. */
+static int mt_parse_mb_row(VP8D_COMP *pbi, MACROBLOCKD *xd, int mb_row,
+                           MB_TOKENS *tokens) {
+  VP8_COMMON *const pc = &pbi->common;
+  const int nsync = pbi->sync_range;
+  const int num_part = 1 << pc->multi_token_partition;
+  int *const parsed_mb_col = &pbi->mt_parsed_mb_col[mb_row];
+  MODE_INFO *const mode_info_context = xd->mode_info_context;
+  int row_bool_error;
+  int mb_col, i;
+
+  /* the bool decoder carries on from the previous row of its partition */
+  if (mb_row >= num_part) {
+    sync_read(&pbi->pmutex[mb_row - num_part], &pbi->pcond[mb_row - num_part],
+              pc->mb_cols, &pbi->mt_parsed_mb_col[mb_row - num_part], nsync);
+  }
+  xd->current_bc = &pbi->mbc[mb_row % num_part];
+  row_bool_error = vp8dx_bool_error(xd->current_bc);
+
+  xd->above_context = pc->above_context;
+  memset(xd->left_context, 0, sizeof(ENTROPY_CONTEXT_PLANES));
+
+  for (mb_col = 0; mb_col < pc->mb_cols; ++mb_col) {
+    if (((mb_col - 1) % nsync) == 0) {
+      sync_write(&pbi->pmutex[mb_row], &pbi->pcond[mb_row], parsed_mb_col,
+                 mb_col - 1);
+    }
+
+    /* the above contexts are written by the parsing of the row above */
+    if (mb_row && !(mb_col & (nsync - 1))) {
+      sync_read(&pbi->pmutex[mb_row - 1], &pbi->pcond[mb_row - 1], mb_col,
+                &pbi->mt_parsed_mb_col[mb_row - 1], nsync);
+    }
+
+    mt_decode_mb_tokens(pbi, xd);
+
+    /* Move the coefficients out of xd, which the reconstruction expects to
+     * be zero. Blocks with a zero eob have none. */
+    memcpy(tokens[mb_col].eobs, xd->eobs, sizeof(xd->eobs));
+    tokens[mb_col].bool_error = vp8dx_bool_error(xd->current_bc);
+    if (!xd->mode_info_context->mbmi.mb_skip_coeff) {
+      for (i = 0; i < 25; ++i) {
+        if (xd->eobs[i] > 0) {
+          memcpy(tokens[mb_col].qcoeff + i * 16, xd->qcoeff + i * 16,
+                 16 * sizeof(xd->qcoeff[0]));
+          memset(xd->qcoeff + i * 16, 0, 16 * sizeof(xd->qcoeff[0]));
+        }
+      }
+    }
+
+    ++xd->mode_info_context;
+    ++xd->above_context;
+  }
+
+  sync_write(&pbi->pmutex[mb_row], &pbi->pcond[mb_row], parsed_mb_col,
+             mb_col + nsync);
+
+  xd->mode_info_context = mode_info_context;
+  return row_bool_error;
+}
+
+/* Restores the tokens parsed by mt_parse_mb_row() into xd. */
+static void mt_load_mb_tokens(MACROBLOCKD *xd, const MB_TOKENS *tokens) {
+  int i;
+  memcpy(xd->eobs, tokens->eobs, sizeof(xd->eobs));
+  if (!xd->mode_info_context->mbmi.mb_skip_coeff) {
+    for (i = 0; i < 25; ++i) {
+      if (xd->eobs[i] > 0) {
+        memcpy(xd->qcoeff + i * 16, tokens->qcoeff + i * 16,
+               16 * sizeof(xd->qcoeff[0]));
+      }
+    }
+  }
+}
+
+/* Reconstructs a macroblock whose tokens are in xd. bool_error is the bool
+ * decoder error state after its tokens. */
+static void mt_decode_macroblock(VP8D_COMP *pbi, MACROBLOCKD *xd,
+                                 unsigned int mb_idx, int bool_error) {
+  MB_PREDICTION_MODE mode;
+  int i;
+#if CONFIG_ERROR_CONCEALMENT
+  int corruption_detected = 0;
+#else
+  (void)mb_idx;
+  (void)bool_error;
+#endif
 
   mode = xd->mode_info_context->mbmi.mode;
 
@@ -116,7 +199,7 @@ static void mt_decode_macroblock(VP8D_COMP *pbi, MACROBLOCKD *xd,
      */
     throw_residual =
         (!pbi->independent_partitions && pbi->frame_corrupt_residual);
-    throw_residual = (throw_residual || vp8dx_bool_error(xd->current_bc));
+    throw_residual = (throw_residual || bool_error);
 
     if ((mb_idx >= pbi->mvs_corrupt_from_mb || throw_residual)) {
       /* MB with corrupt residuals or corrupt mode/motion vectors.
@@ -256,6 +339,14 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
   const int first_row_no_sync_above = pc->mb_cols + nsync;
   int num_part = 1 << pbi->common.multi_token_partition;
   int last_mb_row = start_mb_row;
+  /* Rows of the same partition are decoded in turn when there are no more
+   * threads than partitions. Otherwise each row is parsed before it is
+   * reconstructed. */
+  MB_TOKENS *const tokens =
+      (int)pbi->decoding_thread_count + 1 > num_part
+          ? pbi->mt_row_tokens[start_mb_row]
+          : NULL;
+  int bool_error = 0;
 
   YV12_BUFFER_CONFIG *yv12_fb_new = pbi->dec_fb_ref[INTRA_FRAME];
   YV12_BUFFER_CONFIG *yv12_fb_lst = pbi->dec_fb_ref[LAST_FRAME];
@@ -298,8 +389,12 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
 
     /* save last row processed by this thread */
     last_mb_row = mb_row;
-    /* select bool coder for current partition */
-    xd->current_bc = &pbi->mbc[mb_row % num_part];
+    if (tokens != NULL) {
+      bool_error = mt_parse_mb_row(pbi, xd, mb_row, tokens);
+    } else {
+      /* select bool coder for current partition */
+      xd->current_bc = &pbi->mbc[mb_row % num_part];
+    }
 
     if (mb_row > 0) {
       last_row_current_mb_col = &pbi->mt_current_mb_col[mb_row - 1];
@@ -357,13 +452,13 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
 
     for (mb_col = 0; mb_col < pc->mb_cols; ++mb_col) {
       if (((mb_col - 1) % nsync) == 0) {
-        pthread_mutex_t *mutex = &pbi->pmutex[mb_row];
-        protected_write(mutex, current_mb_col, mb_col - 1);
+        sync_write(&pbi->pmutex[mb_row], &pbi->pcond[mb_row],
+                   current_mb_col, mb_col - 1);
       }
 
       if (mb_row && !(mb_col & (nsync - 1))) {
-        pthread_mutex_t *mutex = &pbi->pmutex[mb_row - 1];
-        sync_read(mutex, mb_col, last_row_current_mb_col, nsync);
+        sync_read(&pbi->pmutex[mb_row - 1], &pbi->pcond[mb_row - 1], mb_col,
+                  last_row_current_mb_col, nsync);
       }
 
       /* Distance of MB to the various image edges.
@@ -375,9 +470,11 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
 
 #if CONFIG_ERROR_CONCEALMENT
       {
-        int corrupt_residual =
+        int corrupt_residual;
+        if (tokens == NULL) bool_error = vp8dx_bool_error(xd->current_bc);
+        corrupt_residual =
             (!pbi->independent_partitions && pbi->frame_corrupt_residual) ||
-            vp8dx_bool_error(xd->current_bc);
+            bool_error;
         if (pbi->ec_active &&
             (xd->mode_info_context->mbmi.ref_frame == INTRA_FRAME) &&
             corrupt_residual) {
@@ -411,12 +508,19 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
       /* propagate errors from reference frames */
       xd->corrupted |= ref_fb_corrupted[xd->mode_info_context->mbmi.ref_frame];
 
-      mt_decode_macroblock(pbi, xd, 0);
+      if (tokens != NULL) {
+        mt_load_mb_tokens(xd, &tokens[mb_col]);
+        bool_error = tokens[mb_col].bool_error;
+      } else {
+        mt_decode_mb_tokens(pbi, xd);
+        bool_error = vp8dx_bool_error(xd->current_bc);
+      }
+      mt_decode_macroblock(pbi, xd, 0, bool_error);
 
       xd->left_available = 1;
 
       /* check if the boolean decoder has suffered an error */
-      xd->corrupted |= vp8dx_bool_error(xd->current_bc);
+      xd->corrupted |= bool_error;
 
       xd->recon_above[0] += 16;
       xd->recon_above[1] += 8;
@@ -549,7 +653,11 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
     }
 
     /* last MB of row is ready just after extension is done */
-    protected_write(&pbi->pmutex[mb_row], current_mb_col, mb_col + nsync);
+    sync_write(&pbi->pmutex[mb_row], &pbi->pcond[mb_row], current_mb_col,
+               mb_col + nsync);
+
+    /* the loop filter of this row was the last to change the row above */
+    vp8_rows_decoded(pbi, pbi->common.filter_level ? mb_row : mb_row + 1);
 
     ++xd->mode_info_context; /* skip prediction column */
     xd->up_available = 1;
@@ -574,6 +682,11 @@ static THREAD_FUNCTION thread_decoding_proc(void *p_data) {
     if (sem_wait(&pbi->h_event_start_decoding[ithread]) == 0) {
       if (protected_read(&pbi->mt_mutex, &pbi->b_multithreaded_rd) == 0) {
         break;
+#if CONFIG_POSTPROC
+      } else if (pbi->mt_pp_stage != NULL) {
+        pbi->mt_pp_stage->process_band(pbi->mt_pp_stage, ithread + 1);
+        sem_post(&pbi->h_event_end_decoding);
+#endif
       } else {
         MACROBLOCKD *xd = &mbrd->mbd;
         xd->left_context = &mb_row_left_context;
@@ -586,6 +699,27 @@ static THREAD_FUNCTION thread_decoding_proc(void *p_data) {
   return 0;
 }
 
+/* Worker hook used in place of thread_decoding_proc when the rows are run on
+ * a shared thread pool: decodes this thread's share of the frame once. */
+static int decoding_worker_hook(void *arg1, void *arg2) {
+  DECODETHREAD_DATA *const thread_data = (DECODETHREAD_DATA *)arg1;
+  VP8D_COMP *const pbi = (VP8D_COMP *)thread_data->ptr1;
+  MB_ROW_DEC *const mbrd = (MB_ROW_DEC *)thread_data->ptr2;
+  MACROBLOCKD *const xd = &mbrd->mbd;
+  ENTROPY_CONTEXT_PLANES mb_row_left_context;
+  (void)arg2;
+
+#if CONFIG_POSTPROC
+  if (pbi->mt_pp_stage != NULL) {
+    pbi->mt_pp_stage->process_band(pbi->mt_pp_stage, thread_data->ithread + 1);
+    return 1;
+  }
+#endif
+  xd->left_context = &mb_row_left_context;
+  mt_decode_mb_rows(pbi, xd, thread_data->ithread + 1);
+  return 1;
+}
+
 void vp8_decoder_create_threads(VP8D_COMP *pbi) {
   int core_count = 0;
   unsigned int ithread;
@@ -593,12 +727,18 @@ void vp8_decoder_create_threads(VP8D_COMP *pbi) {
   pbi->b_multithreaded_rd = 0;
   pbi->allocated_decoding_thread_count = 0;
   pthread_mutex_init(&pbi->mt_mutex, NULL);
+  pthread_mutex_init(&pbi->rows_decoded_mutex, NULL);
 
-  /* limit decoding threads to the max number of token partitions */
-  core_count = (pbi->max_threads > 8) ? 8 : pbi->max_threads;
+  core_count = pbi->max_threads;
 
-  /* limit decoding threads to the available cores */
-  if (core_count > pbi->common.processor_core_count) {
+  if (pbi->thread_pool != NULL) {
+    /* the pool was sized by the application; the caller decodes its own share
+     * of the rows next to the pool threads */
+    if (core_count > vpx_thread_pool_num_threads(pbi->thread_pool) + 1) {
+      core_count = vpx_thread_pool_num_threads(pbi->thread_pool) + 1;
+    }
+  } else if (core_count > pbi->common.processor_core_count) {
+    /* limit decoding threads to the available cores */
     core_count = pbi->common.processor_core_count;
   }
 
@@ -610,6 +750,9 @@ void vp8_decoder_create_threads(VP8D_COMP *pbi) {
     CALLOC_ARRAY(pbi->h_event_start_decoding, pbi->decoding_thread_count);
     CALLOC_ARRAY_ALIGNED(pbi->mb_row_di, pbi->decoding_thread_count, 32);
     CALLOC_ARRAY(pbi->de_thread_data, pbi->decoding_thread_count);
+    if (pbi->thread_pool != NULL) {
+      CALLOC_ARRAY(pbi->decoding_workers, pbi->decoding_thread_count);
+    }
 
     if (sem_init(&pbi->h_event_end_decoding, 0, 0)) {
       vpx_internal_error(&pbi->common.error, VPX_CODEC_MEM_ERROR,
@@ -625,6 +768,17 @@ void vp8_decoder_create_threads(VP8D_COMP *pbi) {
       pbi->de_thread_data[ithread].ptr1 = (void *)pbi;
       pbi->de_thread_data[ithread].ptr2 = (void *)&pbi->mb_row_di[ithread];
 
+      if (pbi->thread_pool != NULL) {
+        const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+        VPxWorker *const worker = &pbi->decoding_workers[ithread];
+        winterface->init(worker);
+        worker->pool = pbi->thread_pool;
+        worker->hook = decoding_worker_hook;
+        worker->data1 = &pbi->de_thread_data[ithread];
+        winterface->reset(worker);
+        continue;
+      }
+
       if (pthread_create(&pbi->h_decoding_thread[ithread], 0,
                          thread_decoding_proc, &pbi->de_thread_data[ithread])) {
         sem_destroy(&pbi->h_event_start_decoding[ithread]);
@@ -659,9 +813,30 @@ void vp8mt_de_alloc_temp_buffers(VP8D_COMP *pbi, int mb_rows) {
     pbi->pmutex = NULL;
   }
 
+  if (pbi->pcond != NULL) {
+    for (i = 0; i < mb_rows; ++i) {
+      pthread_cond_destroy(&pbi->pcond[i]);
+    }
+
+    vpx_free(pbi->pcond);
+    pbi->pcond = NULL;
+  }
+
   vpx_free(pbi->mt_current_mb_col);
   pbi->mt_current_mb_col = NULL;
 
+  vpx_free(pbi->mt_parsed_mb_col);
+  pbi->mt_parsed_mb_col = NULL;
+
+  if (pbi->mt_row_tokens) {
+    for (i = 0; i <= pbi->allocated_decoding_thread_count; ++i) {
+      vpx_free(pbi->mt_row_tokens[i]);
+      pbi->mt_row_tokens[i] = NULL;
+    }
+    vpx_free(pbi->mt_row_tokens);
+    pbi->mt_row_tokens = NULL;
+  }
+
   /* Free above_row buffers. */
   if (pbi->mt_yabove_row) {
     for (i = 0; i < mb_rows; ++i) {
@@ -751,8 +926,23 @@ void vp8mt_alloc_temp_buffers(VP8D_COMP *pbi, int width, int prev_mb_rows) {
       }
     }
 
+    CHECK_MEM_ERROR(pbi->pcond, vpx_malloc(sizeof(*pbi->pcond) * pc->mb_rows));
+    if (pbi->pcond) {
+      for (i = 0; i < pc->mb_rows; ++i) {
+        pthread_cond_init(&pbi->pcond[i], NULL);
+      }
+    }
+
     /* Allocate an int for each mb row. */
     CALLOC_ARRAY(pbi->mt_current_mb_col, pc->mb_rows);
+    CALLOC_ARRAY(pbi->mt_parsed_mb_col, pc->mb_rows);
+
+    /* Allocate a row of tokens for each thread. */
+    CALLOC_ARRAY(pbi->mt_row_tokens, pbi->allocated_decoding_thread_count + 1);
+    for (i = 0; i <= pbi->allocated_decoding_thread_count; ++i)
+      CHECK_MEM_ERROR(pbi->mt_row_tokens[i],
+                      vpx_memalign(16, sizeof(*pbi->mt_row_tokens[i]) *
+                                           pc->mb_cols));
 
     /* Allocate memory for above_row buffers. */
     CALLOC_ARRAY(pbi->mt_yabove_row, pc->mb_rows);
@@ -799,6 +989,10 @@ void vp8_decoder_remove_threads(VP8D_COMP *pbi) {
 
     /* allow all threads to exit */
     for (i = 0; i < pbi->allocated_decoding_thread_count; ++i) {
+      if (pbi->decoding_workers != NULL) {
+        vpx_get_worker_interface()->end(&pbi->decoding_workers[i]);
+        continue;
+      }
       sem_post(&pbi->h_event_start_decoding[i]);
       pthread_join(pbi->h_decoding_thread[i], NULL);
     }
@@ -823,9 +1017,13 @@ void vp8_decoder_remove_threads(VP8D_COMP *pbi) {
     vpx_free(pbi->de_thread_data);
     pbi->de_thread_data = NULL;
 
+    vpx_free(pbi->decoding_workers);
+    pbi->decoding_workers = NULL;
+
     vp8mt_de_alloc_temp_buffers(pbi, pbi->common.mb_rows);
   }
   pthread_mutex_destroy(&pbi->mt_mutex);
+  pthread_mutex_destroy(&pbi->rows_decoded_mutex);
 }
 
 void vp8mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd) {
@@ -870,11 +1068,57 @@ void vp8mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd) {
   setup_decoding_thread_data(pbi, xd, pbi->mb_row_di,
                              pbi->decoding_thread_count);
 
-  for (i = 0; i < pbi->decoding_thread_count; ++i) {
-    sem_post(&pbi->h_event_start_decoding[i]);
+  if (pbi->decoding_workers != NULL) {
+    /* The rows are interleaved across the threads, so they must all start
+     * together. */
+    vpx_thread_pool_launch(pbi->thread_pool, pbi->decoding_workers,
+                           (int)pbi->decoding_thread_count);
+  } else {
+    for (i = 0; i < pbi->decoding_thread_count; ++i) {
+      sem_post(&pbi->h_event_start_decoding[i]);
+    }
   }
 
   mt_decode_mb_rows(pbi, xd, 0);
 
   sem_wait(&pbi->h_event_end_decoding); /* add back for each frame */
+
+  if (pbi->decoding_workers != NULL) {
+    const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+    for (i = 0; i < pbi->decoding_thread_count; ++i) {
+      winterface->sync(&pbi->decoding_workers[i]);
+    }
+  }
+}
+
+#if CONFIG_POSTPROC
+/* Runs the bands of a postprocessing stage on the decoding threads, the
+ * calling thread taking band 0. */
+void vp8mt_run_pp_stage(void *data, const VP8_PP_STAGE *stage) {
+  VP8D_COMP *const pbi = (VP8D_COMP *)data;
+  const int num_workers = stage->num_bands - 1;
+  int i;
+
+  pbi->mt_pp_stage = stage;
+  if (pbi->decoding_workers != NULL) {
+    vpx_thread_pool_launch(pbi->thread_pool, pbi->decoding_workers,
+                           num_workers);
+  } else {
+    for (i = 0; i < num_workers; ++i) {
+      sem_post(&pbi->h_event_start_decoding[i]);
+    }
+  }
+
+  stage->process_band(stage, 0);
+
+  if (pbi->decoding_workers != NULL) {
+    const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+    for (i = 0; i < num_workers; ++i) {
+      winterface->sync(&pbi->decoding_workers[i]);
+    }
+  } else {
+    for (i = 0; i < num_workers; ++i) sem_wait(&pbi->h_event_end_decoding);
+  }
+  pbi->mt_pp_stage = NULL;
 }
+#endif
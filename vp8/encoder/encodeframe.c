@@ -420,13 +420,13 @@ static void encode_mb_row(VP8_COMP *cpi, VP8_COMMON *cm, int mb_row,
 #if CONFIG_MULTITHREAD
     if (cpi->b_multi_threaded != 0) {
       if (((mb_col - 1) % nsync) == 0) {
-        pthread_mutex_t *mutex = &cpi->pmutex[mb_row];
-        protected_write(mutex, current_mb_col, mb_col - 1);
+        sync_write(&cpi->pmutex[mb_row], &cpi->pcond[mb_row],
+                   current_mb_col, mb_col - 1);
       }
 
       if (mb_row && !(mb_col & (nsync - 1))) {
-        pthread_mutex_t *mutex = &cpi->pmutex[mb_row - 1];
-        sync_read(mutex, mb_col, last_row_current_mb_col, nsync);
+        sync_read(&cpi->pmutex[mb_row - 1], &cpi->pcond[mb_row - 1], mb_col,
+                  last_row_current_mb_col, nsync);
       }
     }
 #endif
@@ -567,7 +567,8 @@ static void encode_mb_row(VP8_COMP *cpi, VP8_COMMON *cm, int mb_row,
 
 #if CONFIG_MULTITHREAD
   if (cpi->b_multi_threaded != 0) {
-    protected_write(&cpi->pmutex[mb_row], current_mb_col, rightmost_col);
+    sync_write(&cpi->pmutex[mb_row], &cpi->pcond[mb_row], current_mb_col,
+               rightmost_col);
   }
 #endif
 
@@ -459,6 +459,17 @@ static void dealloc_compressor_data(VP8_COMP *cpi) {
     cpi->pmutex = NULL;
   }
 
+  if (cpi->pcond != NULL) {
+    VP8_COMMON *const pc = &cpi->common;
+    int i;
+
+    for (i = 0; i < pc->mb_rows; ++i) {
+      pthread_cond_destroy(&cpi->pcond[i]);
+    }
+    vpx_free(cpi->pcond);
+    cpi->pcond = NULL;
+  }
+
   vpx_free(cpi->mt_current_mb_col);
   cpi->mt_current_mb_col = NULL;
 #endif
@@ -1191,6 +1202,14 @@ void vp8_alloc_compressor_data(VP8_COMP *cpi) {
       cpi->pmutex = NULL;
     }
 
+    if (cpi->pcond != NULL) {
+      for (i = 0; i < prev_mb_rows; ++i) {
+        pthread_cond_destroy(&cpi->pcond[i]);
+      }
+      vpx_free(cpi->pcond);
+      cpi->pcond = NULL;
+    }
+
     CHECK_MEM_ERROR(cpi->pmutex,
                     vpx_malloc(sizeof(*cpi->pmutex) * cm->mb_rows));
     if (cpi->pmutex) {
@@ -1199,6 +1218,13 @@ void vp8_alloc_compressor_data(VP8_COMP *cpi) {
       }
     }
 
+    CHECK_MEM_ERROR(cpi->pcond, vpx_malloc(sizeof(*cpi->pcond) * cm->mb_rows));
+    if (cpi->pcond) {
+      for (i = 0; i < cm->mb_rows; ++i) {
+        pthread_cond_init(&cpi->pcond[i], NULL);
+      }
+    }
+
     vpx_free(cpi->mt_current_mb_col);
     CHECK_MEM_ERROR(cpi->mt_current_mb_col,
                     vpx_malloc(sizeof(*cpi->mt_current_mb_col) * cm->mb_rows));
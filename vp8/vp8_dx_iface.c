@@ -54,6 +54,12 @@ struct vpx_codec_alg_priv {
   struct frame_buffers yv12_frame_buffers;
   void *user_priv;
   FRAGMENT_DATA fragments;
+  int skip_loop_filter;
+  int keyframe_only;
+  int downscale_shift;
+  vpx_thread_pool_t *thread_pool;
+  vpx_rows_decoded_cb_fn_t rows_decoded_cb;
+  void *rows_decoded_state;
 };
 
 static int vp8_init_ctx(vpx_codec_ctx_t *ctx) {
@@ -227,6 +233,22 @@ static void yuvconfig2image(vpx_image_t *img, const YV12_BUFFER_CONFIG *yv12,
   img->self_allocd = 0;
 }
 
+/* Passes the rows reported by the decoder on to the application as an
+ * image. */
+static void rows_decoded(void *priv, const YV12_BUFFER_CONFIG *buf,
+                         int row_start, int row_end) {
+  vpx_codec_alg_priv_t *const ctx = (vpx_codec_alg_priv_t *)priv;
+  const VP8_COMMON *const pc = &ctx->yv12_frame_buffers.pbi[0]->common;
+  YV12_BUFFER_CONFIG sd = *buf;
+  vpx_image_t img;
+
+  sd.y_width = pc->Width;
+  sd.y_height = pc->Height;
+  sd.uv_height = (pc->Height + 1) / 2;
+  yuvconfig2image(&img, &sd, ctx->user_priv);
+  ctx->rows_decoded_cb(ctx->rows_decoded_state, &img, row_start, row_end);
+}
+
 static int update_fragments(vpx_codec_alg_priv_t *ctx, const uint8_t *data,
                             unsigned int data_sz, vpx_codec_err_t *res) {
   *res = VPX_CODEC_OK;
@@ -294,6 +316,12 @@ static vpx_codec_err_t vp8_decode(vpx_codec_alg_priv_t *ctx,
     res = VPX_CODEC_OK;
   }
 
+  if (!res && ctx->keyframe_only && !ctx->si.is_kf) {
+    /* Drop the frame without decoding it. */
+    ctx->fragments.count = 0;
+    return VPX_CODEC_OK;
+  }
+
   if (!ctx->decoder_init && !ctx->si.is_kf) res = VPX_CODEC_UNSUP_BITSTREAM;
 
   if ((ctx->si.h != h) || (ctx->si.w != w)) resolution_change = 1;
@@ -307,6 +335,7 @@ static vpx_codec_err_t vp8_decode(vpx_codec_alg_priv_t *ctx,
     oxcf.Version = 9;
     oxcf.postprocess = 0;
     oxcf.max_threads = ctx->cfg.threads;
+    oxcf.thread_pool = ctx->thread_pool;
     oxcf.error_concealment =
         (ctx->base.init_flags & VPX_CODEC_USE_ERROR_CONCEALMENT);
 
@@ -331,6 +360,11 @@ static vpx_codec_err_t vp8_decode(vpx_codec_alg_priv_t *ctx,
   if (ctx->decoder_init) {
     ctx->yv12_frame_buffers.pbi[0]->decrypt_cb = ctx->decrypt_cb;
     ctx->yv12_frame_buffers.pbi[0]->decrypt_state = ctx->decrypt_state;
+    ctx->yv12_frame_buffers.pbi[0]->skip_loop_filter = ctx->skip_loop_filter;
+    ctx->yv12_frame_buffers.pbi[0]->downscale_shift = ctx->downscale_shift;
+    ctx->yv12_frame_buffers.pbi[0]->rows_decoded_cb =
+        ctx->rows_decoded_cb != NULL ? rows_decoded : NULL;
+    ctx->yv12_frame_buffers.pbi[0]->rows_decoded_priv = ctx;
   }
 
   if (!res) {
@@ -628,6 +662,52 @@ static vpx_codec_err_t vp8_set_decryptor(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t vp8_set_skip_loop_filter(vpx_codec_alg_priv_t *ctx,
+                                                va_list args) {
+  ctx->skip_loop_filter = va_arg(args, int);
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t vp8_set_keyframe_only(vpx_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  ctx->keyframe_only = va_arg(args, int);
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t vp8_set_output_downscale(vpx_codec_alg_priv_t *ctx,
+                                                va_list args) {
+  const int factor = va_arg(args, int);
+
+  switch (factor) {
+    case 1: ctx->downscale_shift = 0; break;
+    case 2: ctx->downscale_shift = 1; break;
+    case 4: ctx->downscale_shift = 2; break;
+    case 8: ctx->downscale_shift = 3; break;
+    default: return VPX_CODEC_INVALID_PARAM;
+  }
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t vp8_set_thread_pool(vpx_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  /* The decoding threads are set up with the decoder instance. */
+  if (ctx->decoder_init) {
+    ctx->base.err_detail = "Thread pool must be set before decoding";
+    return VPX_CODEC_ERROR;
+  }
+  ctx->thread_pool = va_arg(args, vpx_thread_pool_t *);
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t vp8_set_rows_decoded_cb(vpx_codec_alg_priv_t *ctx,
+                                               va_list args) {
+  vpx_rows_decoded_init *init = va_arg(args, vpx_rows_decoded_init *);
+
+  ctx->rows_decoded_cb = init ? init->rows_decoded_cb : NULL;
+  ctx->rows_decoded_state = init ? init->rows_decoded_state : NULL;
+  return VPX_CODEC_OK;
+}
+
 vpx_codec_ctrl_fn_map_t vp8_ctf_maps[] = {
   { VP8_SET_REFERENCE, vp8_set_reference },
   { VP8_COPY_REFERENCE, vp8_get_reference },
@@ -637,6 +717,11 @@ vpx_codec_ctrl_fn_map_t vp8_ctf_maps[] = {
   { VP8D_GET_LAST_REF_USED, vp8_get_last_ref_frame },
   { VPXD_GET_LAST_QUANTIZER, vp8_get_quantizer },
   { VPXD_SET_DECRYPTOR, vp8_set_decryptor },
+  { VP9_SET_SKIP_LOOP_FILTER, vp8_set_skip_loop_filter },
+  { VPXD_SET_KEYFRAME_ONLY, vp8_set_keyframe_only },
+  { VPXD_SET_OUTPUT_DOWNSCALE, vp8_set_output_downscale },
+  { VPXD_SET_THREAD_POOL, vp8_set_thread_pool },
+  { VPXD_SET_ROWS_DECODED_CB, vp8_set_rows_decoded_cb },
   { -1, NULL },
 };
 
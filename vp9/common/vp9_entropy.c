@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include "./vp9_rtcd.h"
 #include "vp9/common/vp9_entropy.h"
 #include "vp9/common/vp9_blockd.h"
 #include "vp9/common/vp9_onyxc_int.h"
@@ -1050,6 +1051,15 @@ void vp9_default_coef_probs(VP9_COMMON *cm) {
 #define COEF_COUNT_SAT_AFTER_KEY 24
 #define COEF_MAX_UPDATE_FACTOR_AFTER_KEY 128
 
+void vp9_merge_probs_c(const uint8_t *pre_probs, const unsigned int *counts,
+                       int n, unsigned int count_sat,
+                       unsigned int max_update_factor, uint8_t *probs) {
+  int i;
+  for (i = 0; i < n; ++i)
+    probs[i] = merge_probs(pre_probs[i], &counts[2 * i], count_sat,
+                           max_update_factor);
+}
+
 static void adapt_coef_probs(VP9_COMMON *cm, TX_SIZE tx_size,
                              unsigned int count_sat,
                              unsigned int update_factor) {
@@ -1059,24 +1069,37 @@ static void adapt_coef_probs(VP9_COMMON *cm, TX_SIZE tx_size,
   vp9_coeff_count_model *counts = cm->counts.coef[tx_size];
   unsigned int(*eob_counts)[REF_TYPES][COEF_BANDS][COEFF_CONTEXTS] =
       cm->counts.eob_branch[tx_size];
-  int i, j, k, l, m;
+  // Branch counts laid out like vp9_coeff_probs_model, so that each plane and
+  // reference type can be merged with one batched call.
+  unsigned int branch_ct[COEF_BANDS][COEFF_CONTEXTS][UNCONSTRAINED_NODES][2];
+  const int band0_size = BAND_COEFF_CONTEXTS(0) * UNCONSTRAINED_NODES;
+  const int bands_size =
+      (COEF_BANDS - 1) * COEFF_CONTEXTS * UNCONSTRAINED_NODES;
+  int i, j, k, l;
 
   for (i = 0; i < PLANE_TYPES; ++i)
-    for (j = 0; j < REF_TYPES; ++j)
+    for (j = 0; j < REF_TYPES; ++j) {
       for (k = 0; k < COEF_BANDS; ++k)
         for (l = 0; l < BAND_COEFF_CONTEXTS(k); ++l) {
-          const int n0 = counts[i][j][k][l][ZERO_TOKEN];
-          const int n1 = counts[i][j][k][l][ONE_TOKEN];
-          const int n2 = counts[i][j][k][l][TWO_TOKEN];
-          const int neob = counts[i][j][k][l][EOB_MODEL_TOKEN];
-          const unsigned int branch_ct[UNCONSTRAINED_NODES][2] = {
-            { neob, eob_counts[i][j][k][l] - neob }, { n0, n1 + n2 }, { n1, n2 }
-          };
-          for (m = 0; m < UNCONSTRAINED_NODES; ++m)
-            probs[i][j][k][l][m] =
-                merge_probs(pre_probs[i][j][k][l][m], branch_ct[m], count_sat,
-                            update_factor);
+          const unsigned int n0 = counts[i][j][k][l][ZERO_TOKEN];
+          const unsigned int n1 = counts[i][j][k][l][ONE_TOKEN];
+          const unsigned int n2 = counts[i][j][k][l][TWO_TOKEN];
+          const unsigned int neob = counts[i][j][k][l][EOB_MODEL_TOKEN];
+          unsigned int(*const ct)[2] = branch_ct[k][l];
+          ct[0][0] = neob;
+          ct[0][1] = eob_counts[i][j][k][l] - neob;
+          ct[1][0] = n0;
+          ct[1][1] = n1 + n2;
+          ct[2][0] = n1;
+          ct[2][1] = n2;
         }
+      // Band 0 only uses its first BAND_COEFF_CONTEXTS(0) contexts; the
+      // remaining bands are contiguous.
+      vp9_merge_probs(pre_probs[i][j][0][0], branch_ct[0][0][0], band0_size,
+                      count_sat, update_factor, probs[i][j][0][0]);
+      vp9_merge_probs(pre_probs[i][j][1][0], branch_ct[1][0][0], bands_size,
+                      count_sat, update_factor, probs[i][j][1][0]);
+    }
 }
 
 void vp9_adapt_coef_probs(VP9_COMMON *cm) {
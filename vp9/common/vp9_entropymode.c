@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include "./vp9_rtcd.h"
 #include "vpx_mem/vpx_mem.h"
 
 #include "vp9/common/vp9_onyxc_int.h"
@@ -335,24 +336,25 @@ const vpx_tree_index vp9_switchable_interp_tree[TREE_SIZE(SWITCHABLE_FILTERS)] =
     { -EIGHTTAP, 2, -EIGHTTAP_SMOOTH, -EIGHTTAP_SHARP };
 
 void vp9_adapt_mode_probs(VP9_COMMON *cm) {
-  int i, j;
+  int i;
   FRAME_CONTEXT *fc = cm->fc;
   const FRAME_CONTEXT *pre_fc = &cm->frame_contexts[cm->frame_context_idx];
   const FRAME_COUNTS *counts = &cm->counts;
 
-  for (i = 0; i < INTRA_INTER_CONTEXTS; i++)
-    fc->intra_inter_prob[i] = mode_mv_merge_probs(pre_fc->intra_inter_prob[i],
-                                                  counts->intra_inter[i]);
-  for (i = 0; i < COMP_INTER_CONTEXTS; i++)
-    fc->comp_inter_prob[i] =
-        mode_mv_merge_probs(pre_fc->comp_inter_prob[i], counts->comp_inter[i]);
-  for (i = 0; i < REF_CONTEXTS; i++)
-    fc->comp_ref_prob[i] =
-        mode_mv_merge_probs(pre_fc->comp_ref_prob[i], counts->comp_ref[i]);
-  for (i = 0; i < REF_CONTEXTS; i++)
-    for (j = 0; j < 2; j++)
-      fc->single_ref_prob[i][j] = mode_mv_merge_probs(
-          pre_fc->single_ref_prob[i][j], counts->single_ref[i][j]);
+  // Binary probability arrays run parallel to their [n][2] count arrays and
+  // are merged in batches.
+  vp9_merge_probs(pre_fc->intra_inter_prob, counts->intra_inter[0],
+                  INTRA_INTER_CONTEXTS, MODE_MV_COUNT_SAT,
+                  MODE_MV_MAX_UPDATE_FACTOR, fc->intra_inter_prob);
+  vp9_merge_probs(pre_fc->comp_inter_prob, counts->comp_inter[0],
+                  COMP_INTER_CONTEXTS, MODE_MV_COUNT_SAT,
+                  MODE_MV_MAX_UPDATE_FACTOR, fc->comp_inter_prob);
+  vp9_merge_probs(pre_fc->comp_ref_prob, counts->comp_ref[0], REF_CONTEXTS,
+                  MODE_MV_COUNT_SAT, MODE_MV_MAX_UPDATE_FACTOR,
+                  fc->comp_ref_prob);
+  vp9_merge_probs(pre_fc->single_ref_prob[0], counts->single_ref[0][0],
+                  REF_CONTEXTS * 2, MODE_MV_COUNT_SAT,
+                  MODE_MV_MAX_UPDATE_FACTOR, fc->single_ref_prob[0]);
 
   for (i = 0; i < INTER_MODE_CONTEXTS; i++)
     vpx_tree_merge_probs(vp9_inter_mode_tree, pre_fc->inter_mode_probs[i],
@@ -401,9 +403,8 @@ void vp9_adapt_mode_probs(VP9_COMMON *cm) {
     }
   }
 
-  for (i = 0; i < SKIP_CONTEXTS; ++i)
-    fc->skip_probs[i] =
-        mode_mv_merge_probs(pre_fc->skip_probs[i], counts->skip[i]);
+  vp9_merge_probs(pre_fc->skip_probs, counts->skip[0], SKIP_CONTEXTS,
+                  MODE_MV_COUNT_SAT, MODE_MV_MAX_UPDATE_FACTOR, fc->skip_probs);
 }
 
 static void set_default_lf_deltas(struct loopfilter *lf) {
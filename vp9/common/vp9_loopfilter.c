@@ -454,11 +454,19 @@ static void filter_selectively_horiz(
     uint8_t *s, int pitch, unsigned int mask_16x16, unsigned int mask_8x8,
     unsigned int mask_4x4, unsigned int mask_4x4_int,
     const loop_filter_thresh *lfthr, const uint8_t *lfl) {
+  uint8_t *const s0 = s;
+  const uint8_t *const lfl0 = lfl;
   unsigned int mask;
   int count;
 
-  for (mask = mask_16x16 | mask_8x8 | mask_4x4 | mask_4x4_int; mask;
-       mask >>= count) {
+  // Horizontal edges in different 8 pixel columns do not interact, so all the
+  // block edges of the row are filtered first and the internal 4x4 edges in a
+  // second pass. Two neighbouring internal edges then share one dual call even
+  // when their block edges use different filters. Columns with a 16x16 edge
+  // have no internal edge filtered.
+  mask_4x4_int &= ~mask_16x16;
+
+  for (mask = mask_16x16 | mask_8x8 | mask_4x4; mask; mask >>= count) {
     count = 1;
     if (mask & 1) {
       const loop_filter_thresh *lfi = lfthr + *lfl;
@@ -479,28 +487,11 @@ static void filter_selectively_horiz(
           vpx_lpf_horizontal_8_dual(s, pitch, lfi->mblim, lfi->lim,
                                     lfi->hev_thr, lfin->mblim, lfin->lim,
                                     lfin->hev_thr);
-
-          if ((mask_4x4_int & 3) == 3) {
-            vpx_lpf_horizontal_4_dual(s + 4 * pitch, pitch, lfi->mblim,
-                                      lfi->lim, lfi->hev_thr, lfin->mblim,
-                                      lfin->lim, lfin->hev_thr);
-          } else {
-            if (mask_4x4_int & 1)
-              vpx_lpf_horizontal_4(s + 4 * pitch, pitch, lfi->mblim, lfi->lim,
-                                   lfi->hev_thr);
-            else if (mask_4x4_int & 2)
-              vpx_lpf_horizontal_4(s + 8 + 4 * pitch, pitch, lfin->mblim,
-                                   lfin->lim, lfin->hev_thr);
-          }
           count = 2;
         } else {
           vpx_lpf_horizontal_8(s, pitch, lfi->mblim, lfi->lim, lfi->hev_thr);
-
-          if (mask_4x4_int & 1)
-            vpx_lpf_horizontal_4(s + 4 * pitch, pitch, lfi->mblim, lfi->lim,
-                                 lfi->hev_thr);
         }
-      } else if (mask_4x4 & 1) {
+      } else {
         if ((mask_4x4 & 3) == 3) {
           // Next block's thresholds.
           const loop_filter_thresh *lfin = lfthr + *(lfl + 1);
@@ -508,29 +499,10 @@ static void filter_selectively_horiz(
           vpx_lpf_horizontal_4_dual(s, pitch, lfi->mblim, lfi->lim,
                                     lfi->hev_thr, lfin->mblim, lfin->lim,
                                     lfin->hev_thr);
-          if ((mask_4x4_int & 3) == 3) {
-            vpx_lpf_horizontal_4_dual(s + 4 * pitch, pitch, lfi->mblim,
-                                      lfi->lim, lfi->hev_thr, lfin->mblim,
-                                      lfin->lim, lfin->hev_thr);
-          } else {
-            if (mask_4x4_int & 1)
-              vpx_lpf_horizontal_4(s + 4 * pitch, pitch, lfi->mblim, lfi->lim,
-                                   lfi->hev_thr);
-            else if (mask_4x4_int & 2)
-              vpx_lpf_horizontal_4(s + 8 + 4 * pitch, pitch, lfin->mblim,
-                                   lfin->lim, lfin->hev_thr);
-          }
           count = 2;
         } else {
           vpx_lpf_horizontal_4(s, pitch, lfi->mblim, lfi->lim, lfi->hev_thr);
-
-          if (mask_4x4_int & 1)
-            vpx_lpf_horizontal_4(s + 4 * pitch, pitch, lfi->mblim, lfi->lim,
-                                 lfi->hev_thr);
         }
-      } else {
-        vpx_lpf_horizontal_4(s + 4 * pitch, pitch, lfi->mblim, lfi->lim,
-                             lfi->hev_thr);
       }
     }
     s += 8 * count;
@@ -538,7 +510,28 @@ static void filter_selectively_horiz(
     mask_16x16 >>= count;
     mask_8x8 >>= count;
     mask_4x4 >>= count;
-    mask_4x4_int >>= count;
+  }
+
+  s = s0 + 4 * pitch;
+  lfl = lfl0;
+  for (mask = mask_4x4_int; mask; mask >>= count) {
+    count = 1;
+    if (mask & 1) {
+      const loop_filter_thresh *lfi = lfthr + *lfl;
+
+      if ((mask & 3) == 3) {
+        const loop_filter_thresh *lfin = lfthr + *(lfl + 1);
+
+        vpx_lpf_horizontal_4_dual(s, pitch, lfi->mblim, lfi->lim,
+                                  lfi->hev_thr, lfin->mblim, lfin->lim,
+                                  lfin->hev_thr);
+        count = 2;
+      } else {
+        vpx_lpf_horizontal_4(s, pitch, lfi->mblim, lfi->lim, lfi->hev_thr);
+      }
+    }
+    s += 8 * count;
+    lfl += count;
   }
 }
 
@@ -547,11 +540,15 @@ static void highbd_filter_selectively_horiz(
     uint16_t *s, int pitch, unsigned int mask_16x16, unsigned int mask_8x8,
     unsigned int mask_4x4, unsigned int mask_4x4_int,
     const loop_filter_thresh *lfthr, const uint8_t *lfl, int bd) {
+  uint16_t *const s0 = s;
+  const uint8_t *const lfl0 = lfl;
   unsigned int mask;
   int count;
 
-  for (mask = mask_16x16 | mask_8x8 | mask_4x4 | mask_4x4_int; mask;
-       mask >>= count) {
+  // See filter_selectively_horiz().
+  mask_4x4_int &= ~mask_16x16;
+
+  for (mask = mask_16x16 | mask_8x8 | mask_4x4; mask; mask >>= count) {
     count = 1;
     if (mask & 1) {
       const loop_filter_thresh *lfi = lfthr + *lfl;
@@ -573,31 +570,12 @@ static void highbd_filter_selectively_horiz(
           vpx_highbd_lpf_horizontal_8_dual(s, pitch, lfi->mblim, lfi->lim,
                                            lfi->hev_thr, lfin->mblim, lfin->lim,
                                            lfin->hev_thr, bd);
-
-          if ((mask_4x4_int & 3) == 3) {
-            vpx_highbd_lpf_horizontal_4_dual(
-                s + 4 * pitch, pitch, lfi->mblim, lfi->lim, lfi->hev_thr,
-                lfin->mblim, lfin->lim, lfin->hev_thr, bd);
-          } else {
-            if (mask_4x4_int & 1) {
-              vpx_highbd_lpf_horizontal_4(s + 4 * pitch, pitch, lfi->mblim,
-                                          lfi->lim, lfi->hev_thr, bd);
-            } else if (mask_4x4_int & 2) {
-              vpx_highbd_lpf_horizontal_4(s + 8 + 4 * pitch, pitch, lfin->mblim,
-                                          lfin->lim, lfin->hev_thr, bd);
-            }
-          }
           count = 2;
         } else {
           vpx_highbd_lpf_horizontal_8(s, pitch, lfi->mblim, lfi->lim,
                                       lfi->hev_thr, bd);
-
-          if (mask_4x4_int & 1) {
-            vpx_highbd_lpf_horizontal_4(s + 4 * pitch, pitch, lfi->mblim,
-                                        lfi->lim, lfi->hev_thr, bd);
-          }
         }
-      } else if (mask_4x4 & 1) {
+      } else {
         if ((mask_4x4 & 3) == 3) {
           // Next block's thresholds.
           const loop_filter_thresh *lfin = lfthr + *(lfl + 1);
@@ -605,32 +583,11 @@ static void highbd_filter_selectively_horiz(
           vpx_highbd_lpf_horizontal_4_dual(s, pitch, lfi->mblim, lfi->lim,
                                            lfi->hev_thr, lfin->mblim, lfin->lim,
                                            lfin->hev_thr, bd);
-          if ((mask_4x4_int & 3) == 3) {
-            vpx_highbd_lpf_horizontal_4_dual(
-                s + 4 * pitch, pitch, lfi->mblim, lfi->lim, lfi->hev_thr,
-                lfin->mblim, lfin->lim, lfin->hev_thr, bd);
-          } else {
-            if (mask_4x4_int & 1) {
-              vpx_highbd_lpf_horizontal_4(s + 4 * pitch, pitch, lfi->mblim,
-                                          lfi->lim, lfi->hev_thr, bd);
-            } else if (mask_4x4_int & 2) {
-              vpx_highbd_lpf_horizontal_4(s + 8 + 4 * pitch, pitch, lfin->mblim,
-                                          lfin->lim, lfin->hev_thr, bd);
-            }
-          }
           count = 2;
         } else {
           vpx_highbd_lpf_horizontal_4(s, pitch, lfi->mblim, lfi->lim,
                                       lfi->hev_thr, bd);
-
-          if (mask_4x4_int & 1) {
-            vpx_highbd_lpf_horizontal_4(s + 4 * pitch, pitch, lfi->mblim,
-                                        lfi->lim, lfi->hev_thr, bd);
-          }
         }
-      } else {
-        vpx_highbd_lpf_horizontal_4(s + 4 * pitch, pitch, lfi->mblim, lfi->lim,
-                                    lfi->hev_thr, bd);
       }
     }
     s += 8 * count;
@@ -638,7 +595,29 @@ static void highbd_filter_selectively_horiz(
     mask_16x16 >>= count;
     mask_8x8 >>= count;
     mask_4x4 >>= count;
-    mask_4x4_int >>= count;
+  }
+
+  s = s0 + 4 * pitch;
+  lfl = lfl0;
+  for (mask = mask_4x4_int; mask; mask >>= count) {
+    count = 1;
+    if (mask & 1) {
+      const loop_filter_thresh *lfi = lfthr + *lfl;
+
+      if ((mask & 3) == 3) {
+        const loop_filter_thresh *lfin = lfthr + *(lfl + 1);
+
+        vpx_highbd_lpf_horizontal_4_dual(s, pitch, lfi->mblim, lfi->lim,
+                                         lfi->hev_thr, lfin->mblim, lfin->lim,
+                                         lfin->hev_thr, bd);
+        count = 2;
+      } else {
+        vpx_highbd_lpf_horizontal_4(s, pitch, lfi->mblim, lfi->lim,
+                                    lfi->hev_thr, bd);
+      }
+    }
+    s += 8 * count;
+    lfl += count;
   }
 }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
@@ -87,6 +87,7 @@ struct loopfilter {
 
   LOOP_FILTER_MASK *lfm;
   int lfm_stride;
+  int lfm_alloc_size;
 };
 
 /* assorted loopfilter functions which get used elsewhere */
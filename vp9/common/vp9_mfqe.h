@@ -22,7 +22,9 @@ extern "C" {
 // the motion of the blocks and other conditions such as the SAD of
 // the current block and correlated block, the variance of the block
 // difference, etc.
-void vp9_mfqe(struct VP9Common *cm);
+// Superblock rows are independent, so [mi_row_start, mi_row_end) may be
+// processed concurrently with other bands of the same frame.
+void vp9_mfqe(struct VP9Common *cm, int mi_row_start, int mi_row_end);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <assert.h>
 #include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -122,6 +123,11 @@ void vp9_highbd_mbpost_proc_across_ip_c(uint16_t *src, int pitch, int rows,
     int sumsq = 0;
     int sum = 0;
 
+    // Extend the row so the filter never reads pixels left over from the
+    // previous frame, as vpx_mbpost_proc_across_ip_c() does.
+    for (i = -8; i < 0; i++) s[i] = s[0];
+    for (i = 0; i < 17; i++) s[i + cols] = s[cols - 1];
+
     for (i = -8; i <= 6; i++) {
       sumsq += s[i] * s[i];
       sum += s[i];
@@ -141,7 +147,7 @@ void vp9_highbd_mbpost_proc_across_ip_c(uint16_t *src, int pitch, int rows,
         d[c & 15] = (8 + sum + s[c]) >> 4;
       }
 
-      s[c - 8] = d[(c - 8) & 15];
+      if (c >= 8) s[c - 8] = d[(c - 8) & 15];
     }
 
     s += pitch;
@@ -162,6 +168,10 @@ void vp9_highbd_mbpost_proc_down_c(uint16_t *dst, int pitch, int rows, int cols,
     uint16_t d[16];
     const int16_t *rv2 = rv3 + ((c * 17) & 127);
 
+    // Extend the column the same way.
+    for (i = -8; i < 0; i++) s[i * pitch] = s[0];
+    for (i = 0; i < 17; i++) s[(i + rows) * pitch] = s[(rows - 1) * pitch];
+
     for (i = -8; i <= 6; i++) {
       sumsq += s[i * pitch] * s[i * pitch];
       sum += s[i * pitch];
@@ -176,60 +186,50 @@ void vp9_highbd_mbpost_proc_down_c(uint16_t *dst, int pitch, int rows, int cols,
         d[r & 15] = (rv2[r & 127] + sum + s[0]) >> 4;
       }
 
-      s[-8 * pitch] = d[(r - 8) & 15];
+      if (r >= 8) s[-8 * pitch] = d[(r - 8) & 15];
       s += pitch;
     }
   }
 }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
-static void deblock_and_de_macro_block(YV12_BUFFER_CONFIG *source,
-                                       YV12_BUFFER_CONFIG *post, int q,
-                                       int low_var_thresh, int flag,
-                                       uint8_t *limits) {
-  (void)low_var_thresh;
-  (void)flag;
-#if CONFIG_VP9_HIGHBITDEPTH
-  if (source->flags & YV12_FLAG_HIGHBITDEPTH) {
-    double level = 6.0e-05 * q * q * q - .0067 * q * q + .306 * q + .0065;
-    int ppl = (int)(level + .5);
-    vp9_highbd_post_proc_down_and_across(
-        CONVERT_TO_SHORTPTR(source->y_buffer),
-        CONVERT_TO_SHORTPTR(post->y_buffer), source->y_stride, post->y_stride,
-        source->y_height, source->y_width, ppl);
-
-    vp9_highbd_mbpost_proc_across_ip(CONVERT_TO_SHORTPTR(post->y_buffer),
-                                     post->y_stride, post->y_height,
-                                     post->y_width, q2mbl(q));
+// Postprocessing passes that can be split into bands between workers.
+typedef enum {
+  POSTPROC_MFQE,          // vp9_mfqe() of a band of superblock rows.
+  POSTPROC_DEBLOCK,       // Deblocking of a band of macroblock rows.
+  POSTPROC_DEMACROBLOCK,  // Deblocking and across filter of macroblock rows.
+  POSTPROC_MBPOST_DOWN,   // Down filter of a band of 16 pixel wide columns.
+} POSTPROC_PASS;
+
+typedef struct PostProcWorkerData {
+  VP9_COMMON *cm;
+  const YV12_BUFFER_CONFIG *src;
+  YV12_BUFFER_CONFIG *dst;
+  uint8_t *limits;
+  POSTPROC_PASS pass;
+  int ppl;
+  int flimit;
+  // Band of units (superblock rows, macroblock rows or 16 pixel columns).
+  int start;
+  int stop;
+} PostProcWorkerData;
+
+static int q2ppl(int q) {
+  return (int)(6.0e-05 * q * q * q - 0.0067 * q * q + 0.306 * q + 0.0065 + 0.5);
+}
 
-    vp9_highbd_mbpost_proc_down(CONVERT_TO_SHORTPTR(post->y_buffer),
-                                post->y_stride, post->y_height, post->y_width,
-                                q2mbl(q));
-
-    vp9_highbd_post_proc_down_and_across(
-        CONVERT_TO_SHORTPTR(source->u_buffer),
-        CONVERT_TO_SHORTPTR(post->u_buffer), source->uv_stride, post->uv_stride,
-        source->uv_height, source->uv_width, ppl);
-    vp9_highbd_post_proc_down_and_across(
-        CONVERT_TO_SHORTPTR(source->v_buffer),
-        CONVERT_TO_SHORTPTR(post->v_buffer), source->uv_stride, post->uv_stride,
-        source->uv_height, source->uv_width, ppl);
-  } else {
-#endif  // CONFIG_VP9_HIGHBITDEPTH
-    vp9_deblock(source, post, q, limits);
-    vpx_mbpost_proc_across_ip(post->y_buffer, post->y_stride, post->y_height,
-                              post->y_width, q2mbl(q));
-    vpx_mbpost_proc_down(post->y_buffer, post->y_stride, post->y_height,
-                         post->y_width, q2mbl(q));
+static void set_limits(const YV12_BUFFER_CONFIG *src, uint8_t *limits,
+                       int ppl) {
 #if CONFIG_VP9_HIGHBITDEPTH
-  }
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH) return;
 #endif  // CONFIG_VP9_HIGHBITDEPTH
+  memset(limits, (unsigned char)ppl, 16 * (src->y_width / 16));
 }
 
-void vp9_deblock(const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst, int q,
-                 uint8_t *limits) {
-  const int ppl =
-      (int)(6.0e-05 * q * q * q - 0.0067 * q * q + 0.306 * q + 0.0065 + 0.5);
+// Deblocks macroblock rows [mb_row_start, mb_row_end) of src into dst.
+static void deblock_rows(const YV12_BUFFER_CONFIG *src,
+                         YV12_BUFFER_CONFIG *dst, int ppl, uint8_t *limits,
+                         int mb_row_start, int mb_row_end) {
 #if CONFIG_VP9_HIGHBITDEPTH
   if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
     int i;
@@ -245,19 +245,23 @@ void vp9_deblock(const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst, int q,
     const int dst_strides[3] = { dst->y_stride, dst->uv_stride,
                                  dst->uv_stride };
     for (i = 0; i < MAX_MB_PLANE; ++i) {
+      const int ss_y = i ? src->subsampling_y : 0;
+      const int row_start = (16 * mb_row_start) >> ss_y;
+      const int row_end = VPXMIN((16 * mb_row_end) >> ss_y, src_heights[i]);
+      if (row_end <= row_start) continue;
       vp9_highbd_post_proc_down_and_across(
-          CONVERT_TO_SHORTPTR(srcs[i]), CONVERT_TO_SHORTPTR(dsts[i]),
-          src_strides[i], dst_strides[i], src_heights[i], src_widths[i], ppl);
+          CONVERT_TO_SHORTPTR(srcs[i]) + row_start * src_strides[i],
+          CONVERT_TO_SHORTPTR(dsts[i]) + row_start * dst_strides[i],
+          src_strides[i], dst_strides[i], row_end - row_start, src_widths[i],
+          ppl);
     }
   } else {
 #endif  // CONFIG_VP9_HIGHBITDEPTH
     int mbr;
-    const int mb_rows = src->y_height / 16;
-    const int mb_cols = src->y_width / 16;
+    const int mb_rows = VPXMIN(mb_row_end, src->y_height / 16);
+    (void)ppl;
 
-    memset(limits, (unsigned char)ppl, 16 * mb_cols);
-
-    for (mbr = 0; mbr < mb_rows; mbr++) {
+    for (mbr = mb_row_start; mbr < mb_rows; mbr++) {
       vpx_post_proc_down_and_across_mb_row(
           src->y_buffer + 16 * mbr * src->y_stride,
           dst->y_buffer + 16 * mbr * dst->y_stride, src->y_stride,
@@ -276,6 +280,159 @@ void vp9_deblock(const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst, int q,
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 }
 
+// Deblocks macroblock rows [mb_row_start, mb_row_end) of source into post and
+// runs the across filter on the luma rows. Every row of the filter is
+// independent; the down filter needs the whole height and runs afterwards.
+static void demacroblock_rows(const YV12_BUFFER_CONFIG *source,
+                              YV12_BUFFER_CONFIG *post, int ppl, int flimit,
+                              uint8_t *limits, int mb_row_start,
+                              int mb_row_end) {
+  const int row_start = 16 * mb_row_start;
+  const int row_end = VPXMIN(16 * mb_row_end, post->y_height);
+
+  deblock_rows(source, post, ppl, limits, mb_row_start, mb_row_end);
+  if (row_end <= row_start) return;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (source->flags & YV12_FLAG_HIGHBITDEPTH) {
+    vp9_highbd_mbpost_proc_across_ip(
+        CONVERT_TO_SHORTPTR(post->y_buffer) + row_start * post->y_stride,
+        post->y_stride, row_end - row_start, post->y_width, flimit);
+    return;
+  }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  vpx_mbpost_proc_across_ip(post->y_buffer + row_start * post->y_stride,
+                            post->y_stride, row_end - row_start, post->y_width,
+                            flimit);
+}
+
+static int post_proc_worker_hook(PostProcWorkerData *const data,
+                                 void *unused) {
+  (void)unused;
+  switch (data->pass) {
+    case POSTPROC_MFQE:
+      vp9_mfqe(data->cm, data->start * MI_BLOCK_SIZE,
+               VPXMIN(data->stop * MI_BLOCK_SIZE, data->cm->mi_rows));
+      break;
+    case POSTPROC_DEBLOCK:
+      deblock_rows(data->src, data->dst, data->ppl, data->limits, data->start,
+                   data->stop);
+      break;
+    case POSTPROC_DEMACROBLOCK:
+      demacroblock_rows(data->src, data->dst, data->ppl, data->flimit,
+                        data->limits, data->start, data->stop);
+      break;
+    case POSTPROC_MBPOST_DOWN: {
+      // Columns are filtered independently; bands stay multiples of 16 wide
+      // so the SIMD versions never straddle two bands.
+      YV12_BUFFER_CONFIG *const post = data->dst;
+      const int col_start = 16 * data->start;
+      const int col_end = VPXMIN(16 * data->stop, post->y_width);
+      vpx_mbpost_proc_down(post->y_buffer + col_start, post->y_stride,
+                           post->y_height, col_end - col_start, data->flimit);
+      break;
+    }
+    default: assert(0);
+  }
+  return 1;
+}
+
+// Runs the pass over num_units units, splitting them into one band per
+// worker. The last band runs on the calling thread, so workers[n - 1] does
+// not need a thread of its own.
+static void post_proc_mt(VP9_COMMON *cm, const PostProcWorkerData *pass,
+                         int num_units, VPxWorker *workers, int num_workers) {
+  struct postproc_state *const ppstate = &cm->postproc_state;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const int num_bands = VPXMIN(num_workers, num_units);
+  int i;
+
+  if (num_bands > 1 && num_bands > ppstate->num_worker_data) {
+    vpx_free(ppstate->worker_data);
+    ppstate->worker_data =
+        vpx_malloc(num_bands * sizeof(*ppstate->worker_data));
+    ppstate->num_worker_data = ppstate->worker_data ? num_bands : 0;
+  }
+
+  if (num_bands <= 1 || ppstate->worker_data == NULL) {
+    PostProcWorkerData data = *pass;
+    data.start = 0;
+    data.stop = num_units;
+    post_proc_worker_hook(&data, NULL);
+    return;
+  }
+
+  for (i = 0; i < num_bands; ++i) {
+    VPxWorker *const worker = &workers[i];
+    PostProcWorkerData *const data = &ppstate->worker_data[i];
+    *data = *pass;
+    data->start = num_units * i / num_bands;
+    data->stop = num_units * (i + 1) / num_bands;
+    worker->hook = (VPxWorkerHook)post_proc_worker_hook;
+    worker->data1 = data;
+    worker->data2 = NULL;
+    if (i == num_bands - 1) {
+      winterface->execute(worker);
+    } else {
+      winterface->launch(worker);
+    }
+  }
+
+  for (i = 0; i < num_bands - 1; ++i) winterface->sync(&workers[i]);
+}
+
+static void init_pass(PostProcWorkerData *pass, VP9_COMMON *cm,
+                      POSTPROC_PASS type, const YV12_BUFFER_CONFIG *src,
+                      YV12_BUFFER_CONFIG *dst, int q) {
+  pass->cm = cm;
+  pass->src = src;
+  pass->dst = dst;
+  pass->limits = cm->postproc_state.limits;
+  pass->pass = type;
+  pass->ppl = q2ppl(q);
+  pass->flimit = q2mbl(q);
+  pass->start = 0;
+  pass->stop = 0;
+}
+
+static void deblock_and_de_macro_block(VP9_COMMON *cm,
+                                       const YV12_BUFFER_CONFIG *source,
+                                       YV12_BUFFER_CONFIG *post, int q,
+                                       VPxWorker *workers, int num_workers) {
+  PostProcWorkerData pass;
+  init_pass(&pass, cm, POSTPROC_DEMACROBLOCK, source, post, q);
+  set_limits(source, pass.limits, pass.ppl);
+  post_proc_mt(cm, &pass, (source->y_height + 15) / 16, workers, num_workers);
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (source->flags & YV12_FLAG_HIGHBITDEPTH) {
+    // The high bitdepth down filter picks its dither offset with rand() on
+    // every call, so it is not split to keep the output unchanged.
+    vp9_highbd_mbpost_proc_down(CONVERT_TO_SHORTPTR(post->y_buffer),
+                                post->y_stride, post->y_height, post->y_width,
+                                pass.flimit);
+    return;
+  }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  pass.pass = POSTPROC_MBPOST_DOWN;
+  post_proc_mt(cm, &pass, (post->y_width + 15) / 16, workers, num_workers);
+}
+
+static void deblock_mt(VP9_COMMON *cm, const YV12_BUFFER_CONFIG *src,
+                       YV12_BUFFER_CONFIG *dst, int q, VPxWorker *workers,
+                       int num_workers) {
+  PostProcWorkerData pass;
+  init_pass(&pass, cm, POSTPROC_DEBLOCK, src, dst, q);
+  set_limits(src, pass.limits, pass.ppl);
+  post_proc_mt(cm, &pass, (src->y_height + 15) / 16, workers, num_workers);
+}
+
+void vp9_deblock(const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst, int q,
+                 uint8_t *limits) {
+  const int ppl = q2ppl(q);
+  set_limits(src, limits, ppl);
+  deblock_rows(src, dst, ppl, limits, 0, (src->y_height + 15) / 16);
+}
+
 void vp9_denoise(const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst, int q,
                  uint8_t *limits) {
   vp9_deblock(src, dst, q, limits);
@@ -293,7 +450,8 @@ static void swap_mi_and_prev_mi(VP9_COMMON *cm) {
 }
 
 int vp9_post_proc_frame(struct VP9Common *cm, YV12_BUFFER_CONFIG *dest,
-                        vp9_ppflags_t *ppflags) {
+                        vp9_ppflags_t *ppflags, VPxWorker *workers,
+                        int num_workers) {
   const int q = VPXMIN(105, cm->lf.filter_level * 2);
   const int flags = ppflags->post_proc_flag;
   YV12_BUFFER_CONFIG *const ppbuf = &cm->post_proc_buffer;
@@ -375,7 +533,10 @@ int vp9_post_proc_frame(struct VP9Common *cm, YV12_BUFFER_CONFIG *dest,
       ppstate->last_frame_valid && cm->bit_depth == 8 &&
       ppstate->last_base_qindex <= last_q_thresh &&
       cm->base_qindex - ppstate->last_base_qindex >= q_diff_thresh) {
-    vp9_mfqe(cm);
+    PostProcWorkerData pass;
+    init_pass(&pass, cm, POSTPROC_MFQE, NULL, NULL, q);
+    post_proc_mt(cm, &pass, (cm->mi_rows + MI_BLOCK_SIZE - 1) / MI_BLOCK_SIZE,
+                 workers, num_workers);
     // TODO(jackychen): Consider whether enable deblocking by default
     // if mfqe is enabled. Need to take both the quality and the speed
     // into consideration.
@@ -383,21 +544,21 @@ int vp9_post_proc_frame(struct VP9Common *cm, YV12_BUFFER_CONFIG *dest,
       vp8_yv12_copy_frame(ppbuf, &cm->post_proc_buffer_int);
     }
     if ((flags & VP9D_DEMACROBLOCK) && cm->post_proc_buffer_int.buffer_alloc) {
-      deblock_and_de_macro_block(&cm->post_proc_buffer_int, ppbuf,
-                                 q + (ppflags->deblocking_level - 5) * 10, 1, 0,
-                                 cm->postproc_state.limits);
+      deblock_and_de_macro_block(cm, &cm->post_proc_buffer_int, ppbuf,
+                                 q + (ppflags->deblocking_level - 5) * 10,
+                                 workers, num_workers);
     } else if (flags & VP9D_DEBLOCK) {
-      vp9_deblock(&cm->post_proc_buffer_int, ppbuf, q,
-                  cm->postproc_state.limits);
+      deblock_mt(cm, &cm->post_proc_buffer_int, ppbuf, q, workers,
+                 num_workers);
     } else {
       vp8_yv12_copy_frame(&cm->post_proc_buffer_int, ppbuf);
     }
   } else if (flags & VP9D_DEMACROBLOCK) {
-    deblock_and_de_macro_block(cm->frame_to_show, ppbuf,
-                               q + (ppflags->deblocking_level - 5) * 10, 1, 0,
-                               cm->postproc_state.limits);
+    deblock_and_de_macro_block(cm, cm->frame_to_show, ppbuf,
+                               q + (ppflags->deblocking_level - 5) * 10,
+                               workers, num_workers);
   } else if (flags & VP9D_DEBLOCK) {
-    vp9_deblock(cm->frame_to_show, ppbuf, q, cm->postproc_state.limits);
+    deblock_mt(cm, cm->frame_to_show, ppbuf, q, workers, num_workers);
   } else {
     vp8_yv12_copy_frame(cm->frame_to_show, ppbuf);
   }
@@ -42,6 +42,12 @@ add_proto qw/void vp9_filter_by_weight8x8/, "const uint8_t *src, int src_stride,
 specialize qw/vp9_filter_by_weight8x8 sse2 msa/;
 }
 
+#
+# entropy adaptation
+#
+add_proto qw/void vp9_merge_probs/, "const uint8_t *pre_probs, const unsigned int *counts, int n, unsigned int count_sat, unsigned int max_update_factor, uint8_t *probs";
+specialize qw/vp9_merge_probs sse2/;
+
 #
 # dct
 #
@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stddef.h>
+
 #include "./vpx_config.h"
 #include "vpx_dsp/vpx_dsp_common.h"
 #include "vpx_mem/vpx_mem.h"
@@ -84,6 +86,47 @@ static INLINE void sync_write(VP9LfSync *const lf_sync, int r, int c,
 #endif  // CONFIG_MULTITHREAD
 }
 
+static INLINE enum lf_path get_lf_path(
+    const struct macroblockd_plane planes[MAX_MB_PLANE], int y_only) {
+  if (y_only)
+    return LF_PATH_444;
+  else if (planes[1].subsampling_y == 1 && planes[1].subsampling_x == 1)
+    return LF_PATH_420;
+  else if (planes[1].subsampling_y == 0 && planes[1].subsampling_x == 0)
+    return LF_PATH_444;
+  else
+    return LF_PATH_SLOW;
+}
+
+static INLINE void loop_filter_sb(const YV12_BUFFER_CONFIG *const frame_buffer,
+                                  VP9_COMMON *const cm,
+                                  struct macroblockd_plane planes[MAX_MB_PLANE],
+                                  MODE_INFO **const mi, LOOP_FILTER_MASK *lfm,
+                                  int mi_row, int mi_col, int num_planes,
+                                  enum lf_path path) {
+  int plane;
+
+  vp9_setup_dst_planes(planes, frame_buffer, mi_row, mi_col);
+
+  vp9_adjust_mask(cm, mi_row, mi_col, lfm);
+
+  vp9_filter_block_plane_ss00(cm, &planes[0], mi_row, lfm);
+  for (plane = 1; plane < num_planes; ++plane) {
+    switch (path) {
+      case LF_PATH_420:
+        vp9_filter_block_plane_ss11(cm, &planes[plane], mi_row, lfm);
+        break;
+      case LF_PATH_444:
+        vp9_filter_block_plane_ss00(cm, &planes[plane], mi_row, lfm);
+        break;
+      case LF_PATH_SLOW:
+        vp9_filter_block_plane_non420(cm, &planes[plane], mi + mi_col, mi_row,
+                                      mi_col);
+        break;
+    }
+  }
+}
+
 // Implement row loopfiltering for each thread.
 static INLINE void thread_loop_filter_rows(
     const YV12_BUFFER_CONFIG *const frame_buffer, VP9_COMMON *const cm,
@@ -91,16 +134,8 @@ static INLINE void thread_loop_filter_rows(
     int y_only, VP9LfSync *const lf_sync) {
   const int num_planes = y_only ? 1 : MAX_MB_PLANE;
   const int sb_cols = mi_cols_aligned_to_sb(cm->mi_cols) >> MI_BLOCK_SIZE_LOG2;
+  const enum lf_path path = get_lf_path(planes, y_only);
   int mi_row, mi_col;
-  enum lf_path path;
-  if (y_only)
-    path = LF_PATH_444;
-  else if (planes[1].subsampling_y == 1 && planes[1].subsampling_x == 1)
-    path = LF_PATH_420;
-  else if (planes[1].subsampling_y == 0 && planes[1].subsampling_x == 0)
-    path = LF_PATH_444;
-  else
-    path = LF_PATH_SLOW;
 
   for (mi_row = start; mi_row < stop;
        mi_row += lf_sync->num_workers * MI_BLOCK_SIZE) {
@@ -110,35 +145,40 @@ static INLINE void thread_loop_filter_rows(
     for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE, ++lfm) {
       const int r = mi_row >> MI_BLOCK_SIZE_LOG2;
       const int c = mi_col >> MI_BLOCK_SIZE_LOG2;
-      int plane;
 
       sync_read(lf_sync, r, c);
 
-      vp9_setup_dst_planes(planes, frame_buffer, mi_row, mi_col);
-
-      vp9_adjust_mask(cm, mi_row, mi_col, lfm);
-
-      vp9_filter_block_plane_ss00(cm, &planes[0], mi_row, lfm);
-      for (plane = 1; plane < num_planes; ++plane) {
-        switch (path) {
-          case LF_PATH_420:
-            vp9_filter_block_plane_ss11(cm, &planes[plane], mi_row, lfm);
-            break;
-          case LF_PATH_444:
-            vp9_filter_block_plane_ss00(cm, &planes[plane], mi_row, lfm);
-            break;
-          case LF_PATH_SLOW:
-            vp9_filter_block_plane_non420(cm, &planes[plane], mi + mi_col,
-                                          mi_row, mi_col);
-            break;
-        }
-      }
+      loop_filter_sb(frame_buffer, cm, planes, mi, lfm, mi_row, mi_col,
+                     num_planes, path);
 
       sync_write(lf_sync, r, c, sb_cols);
     }
   }
 }
 
+void vp9_loop_filter_sb_mt(const YV12_BUFFER_CONFIG *frame_buffer,
+                           VP9_COMMON *cm,
+                           struct macroblockd_plane planes[MAX_MB_PLANE],
+                           int mi_row, int mi_col, int y_only,
+                           VP9LfSync *lf_sync) {
+  const int sb_cols = mi_cols_aligned_to_sb(cm->mi_cols) >> MI_BLOCK_SIZE_LOG2;
+  const int r = mi_row >> MI_BLOCK_SIZE_LOG2;
+  const int c = mi_col >> MI_BLOCK_SIZE_LOG2;
+
+  sync_read(lf_sync, r, c);
+
+  loop_filter_sb(frame_buffer, cm, planes,
+                 cm->mi_grid_visible + mi_row * cm->mi_stride,
+                 get_lfm(&cm->lf, mi_row, mi_col), mi_row, mi_col,
+                 y_only ? 1 : MAX_MB_PLANE, get_lf_path(planes, y_only));
+
+  sync_write(lf_sync, r, c, sb_cols);
+}
+
+void vp9_loop_filter_row_done(VP9LfSync *lf_sync, int sb_row, int sb_cols) {
+  sync_write(lf_sync, sb_row, sb_cols - 1, sb_cols);
+}
+
 // Row-based multi-threaded loopfilter hook
 static int loop_filter_row_worker(VP9LfSync *const lf_sync,
                                   LFWorkerData *const lf_data) {
@@ -308,113 +348,155 @@ void vp9_loop_filter_dealloc(VP9LfSync *lf_sync) {
   }
 }
 
-// Accumulate frame counts.
-void vp9_accumulate_frame_counts(FRAME_COUNTS *accum,
-                                 const FRAME_COUNTS *counts, int is_dec) {
-  int i, j, k, l, m;
-
-  for (i = 0; i < BLOCK_SIZE_GROUPS; i++)
-    for (j = 0; j < INTRA_MODES; j++)
-      accum->y_mode[i][j] += counts->y_mode[i][j];
-
-  for (i = 0; i < INTRA_MODES; i++)
-    for (j = 0; j < INTRA_MODES; j++)
-      accum->uv_mode[i][j] += counts->uv_mode[i][j];
+// Allocate memory for row synchronization
+void vp9_row_mt_sync_mem_alloc(VP9RowMTSync *row_mt_sync, VP9_COMMON *cm,
+                               int rows) {
+  row_mt_sync->rows = rows;
+#if CONFIG_MULTITHREAD
+  {
+    int i;
 
-  for (i = 0; i < PARTITION_CONTEXTS; i++)
-    for (j = 0; j < PARTITION_TYPES; j++)
-      accum->partition[i][j] += counts->partition[i][j];
+    CHECK_MEM_ERROR(cm, row_mt_sync->mutex_,
+                    vpx_malloc(sizeof(*row_mt_sync->mutex_) * rows));
+    if (row_mt_sync->mutex_) {
+      for (i = 0; i < rows; ++i) {
+        pthread_mutex_init(&row_mt_sync->mutex_[i], NULL);
+      }
+    }
 
-  if (is_dec) {
-    int n;
-    for (i = 0; i < TX_SIZES; i++)
-      for (j = 0; j < PLANE_TYPES; j++)
-        for (k = 0; k < REF_TYPES; k++)
-          for (l = 0; l < COEF_BANDS; l++)
-            for (m = 0; m < COEFF_CONTEXTS; m++) {
-              accum->eob_branch[i][j][k][l][m] +=
-                  counts->eob_branch[i][j][k][l][m];
-              for (n = 0; n < UNCONSTRAINED_NODES + 1; n++)
-                accum->coef[i][j][k][l][m][n] += counts->coef[i][j][k][l][m][n];
-            }
-  } else {
-    for (i = 0; i < TX_SIZES; i++)
-      for (j = 0; j < PLANE_TYPES; j++)
-        for (k = 0; k < REF_TYPES; k++)
-          for (l = 0; l < COEF_BANDS; l++)
-            for (m = 0; m < COEFF_CONTEXTS; m++)
-              accum->eob_branch[i][j][k][l][m] +=
-                  counts->eob_branch[i][j][k][l][m];
-    // In the encoder, coef is only updated at frame
-    // level, so not need to accumulate it here.
-    // for (n = 0; n < UNCONSTRAINED_NODES + 1; n++)
-    //   accum->coef[i][j][k][l][m][n] +=
-    //       counts->coef[i][j][k][l][m][n];
+    CHECK_MEM_ERROR(cm, row_mt_sync->cond_,
+                    vpx_malloc(sizeof(*row_mt_sync->cond_) * rows));
+    if (row_mt_sync->cond_) {
+      for (i = 0; i < rows; ++i) {
+        pthread_cond_init(&row_mt_sync->cond_[i], NULL);
+      }
+    }
   }
+#endif  // CONFIG_MULTITHREAD
 
-  for (i = 0; i < SWITCHABLE_FILTER_CONTEXTS; i++)
-    for (j = 0; j < SWITCHABLE_FILTERS; j++)
-      accum->switchable_interp[i][j] += counts->switchable_interp[i][j];
-
-  for (i = 0; i < INTER_MODE_CONTEXTS; i++)
-    for (j = 0; j < INTER_MODES; j++)
-      accum->inter_mode[i][j] += counts->inter_mode[i][j];
-
-  for (i = 0; i < INTRA_INTER_CONTEXTS; i++)
-    for (j = 0; j < 2; j++)
-      accum->intra_inter[i][j] += counts->intra_inter[i][j];
+  CHECK_MEM_ERROR(cm, row_mt_sync->cur_col,
+                  vpx_malloc(sizeof(*row_mt_sync->cur_col) * rows));
 
-  for (i = 0; i < COMP_INTER_CONTEXTS; i++)
-    for (j = 0; j < 2; j++) accum->comp_inter[i][j] += counts->comp_inter[i][j];
+  // Set up nsync.
+  row_mt_sync->sync_range = 1;
+}
 
-  for (i = 0; i < REF_CONTEXTS; i++)
-    for (j = 0; j < 2; j++)
-      for (k = 0; k < 2; k++)
-        accum->single_ref[i][j][k] += counts->single_ref[i][j][k];
+// Deallocate row based multi-threading synchronization related mutex and data
+void vp9_row_mt_sync_mem_dealloc(VP9RowMTSync *row_mt_sync) {
+  if (row_mt_sync != NULL) {
+#if CONFIG_MULTITHREAD
+    int i;
 
-  for (i = 0; i < REF_CONTEXTS; i++)
-    for (j = 0; j < 2; j++) accum->comp_ref[i][j] += counts->comp_ref[i][j];
+    if (row_mt_sync->mutex_ != NULL) {
+      for (i = 0; i < row_mt_sync->rows; ++i) {
+        pthread_mutex_destroy(&row_mt_sync->mutex_[i]);
+      }
+      vpx_free(row_mt_sync->mutex_);
+    }
+    if (row_mt_sync->cond_ != NULL) {
+      for (i = 0; i < row_mt_sync->rows; ++i) {
+        pthread_cond_destroy(&row_mt_sync->cond_[i]);
+      }
+      vpx_free(row_mt_sync->cond_);
+    }
+#endif  // CONFIG_MULTITHREAD
+    vpx_free(row_mt_sync->cur_col);
+    // clear the structure as the source of this call may be dynamic change
+    // in tiles in which case this call will be followed by an _alloc()
+    // which may fail.
+    vp9_zero(*row_mt_sync);
+  }
+}
 
-  for (i = 0; i < TX_SIZE_CONTEXTS; i++) {
-    for (j = 0; j < TX_SIZES; j++)
-      accum->tx.p32x32[i][j] += counts->tx.p32x32[i][j];
+void vp9_row_mt_sync_read(VP9RowMTSync *const row_mt_sync, int r, int c) {
+#if CONFIG_MULTITHREAD
+  const int nsync = row_mt_sync->sync_range;
 
-    for (j = 0; j < TX_SIZES - 1; j++)
-      accum->tx.p16x16[i][j] += counts->tx.p16x16[i][j];
+  if (r && !(c & (nsync - 1))) {
+    pthread_mutex_t *const mutex = &row_mt_sync->mutex_[r - 1];
+    pthread_mutex_lock(mutex);
 
-    for (j = 0; j < TX_SIZES - 2; j++)
-      accum->tx.p8x8[i][j] += counts->tx.p8x8[i][j];
+    while (c > row_mt_sync->cur_col[r - 1] - nsync + 1) {
+      pthread_cond_wait(&row_mt_sync->cond_[r - 1], mutex);
+    }
+    pthread_mutex_unlock(mutex);
   }
+#else
+  (void)row_mt_sync;
+  (void)r;
+  (void)c;
+#endif  // CONFIG_MULTITHREAD
+}
 
-  for (i = 0; i < TX_SIZES; i++)
-    accum->tx.tx_totals[i] += counts->tx.tx_totals[i];
+void vp9_row_mt_sync_read_dummy(VP9RowMTSync *const row_mt_sync, int r, int c) {
+  (void)row_mt_sync;
+  (void)r;
+  (void)c;
+  return;
+}
+
+void vp9_row_mt_sync_write(VP9RowMTSync *const row_mt_sync, int r, int c,
+                           const int cols) {
+#if CONFIG_MULTITHREAD
+  const int nsync = row_mt_sync->sync_range;
+  int cur;
+  // Only signal when there are enough encoded blocks for next row to run.
+  int sig = 1;
 
-  for (i = 0; i < SKIP_CONTEXTS; i++)
-    for (j = 0; j < 2; j++) accum->skip[i][j] += counts->skip[i][j];
+  if (c < cols - 1) {
+    cur = c;
+    if (c % nsync != nsync - 1) sig = 0;
+  } else {
+    cur = cols + nsync;
+  }
 
-  for (i = 0; i < MV_JOINTS; i++) accum->mv.joints[i] += counts->mv.joints[i];
+  if (sig) {
+    pthread_mutex_lock(&row_mt_sync->mutex_[r]);
 
-  for (k = 0; k < 2; k++) {
-    nmv_component_counts *const comps = &accum->mv.comps[k];
-    const nmv_component_counts *const comps_t = &counts->mv.comps[k];
+    row_mt_sync->cur_col[r] = cur;
 
-    for (i = 0; i < 2; i++) {
-      comps->sign[i] += comps_t->sign[i];
-      comps->class0_hp[i] += comps_t->class0_hp[i];
-      comps->hp[i] += comps_t->hp[i];
-    }
+    pthread_cond_signal(&row_mt_sync->cond_[r]);
+    pthread_mutex_unlock(&row_mt_sync->mutex_[r]);
+  }
+#else
+  (void)row_mt_sync;
+  (void)r;
+  (void)c;
+  (void)cols;
+#endif  // CONFIG_MULTITHREAD
+}
 
-    for (i = 0; i < MV_CLASSES; i++) comps->classes[i] += comps_t->classes[i];
+void vp9_row_mt_sync_write_dummy(VP9RowMTSync *const row_mt_sync, int r, int c,
+                                 const int cols) {
+  (void)row_mt_sync;
+  (void)r;
+  (void)c;
+  (void)cols;
+  return;
+}
 
-    for (i = 0; i < CLASS0_SIZE; i++) {
-      comps->class0[i] += comps_t->class0[i];
-      for (j = 0; j < MV_FP_SIZE; j++)
-        comps->class0_fp[i][j] += comps_t->class0_fp[i][j];
-    }
+static void accumulate_counts(unsigned int *accum, const unsigned int *counts,
+                              size_t n) {
+  size_t i;
+  for (i = 0; i < n; ++i) accum[i] += counts[i];
+}
 
-    for (i = 0; i < MV_OFFSET_BITS; i++)
-      for (j = 0; j < 2; j++) comps->bits[i][j] += comps_t->bits[i][j];
+// Accumulate frame counts. FRAME_COUNTS is made up solely of unsigned int
+// arrays, so it is summed as flat runs that the compiler can vectorize.
+void vp9_accumulate_frame_counts(FRAME_COUNTS *accum,
+                                 const FRAME_COUNTS *counts, int is_dec) {
+  unsigned int *const dst = (unsigned int *)accum;
+  const unsigned int *const src = (const unsigned int *)counts;
+  const size_t total = sizeof(*accum) / sizeof(*dst);
 
-    for (i = 0; i < MV_FP_SIZE; i++) comps->fp[i] += comps_t->fp[i];
+  if (is_dec) {
+    accumulate_counts(dst, src, total);
+  } else {
+    const size_t coef_start = offsetof(FRAME_COUNTS, coef) / sizeof(*dst);
+    const size_t coef_end = offsetof(FRAME_COUNTS, eob_branch) / sizeof(*dst);
+    // In the encoder, coef is only updated at frame
+    // level, so not need to accumulate it here.
+    accumulate_counts(dst, src, coef_start);
+    accumulate_counts(dst + coef_end, src + coef_end, total - coef_end);
   }
 }
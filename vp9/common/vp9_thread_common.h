@@ -39,6 +39,19 @@ typedef struct VP9LfSyncData {
   int num_workers;
 } VP9LfSync;
 
+// Row based multi-threading synchronization, shared by the encoder and the
+// decoder.
+typedef struct VP9RowMTSyncData {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *mutex_;
+  pthread_cond_t *cond_;
+#endif
+  // Allocate memory to store the sb/mb block index in each row.
+  int *cur_col;
+  int sync_range;
+  int rows;
+} VP9RowMTSync;
+
 // Allocate memory for loopfilter row synchronization.
 void vp9_loop_filter_alloc(VP9LfSync *lf_sync, struct VP9Common *cm, int rows,
                            int width, int num_workers);
@@ -53,6 +66,32 @@ void vp9_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, struct VP9Common *cm,
                               int partial_frame, VPxWorker *workers,
                               int num_workers, VP9LfSync *lf_sync);
 
+// Loopfilters the superblock at 'mi_row', 'mi_col' once the superblock row
+// above has been filtered far enough, and records the progress of its row.
+void vp9_loop_filter_sb_mt(const YV12_BUFFER_CONFIG *frame_buffer,
+                           struct VP9Common *cm,
+                           struct macroblockd_plane planes[MAX_MB_PLANE],
+                           int mi_row, int mi_col, int y_only,
+                           VP9LfSync *lf_sync);
+
+// Marks the superblock row 'sb_row' as completely filtered.
+void vp9_loop_filter_row_done(VP9LfSync *lf_sync, int sb_row, int sb_cols);
+
+void vp9_row_mt_sync_read(VP9RowMTSync *const row_mt_sync, int r, int c);
+void vp9_row_mt_sync_write(VP9RowMTSync *const row_mt_sync, int r, int c,
+                           const int cols);
+
+void vp9_row_mt_sync_read_dummy(VP9RowMTSync *const row_mt_sync, int r, int c);
+void vp9_row_mt_sync_write_dummy(VP9RowMTSync *const row_mt_sync, int r, int c,
+                                 const int cols);
+
+// Allocate memory for row based multi-threading synchronization.
+void vp9_row_mt_sync_mem_alloc(VP9RowMTSync *row_mt_sync, struct VP9Common *cm,
+                               int rows);
+
+// Deallocate row based multi-threading synchronization related mutex and data.
+void vp9_row_mt_sync_mem_dealloc(VP9RowMTSync *row_mt_sync);
+
 void vp9_accumulate_frame_counts(struct FRAME_COUNTS *accum,
                                  const struct FRAME_COUNTS *counts, int is_dec);
 
@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <emmintrin.h>  // SSE2
+
+#include "./vp9_rtcd.h"
+#include "vpx_dsp/prob.h"
+
+// Converts the low two unsigned 32-bit lanes to double.
+static INLINE __m128d cvt_epu32_pd(__m128i x) {
+  const __m128i bias = _mm_set1_epi32((int)0x80000000u);
+  return _mm_add_pd(_mm_cvtepi32_pd(_mm_xor_si128(x, bias)),
+                    _mm_set1_pd(2147483648.0));
+}
+
+// Computes (num * 256 + den / 2) / den for four lanes, where num <= den. Both
+// operands are below 2^53, so the truncated double quotient is exact.
+static INLINE __m128i div_prob(__m128i num, __m128i den) {
+  const __m128d k256 = _mm_set1_pd(256.0);
+  const __m128i half = _mm_srli_epi32(den, 1);
+  const __m128d a_lo = _mm_add_pd(_mm_mul_pd(cvt_epu32_pd(num), k256),
+                                  _mm_cvtepi32_pd(half));
+  const __m128d a_hi =
+      _mm_add_pd(_mm_mul_pd(cvt_epu32_pd(_mm_srli_si128(num, 8)), k256),
+                 _mm_cvtepi32_pd(_mm_srli_si128(half, 8)));
+  const __m128i q_lo = _mm_cvttpd_epi32(_mm_div_pd(a_lo, cvt_epu32_pd(den)));
+  const __m128i q_hi = _mm_cvttpd_epi32(
+      _mm_div_pd(a_hi, cvt_epu32_pd(_mm_srli_si128(den, 8))));
+  return _mm_unpacklo_epi64(q_lo, q_hi);
+}
+
+void vp9_merge_probs_sse2(const uint8_t *pre_probs, const unsigned int *counts,
+                          int n, unsigned int count_sat,
+                          unsigned int max_update_factor, uint8_t *probs) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one = _mm_set1_epi16(1);
+  const __m128i k255 = _mm_set1_epi16(255);
+  const __m128i k256 = _mm_set1_epi16(256);
+  const __m128i round = _mm_set1_epi16(128);
+  const __m128i bias = _mm_set1_epi32((int)0x80000000u);
+  const __m128i sat = _mm_set1_epi32((int)count_sat);
+  const __m128i sat_biased = _mm_xor_si128(sat, bias);
+  const __m128 sat_ps = _mm_set1_ps((float)count_sat);
+  const __m128 factor_ps = _mm_set1_ps((float)max_update_factor);
+  int i;
+
+  // The update factor is computed in single precision, which is exact as long
+  // as the product below fits in the 24-bit mantissa.
+  assert(count_sat > 0 && count_sat * max_update_factor < (1 << 24));
+  assert(max_update_factor <= 256);
+
+  // Like the C code, this expects n0 + n1 not to overflow.
+  for (i = 0; i + 4 <= n; i += 4) {
+    // { n0, n1 } pairs -> n0 and n1 vectors.
+    const __m128i c01 = _mm_shuffle_epi32(
+        _mm_loadu_si128((const __m128i *)(counts + 2 * i)), 0xd8);
+    const __m128i c23 = _mm_shuffle_epi32(
+        _mm_loadu_si128((const __m128i *)(counts + 2 * i + 4)), 0xd8);
+    const __m128i n0 = _mm_unpacklo_epi64(c01, c23);
+    const __m128i n1 = _mm_unpackhi_epi64(c01, c23);
+    const __m128i den = _mm_add_epi32(n0, n1);
+    // A zero denominator gives a zero update factor, so any nonzero divisor
+    // will do.
+    const __m128i den_nz = _mm_sub_epi32(den, _mm_cmpeq_epi32(den, zero));
+    __m128i prob = div_prob(n0, den_nz);
+    // Unsigned VPXMIN(den, count_sat).
+    const __m128i gt = _mm_cmpgt_epi32(_mm_xor_si128(den, bias), sat_biased);
+    const __m128i count =
+        _mm_or_si128(_mm_and_si128(gt, sat), _mm_andnot_si128(gt, den));
+    const __m128 f =
+        _mm_div_ps(_mm_mul_ps(_mm_cvtepi32_ps(count), factor_ps), sat_ps);
+    __m128i factor = _mm_cvttps_epi32(f);
+    __m128i pre = _mm_cvtsi32_si128(*(const int *)(pre_probs + i));
+    __m128i out;
+
+    prob = _mm_packs_epi32(prob, zero);
+    prob = _mm_min_epi16(_mm_max_epi16(prob, one), k255);
+    factor = _mm_packs_epi32(factor, zero);
+    pre = _mm_unpacklo_epi8(pre, zero);
+
+    // weighted_prob(): the sum is at most 255 * 256 + 128 and fits in 16 bits.
+    out = _mm_add_epi16(_mm_mullo_epi16(pre, _mm_sub_epi16(k256, factor)),
+                        _mm_mullo_epi16(prob, factor));
+    out = _mm_srli_epi16(_mm_add_epi16(out, round), 8);
+    *(int *)(probs + i) = _mm_cvtsi128_si32(_mm_packus_epi16(out, zero));
+  }
+
+  for (; i < n; ++i)
+    probs[i] = merge_probs(pre_probs[i], &counts[2 * i], count_sat,
+                           max_update_factor);
+}
@@ -181,6 +181,22 @@ static void read_mv_probs(nmv_context *ctx, int allow_hp, vpx_reader *r) {
   }
 }
 
+// Zeroes the coefficients of a block read with the default scan order, so the
+// buffer is ready for the next block.
+static INLINE void clear_dqcoeff(tran_low_t *dqcoeff, TX_SIZE tx_size,
+                                 int eob) {
+  if (eob == 1) {
+    dqcoeff[0] = 0;
+  } else {
+    if (tx_size <= TX_16X16 && eob <= 10)
+      memset(dqcoeff, 0, 4 * (4 << tx_size) * sizeof(dqcoeff[0]));
+    else if (tx_size == TX_32X32 && eob <= 34)
+      memset(dqcoeff, 0, 256 * sizeof(dqcoeff[0]));
+    else
+      memset(dqcoeff, 0, (16 << (tx_size << 1)) * sizeof(dqcoeff[0]));
+  }
+}
+
 static void inverse_transform_block_inter(MACROBLOCKD *xd, int plane,
                                           const TX_SIZE tx_size, uint8_t *dst,
                                           int stride, int eob) {
@@ -235,16 +251,7 @@ static void inverse_transform_block_inter(MACROBLOCKD *xd, int plane,
   }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
-  if (eob == 1) {
-    dqcoeff[0] = 0;
-  } else {
-    if (tx_size <= TX_16X16 && eob <= 10)
-      memset(dqcoeff, 0, 4 * (4 << tx_size) * sizeof(dqcoeff[0]));
-    else if (tx_size == TX_32X32 && eob <= 34)
-      memset(dqcoeff, 0, 256 * sizeof(dqcoeff[0]));
-    else
-      memset(dqcoeff, 0, (16 << (tx_size << 1)) * sizeof(dqcoeff[0]));
-  }
+  clear_dqcoeff(dqcoeff, tx_size, eob);
 }
 
 static void inverse_transform_block_intra(MACROBLOCKD *xd, int plane,
@@ -326,13 +333,16 @@ static void predict_and_reconstruct_intra_block(TileWorkerData *twd,
   struct macroblockd_plane *const pd = &xd->plane[plane];
   PREDICTION_MODE mode = (plane == 0) ? mi->mode : mi->uv_mode;
   uint8_t *dst;
+  int64_t start;
   dst = &pd->dst.buf[4 * row * pd->dst.stride + 4 * col];
 
   if (mi->sb_type < BLOCK_8X8)
     if (plane == 0) mode = xd->mi[0]->bmi[(row << 1) + col].as_mode;
 
+  start = dec_perf_start(twd->collect_perf_stats);
   vp9_predict_intra_block(xd, pd->n4_wl, tx_size, mode, dst, pd->dst.stride,
                           dst, pd->dst.stride, col, row, plane);
+  dec_perf_end(twd, DEC_PERF_PREDICTION, start);
 
   if (!mi->skip) {
     const TX_TYPE tx_type =
@@ -343,8 +353,10 @@ static void predict_and_reconstruct_intra_block(TileWorkerData *twd,
     const int eob = vp9_decode_block_tokens(twd, plane, sc, col, row, tx_size,
                                             mi->segment_id);
     if (eob > 0) {
+      start = dec_perf_start(twd->collect_perf_stats);
       inverse_transform_block_intra(xd, plane, tx_type, tx_size, dst,
                                     pd->dst.stride, eob);
+      dec_perf_end(twd, DEC_PERF_INV_TXFM, start);
     }
   }
 }
@@ -359,13 +371,26 @@ static int reconstruct_inter_block(TileWorkerData *twd, MODE_INFO *const mi,
                                           mi->segment_id);
 
   if (eob > 0) {
+    const int64_t start = dec_perf_start(twd->collect_perf_stats);
     inverse_transform_block_inter(
         xd, plane, tx_size, &pd->dst.buf[4 * row * pd->dst.stride + 4 * col],
         pd->dst.stride, eob);
+    dec_perf_end(twd, DEC_PERF_INV_TXFM, start);
   }
   return eob;
 }
 
+// Luma only decoding: the chroma tokens are read to keep the bitstream in sync
+// but the block is not reconstructed.
+static int discard_chroma_block(TileWorkerData *twd, MODE_INFO *const mi,
+                                int plane, int row, int col, TX_SIZE tx_size) {
+  const int eob =
+      vp9_decode_block_tokens(twd, plane, &vp9_default_scan_orders[tx_size],
+                              col, row, tx_size, mi->segment_id);
+  if (eob > 0) clear_dqcoeff(twd->xd.plane[plane].dqcoeff, tx_size, eob);
+  return eob;
+}
+
 static void build_mc_border(const uint8_t *src, int src_stride, uint8_t *dst,
                             int dst_stride, int x, int y, int b_w, int b_h,
                             int w, int h) {
@@ -595,7 +620,7 @@ static void dec_build_inter_predictors(
     // pixels of each superblock row can be changed by next superblock row.
     if (worker != NULL)
       vp9_frameworker_wait(worker, ref_frame_buf, VPXMAX(0, (y1 + 7))
-                                                      << (plane == 0 ? 0 : 1));
+                                                      << pd->subsampling_y);
 
     // Skip border extension if block is inside the frame.
     if (x0 < 0 || x0 > frame_width - 1 || x1 < 0 || x1 > frame_width - 1 ||
@@ -621,7 +646,7 @@ static void dec_build_inter_predictors(
     if (worker != NULL) {
       const int y1 = (y0_16 + (h - 1) * ys) >> SUBPEL_BITS;
       vp9_frameworker_wait(worker, ref_frame_buf, VPXMAX(0, (y1 + 7))
-                                                      << (plane == 0 ? 0 : 1));
+                                                      << pd->subsampling_y);
     }
   }
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -639,6 +664,47 @@ static void dec_build_inter_predictors(
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 }
 
+// Prefetches the reference block read by the unscaled prediction of 'plane',
+// so that it is loaded while the previous plane is predicted. Each row is
+// prefetched at both ends, which covers rows up to a cache line wide.
+static void dec_prefetch_ref_block(const MACROBLOCKD *xd, int plane,
+                                   const RefCntBuffer *ref_frame_buf,
+                                   const struct buf_2d *pre_buf,
+                                   const MV *mv) {
+  const struct macroblockd_plane *const pd = &xd->plane[plane];
+  const YV12_BUFFER_CONFIG *const buf = &ref_frame_buf->buf;
+  const int frame_width = plane == 0 ? buf->y_crop_width : buf->uv_crop_width;
+  const int frame_height =
+      plane == 0 ? buf->y_crop_height : buf->uv_crop_height;
+  const uint8_t *const ref_frame =
+      plane == 0 ? buf->y_buffer : plane == 1 ? buf->u_buffer : buf->v_buffer;
+  const int x = (-xd->mb_to_left_edge >> (3 + pd->subsampling_x)) +
+                ((mv->col * (1 << (1 - pd->subsampling_x))) >> SUBPEL_BITS);
+  const int y = (-xd->mb_to_top_edge >> (3 + pd->subsampling_y)) +
+                ((mv->row * (1 << (1 - pd->subsampling_y))) >> SUBPEL_BITS);
+  const int x0 = clamp(x - (VP9_INTERP_EXTEND - 1), 0, frame_width - 1);
+  const int x1 = clamp(x + 4 * pd->n4_w + VP9_INTERP_EXTEND, 0,
+                       frame_width - 1);
+  const int y0 = clamp(y - (VP9_INTERP_EXTEND - 1), 0, frame_height - 1);
+  const int y1 = clamp(y + 4 * pd->n4_h + VP9_INTERP_EXTEND, 0,
+                       frame_height - 1);
+  int row;
+
+  for (row = y0; row <= y1; ++row) {
+    const uint8_t *const src = ref_frame + row * pre_buf->stride;
+#if CONFIG_VP9_HIGHBITDEPTH
+    if (buf->flags & YV12_FLAG_HIGHBITDEPTH) {
+      const uint16_t *const src16 = CONVERT_TO_SHORTPTR(src);
+      VPX_PREFETCH(src16 + x0);
+      VPX_PREFETCH(src16 + x1);
+      continue;
+    }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+    VPX_PREFETCH(src + x0);
+    VPX_PREFETCH(src + x1);
+  }
+}
+
 static void dec_build_inter_predictors_sb(VP9Decoder *const pbi,
                                           MACROBLOCKD *xd, int mi_row,
                                           int mi_col) {
@@ -651,6 +717,7 @@ static void dec_build_inter_predictors_sb(VP9Decoder *const pbi,
   const int is_compound = has_second_ref(mi);
   int ref;
   int is_scaled;
+  const int num_planes = pbi->luma_only ? 1 : MAX_MB_PLANE;
   VPxWorker *const fwo =
       pbi->frame_parallel_decode ? pbi->frame_worker_owner : NULL;
 
@@ -672,7 +739,7 @@ static void dec_build_inter_predictors_sb(VP9Decoder *const pbi,
     xd->block_refs[ref] = ref_buf;
 
     if (sb_type < BLOCK_8X8) {
-      for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+      for (plane = 0; plane < num_planes; ++plane) {
         struct macroblockd_plane *const pd = &xd->plane[plane];
         struct buf_2d *const dst_buf = &pd->dst;
         const int num_4x4_w = pd->n4_w;
@@ -680,20 +747,32 @@ static void dec_build_inter_predictors_sb(VP9Decoder *const pbi,
         const int n4w_x4 = 4 * num_4x4_w;
         const int n4h_x4 = 4 * num_4x4_h;
         struct buf_2d *const pre_buf = &pd->pre[ref];
-        int i = 0, x, y;
-        for (y = 0; y < num_4x4_h; ++y) {
-          for (x = 0; x < num_4x4_w; ++x) {
-            const MV mv = average_split_mvs(pd, mi, ref, i++);
-            dec_build_inter_predictors(fwo, xd, plane, n4w_x4, n4h_x4, 4 * x,
-                                       4 * y, 4, 4, mi_x, mi_y, kernel, sf,
-                                       pre_buf, dst_buf, &mv, ref_frame_buf,
-                                       is_scaled, ref);
+        MV mvs[4];
+        int i, x, y, w = 4, h = 4;
+        for (i = 0; i < num_4x4_w * num_4x4_h; ++i)
+          mvs[i] = average_split_mvs(pd, mi, ref, i);
+        // Unscaled prediction is the same for every pixel of a block, so the
+        // 4x4 blocks sharing a motion vector are predicted together.
+        if (!is_scaled) {
+          if (num_4x4_w == 2 && is_equal_mv(&mvs[0], &mvs[1]) &&
+              (num_4x4_h == 1 || is_equal_mv(&mvs[2], &mvs[3])))
+            w = 8;
+          if (num_4x4_h == 2 && is_equal_mv(&mvs[0], &mvs[num_4x4_w]) &&
+              (num_4x4_w == 1 || is_equal_mv(&mvs[1], &mvs[3])))
+            h = 8;
+        }
+        for (y = 0; y < num_4x4_h; y += h >> 2) {
+          for (x = 0; x < num_4x4_w; x += w >> 2) {
+            dec_build_inter_predictors(
+                fwo, xd, plane, n4w_x4, n4h_x4, 4 * x, 4 * y, w, h, mi_x, mi_y,
+                kernel, sf, pre_buf, dst_buf, &mvs[y * num_4x4_w + x],
+                ref_frame_buf, is_scaled, ref);
           }
         }
       }
     } else {
       const MV mv = mi->mv[ref].as_mv;
-      for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+      for (plane = 0; plane < num_planes; ++plane) {
         struct macroblockd_plane *const pd = &xd->plane[plane];
         struct buf_2d *const dst_buf = &pd->dst;
         const int num_4x4_w = pd->n4_w;
@@ -701,6 +780,9 @@ static void dec_build_inter_predictors_sb(VP9Decoder *const pbi,
         const int n4w_x4 = 4 * num_4x4_w;
         const int n4h_x4 = 4 * num_4x4_h;
         struct buf_2d *const pre_buf = &pd->pre[ref];
+        if (!is_scaled && sb_type >= BLOCK_32X32 && plane + 1 < num_planes)
+          dec_prefetch_ref_block(xd, plane + 1, ref_frame_buf,
+                                 &xd->plane[plane + 1].pre[ref], &mv);
         dec_build_inter_predictors(fwo, xd, plane, n4w_x4, n4h_x4, 0, 0, n4w_x4,
                                    n4h_x4, mi_x, mi_y, kernel, sf, pre_buf,
                                    dst_buf, &mv, ref_frame_buf, is_scaled, ref);
@@ -766,11 +848,13 @@ static void decode_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
   const int bh = 1 << (bhl - 1);
   const int x_mis = VPXMIN(bw, cm->mi_cols - mi_col);
   const int y_mis = VPXMIN(bh, cm->mi_rows - mi_row);
+  const int num_planes = pbi->luma_only ? 1 : MAX_MB_PLANE;
   vpx_reader *r = &twd->bit_reader;
   MACROBLOCKD *const xd = &twd->xd;
 
   MODE_INFO *mi = set_offsets(cm, xd, bsize, mi_row, mi_col, bw, bh, x_mis,
                               y_mis, bwl, bhl);
+  int64_t start;
 
   if (bsize >= BLOCK_8X8 && (cm->subsampling_x || cm->subsampling_y)) {
     const BLOCK_SIZE uv_subsize =
@@ -780,7 +864,9 @@ static void decode_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
                          "Invalid block size.");
   }
 
+  start = dec_perf_start(twd->collect_perf_stats);
   vp9_read_mode_info(twd, pbi, mi_row, mi_col, x_mis, y_mis);
+  dec_perf_end(twd, DEC_PERF_MODE_INFO, start);
 
   if (mi->skip) {
     dec_reset_skip_context(xd);
@@ -809,12 +895,17 @@ static void decode_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
 
       for (row = 0; row < max_blocks_high; row += step)
         for (col = 0; col < max_blocks_wide; col += step)
-          predict_and_reconstruct_intra_block(twd, mi, plane, row, col,
-                                              tx_size);
+          if (plane < num_planes)
+            predict_and_reconstruct_intra_block(twd, mi, plane, row, col,
+                                                tx_size);
+          else if (!mi->skip)
+            discard_chroma_block(twd, mi, plane, row, col, tx_size);
     }
   } else {
     // Prediction
+    start = dec_perf_start(twd->collect_perf_stats);
     dec_build_inter_predictors_sb(pbi, xd, mi_row, mi_col);
+    dec_perf_end(twd, DEC_PERF_PREDICTION, start);
 
     // Reconstruction
     if (!mi->skip) {
@@ -844,7 +935,10 @@ static void decode_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
         for (row = 0; row < max_blocks_high; row += step)
           for (col = 0; col < max_blocks_wide; col += step)
             eobtotal +=
-                reconstruct_inter_block(twd, mi, plane, row, col, tx_size);
+                plane < num_planes
+                    ? reconstruct_inter_block(twd, mi, plane, row, col,
+                                              tx_size)
+                    : discard_chroma_block(twd, mi, plane, row, col, tx_size);
       }
 
       if (!less8x8 && eobtotal == 0) mi->skip = 1;  // skip loopfilter
@@ -964,6 +1058,405 @@ static void decode_partition(TileWorkerData *twd, VP9Decoder *const pbi,
     dec_update_partition_context(twd, mi_row, mi_col, subsize, num_8x8_wh);
 }
 
+// Row based multi-threading: the parse stage reads the modes and the tokens of
+// a block, storing the dequantized coefficients and the eobs so that the block
+// can be reconstructed later by recon_block().
+static void parse_intra_block_row_mt(TileWorkerData *twd, MODE_INFO *const mi,
+                                     int plane, int row, int col,
+                                     TX_SIZE tx_size) {
+  MACROBLOCKD *const xd = &twd->xd;
+  struct macroblockd_plane *const pd = &xd->plane[plane];
+  PREDICTION_MODE mode = (plane == 0) ? mi->mode : mi->uv_mode;
+
+  if (mi->sb_type < BLOCK_8X8)
+    if (plane == 0) mode = xd->mi[0]->bmi[(row << 1) + col].as_mode;
+
+  if (!mi->skip) {
+    const TX_TYPE tx_type =
+        (plane || xd->lossless) ? DCT_DCT : intra_mode_to_tx_type_lookup[mode];
+    const scan_order *sc = (plane || xd->lossless)
+                               ? &vp9_default_scan_orders[tx_size]
+                               : &vp9_scan_orders[tx_size][tx_type];
+    *twd->eob[plane] = vp9_decode_block_tokens(twd, plane, sc, col, row,
+                                               tx_size, mi->segment_id);
+    ++twd->eob[plane];
+    pd->dqcoeff += (16 << (tx_size << 1));
+  }
+}
+
+static int parse_inter_block_row_mt(TileWorkerData *twd, MODE_INFO *const mi,
+                                    int plane, int row, int col,
+                                    TX_SIZE tx_size) {
+  MACROBLOCKD *const xd = &twd->xd;
+  struct macroblockd_plane *const pd = &xd->plane[plane];
+  const scan_order *sc = &vp9_default_scan_orders[tx_size];
+  const int eob = vp9_decode_block_tokens(twd, plane, sc, col, row, tx_size,
+                                          mi->segment_id);
+
+  *twd->eob[plane] = eob;
+  ++twd->eob[plane];
+  pd->dqcoeff += (16 << (tx_size << 1));
+  return eob;
+}
+
+static void parse_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
+                        int mi_col, BLOCK_SIZE bsize, int bwl, int bhl) {
+  VP9_COMMON *const cm = &pbi->common;
+  const int less8x8 = bsize < BLOCK_8X8;
+  const int bw = 1 << (bwl - 1);
+  const int bh = 1 << (bhl - 1);
+  const int x_mis = VPXMIN(bw, cm->mi_cols - mi_col);
+  const int y_mis = VPXMIN(bh, cm->mi_rows - mi_row);
+  vpx_reader *r = &twd->bit_reader;
+  MACROBLOCKD *const xd = &twd->xd;
+
+  MODE_INFO *mi = set_offsets(cm, xd, bsize, mi_row, mi_col, bw, bh, x_mis,
+                              y_mis, bwl, bhl);
+  int64_t start;
+
+  if (bsize >= BLOCK_8X8 && (cm->subsampling_x || cm->subsampling_y)) {
+    const BLOCK_SIZE uv_subsize =
+        ss_size_lookup[bsize][cm->subsampling_x][cm->subsampling_y];
+    if (uv_subsize == BLOCK_INVALID)
+      vpx_internal_error(xd->error_info, VPX_CODEC_CORRUPT_FRAME,
+                         "Invalid block size.");
+  }
+
+  start = dec_perf_start(twd->collect_perf_stats);
+  vp9_read_mode_info(twd, pbi, mi_row, mi_col, x_mis, y_mis);
+  dec_perf_end(twd, DEC_PERF_MODE_INFO, start);
+
+  if (mi->skip) {
+    dec_reset_skip_context(xd);
+  }
+
+  if (!is_inter_block(mi)) {
+    int plane;
+    for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+      const struct macroblockd_plane *const pd = &xd->plane[plane];
+      const TX_SIZE tx_size = plane ? get_uv_tx_size(mi, pd) : mi->tx_size;
+      const int num_4x4_w = pd->n4_w;
+      const int num_4x4_h = pd->n4_h;
+      const int step = (1 << tx_size);
+      int row, col;
+      const int max_blocks_wide =
+          num_4x4_w + (xd->mb_to_right_edge >= 0
+                           ? 0
+                           : xd->mb_to_right_edge >> (5 + pd->subsampling_x));
+      const int max_blocks_high =
+          num_4x4_h + (xd->mb_to_bottom_edge >= 0
+                           ? 0
+                           : xd->mb_to_bottom_edge >> (5 + pd->subsampling_y));
+
+      xd->max_blocks_wide = xd->mb_to_right_edge >= 0 ? 0 : max_blocks_wide;
+      xd->max_blocks_high = xd->mb_to_bottom_edge >= 0 ? 0 : max_blocks_high;
+
+      for (row = 0; row < max_blocks_high; row += step)
+        for (col = 0; col < max_blocks_wide; col += step)
+          parse_intra_block_row_mt(twd, mi, plane, row, col, tx_size);
+    }
+  } else {
+    if (!mi->skip) {
+      tran_low_t *dqcoeff[MAX_MB_PLANE];
+      int *eob[MAX_MB_PLANE];
+      int eobtotal = 0;
+      int plane;
+
+      for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+        dqcoeff[plane] = xd->plane[plane].dqcoeff;
+        eob[plane] = twd->eob[plane];
+      }
+
+      for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+        const struct macroblockd_plane *const pd = &xd->plane[plane];
+        const TX_SIZE tx_size = plane ? get_uv_tx_size(mi, pd) : mi->tx_size;
+        const int num_4x4_w = pd->n4_w;
+        const int num_4x4_h = pd->n4_h;
+        const int step = (1 << tx_size);
+        int row, col;
+        const int max_blocks_wide =
+            num_4x4_w + (xd->mb_to_right_edge >= 0
+                             ? 0
+                             : xd->mb_to_right_edge >> (5 + pd->subsampling_x));
+        const int max_blocks_high =
+            num_4x4_h +
+            (xd->mb_to_bottom_edge >= 0
+                 ? 0
+                 : xd->mb_to_bottom_edge >> (5 + pd->subsampling_y));
+
+        xd->max_blocks_wide = xd->mb_to_right_edge >= 0 ? 0 : max_blocks_wide;
+        xd->max_blocks_high = xd->mb_to_bottom_edge >= 0 ? 0 : max_blocks_high;
+
+        for (row = 0; row < max_blocks_high; row += step)
+          for (col = 0; col < max_blocks_wide; col += step)
+            eobtotal +=
+                parse_inter_block_row_mt(twd, mi, plane, row, col, tx_size);
+      }
+
+      if (!less8x8 && eobtotal == 0) {
+        mi->skip = 1;  // skip loopfilter
+        // Nothing to reconstruct: release the coefficient storage.
+        for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+          xd->plane[plane].dqcoeff = dqcoeff[plane];
+          twd->eob[plane] = eob[plane];
+        }
+      }
+    }
+  }
+
+  xd->corrupted |= vpx_reader_has_error(r);
+
+  if (cm->lf.filter_level) {
+    vp9_build_mask(cm, mi, mi_row, mi_col, bw, bh);
+  }
+}
+
+static void parse_partition(TileWorkerData *twd, VP9Decoder *const pbi,
+                            int mi_row, int mi_col, BLOCK_SIZE bsize,
+                            int n4x4_l2) {
+  VP9_COMMON *const cm = &pbi->common;
+  const int n8x8_l2 = n4x4_l2 - 1;
+  const int num_8x8_wh = 1 << n8x8_l2;
+  const int hbs = num_8x8_wh >> 1;
+  PARTITION_TYPE partition;
+  BLOCK_SIZE subsize;
+  const int has_rows = (mi_row + hbs) < cm->mi_rows;
+  const int has_cols = (mi_col + hbs) < cm->mi_cols;
+  MACROBLOCKD *const xd = &twd->xd;
+
+  if (mi_row >= cm->mi_rows || mi_col >= cm->mi_cols) return;
+
+  partition = read_partition(twd, mi_row, mi_col, has_rows, has_cols, n8x8_l2);
+  *twd->partition++ = partition;
+  subsize = subsize_lookup[partition][bsize];  // get_subsize(bsize, partition);
+  if (!hbs) {
+    // calculate bmode block dimensions (log 2)
+    xd->bmode_blocks_wl = 1 >> !!(partition & PARTITION_VERT);
+    xd->bmode_blocks_hl = 1 >> !!(partition & PARTITION_HORZ);
+    parse_block(twd, pbi, mi_row, mi_col, subsize, 1, 1);
+  } else {
+    switch (partition) {
+      case PARTITION_NONE:
+        parse_block(twd, pbi, mi_row, mi_col, subsize, n4x4_l2, n4x4_l2);
+        break;
+      case PARTITION_HORZ:
+        parse_block(twd, pbi, mi_row, mi_col, subsize, n4x4_l2, n8x8_l2);
+        if (has_rows)
+          parse_block(twd, pbi, mi_row + hbs, mi_col, subsize, n4x4_l2,
+                      n8x8_l2);
+        break;
+      case PARTITION_VERT:
+        parse_block(twd, pbi, mi_row, mi_col, subsize, n8x8_l2, n4x4_l2);
+        if (has_cols)
+          parse_block(twd, pbi, mi_row, mi_col + hbs, subsize, n8x8_l2,
+                      n4x4_l2);
+        break;
+      case PARTITION_SPLIT:
+        parse_partition(twd, pbi, mi_row, mi_col, subsize, n8x8_l2);
+        parse_partition(twd, pbi, mi_row, mi_col + hbs, subsize, n8x8_l2);
+        parse_partition(twd, pbi, mi_row + hbs, mi_col, subsize, n8x8_l2);
+        parse_partition(twd, pbi, mi_row + hbs, mi_col + hbs, subsize,
+                        n8x8_l2);
+        break;
+      default: assert(0 && "Invalid partition type");
+    }
+  }
+
+  // update partition context
+  if (bsize >= BLOCK_8X8 &&
+      (bsize == BLOCK_8X8 || partition != PARTITION_SPLIT))
+    dec_update_partition_context(twd, mi_row, mi_col, subsize, num_8x8_wh);
+}
+
+// Row based multi-threading: the reconstruction stage predicts a block parsed
+// by parse_block() and adds the stored residual.
+static void predict_and_reconstruct_intra_block_row_mt(TileWorkerData *twd,
+                                                       MODE_INFO *const mi,
+                                                       int plane, int row,
+                                                       int col,
+                                                       TX_SIZE tx_size) {
+  MACROBLOCKD *const xd = &twd->xd;
+  struct macroblockd_plane *const pd = &xd->plane[plane];
+  PREDICTION_MODE mode = (plane == 0) ? mi->mode : mi->uv_mode;
+  uint8_t *dst;
+  int64_t start;
+  dst = &pd->dst.buf[4 * row * pd->dst.stride + 4 * col];
+
+  if (mi->sb_type < BLOCK_8X8)
+    if (plane == 0) mode = xd->mi[0]->bmi[(row << 1) + col].as_mode;
+
+  start = dec_perf_start(twd->collect_perf_stats);
+  vp9_predict_intra_block(xd, pd->n4_wl, tx_size, mode, dst, pd->dst.stride,
+                          dst, pd->dst.stride, col, row, plane);
+  dec_perf_end(twd, DEC_PERF_PREDICTION, start);
+
+  if (!mi->skip) {
+    const TX_TYPE tx_type =
+        (plane || xd->lossless) ? DCT_DCT : intra_mode_to_tx_type_lookup[mode];
+    const int eob = *twd->eob[plane]++;
+    if (eob > 0) {
+      start = dec_perf_start(twd->collect_perf_stats);
+      inverse_transform_block_intra(xd, plane, tx_type, tx_size, dst,
+                                    pd->dst.stride, eob);
+      dec_perf_end(twd, DEC_PERF_INV_TXFM, start);
+    }
+    pd->dqcoeff += (16 << (tx_size << 1));
+  }
+}
+
+static void reconstruct_inter_block_row_mt(TileWorkerData *twd, int plane,
+                                           int row, int col, TX_SIZE tx_size) {
+  MACROBLOCKD *const xd = &twd->xd;
+  struct macroblockd_plane *const pd = &xd->plane[plane];
+  const int eob = *twd->eob[plane]++;
+
+  if (eob > 0) {
+    const int64_t start = dec_perf_start(twd->collect_perf_stats);
+    inverse_transform_block_inter(
+        xd, plane, tx_size, &pd->dst.buf[4 * row * pd->dst.stride + 4 * col],
+        pd->dst.stride, eob);
+    dec_perf_end(twd, DEC_PERF_INV_TXFM, start);
+  }
+  pd->dqcoeff += (16 << (tx_size << 1));
+}
+
+static void discard_chroma_block_row_mt(TileWorkerData *twd, int plane,
+                                        TX_SIZE tx_size) {
+  struct macroblockd_plane *const pd = &twd->xd.plane[plane];
+  const int eob = *twd->eob[plane]++;
+
+  if (eob > 0) clear_dqcoeff(pd->dqcoeff, tx_size, eob);
+  pd->dqcoeff += (16 << (tx_size << 1));
+}
+
+static void recon_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
+                        int mi_col, int bwl, int bhl) {
+  VP9_COMMON *const cm = &pbi->common;
+  const int bw = 1 << (bwl - 1);
+  const int bh = 1 << (bhl - 1);
+  const int num_planes = pbi->luma_only ? 1 : MAX_MB_PLANE;
+  MACROBLOCKD *const xd = &twd->xd;
+  MODE_INFO *mi;
+  int64_t start;
+
+  xd->mi = cm->mi_grid_visible + mi_row * cm->mi_stride + mi_col;
+  mi = xd->mi[0];
+  set_plane_n4(xd, bw, bh, bwl, bhl);
+  set_mi_row_col(xd, &xd->tile, mi_row, bh, mi_col, bw, cm->mi_rows,
+                 cm->mi_cols);
+  vp9_setup_dst_planes(xd->plane, get_frame_new_buffer(cm), mi_row, mi_col);
+
+  if (!is_inter_block(mi)) {
+    int plane;
+    for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+      const struct macroblockd_plane *const pd = &xd->plane[plane];
+      const TX_SIZE tx_size = plane ? get_uv_tx_size(mi, pd) : mi->tx_size;
+      const int num_4x4_w = pd->n4_w;
+      const int num_4x4_h = pd->n4_h;
+      const int step = (1 << tx_size);
+      int row, col;
+      const int max_blocks_wide =
+          num_4x4_w + (xd->mb_to_right_edge >= 0
+                           ? 0
+                           : xd->mb_to_right_edge >> (5 + pd->subsampling_x));
+      const int max_blocks_high =
+          num_4x4_h + (xd->mb_to_bottom_edge >= 0
+                           ? 0
+                           : xd->mb_to_bottom_edge >> (5 + pd->subsampling_y));
+
+      xd->max_blocks_wide = xd->mb_to_right_edge >= 0 ? 0 : max_blocks_wide;
+      xd->max_blocks_high = xd->mb_to_bottom_edge >= 0 ? 0 : max_blocks_high;
+
+      for (row = 0; row < max_blocks_high; row += step)
+        for (col = 0; col < max_blocks_wide; col += step)
+          if (plane < num_planes)
+            predict_and_reconstruct_intra_block_row_mt(twd, mi, plane, row,
+                                                       col, tx_size);
+          else if (!mi->skip)
+            discard_chroma_block_row_mt(twd, plane, tx_size);
+    }
+  } else {
+    // Prediction
+    start = dec_perf_start(twd->collect_perf_stats);
+    dec_build_inter_predictors_sb(pbi, xd, mi_row, mi_col);
+    dec_perf_end(twd, DEC_PERF_PREDICTION, start);
+
+    // Reconstruction
+    if (!mi->skip) {
+      int plane;
+
+      for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+        const struct macroblockd_plane *const pd = &xd->plane[plane];
+        const TX_SIZE tx_size = plane ? get_uv_tx_size(mi, pd) : mi->tx_size;
+        const int num_4x4_w = pd->n4_w;
+        const int num_4x4_h = pd->n4_h;
+        const int step = (1 << tx_size);
+        int row, col;
+        const int max_blocks_wide =
+            num_4x4_w + (xd->mb_to_right_edge >= 0
+                             ? 0
+                             : xd->mb_to_right_edge >> (5 + pd->subsampling_x));
+        const int max_blocks_high =
+            num_4x4_h +
+            (xd->mb_to_bottom_edge >= 0
+                 ? 0
+                 : xd->mb_to_bottom_edge >> (5 + pd->subsampling_y));
+
+        xd->max_blocks_wide = xd->mb_to_right_edge >= 0 ? 0 : max_blocks_wide;
+        xd->max_blocks_high = xd->mb_to_bottom_edge >= 0 ? 0 : max_blocks_high;
+
+        for (row = 0; row < max_blocks_high; row += step)
+          for (col = 0; col < max_blocks_wide; col += step)
+            if (plane < num_planes)
+              reconstruct_inter_block_row_mt(twd, plane, row, col, tx_size);
+            else
+              discard_chroma_block_row_mt(twd, plane, tx_size);
+      }
+    }
+  }
+}
+
+static void recon_partition(TileWorkerData *twd, VP9Decoder *const pbi,
+                            int mi_row, int mi_col, int n4x4_l2) {
+  VP9_COMMON *const cm = &pbi->common;
+  const int n8x8_l2 = n4x4_l2 - 1;
+  const int num_8x8_wh = 1 << n8x8_l2;
+  const int hbs = num_8x8_wh >> 1;
+  PARTITION_TYPE partition;
+  const int has_rows = (mi_row + hbs) < cm->mi_rows;
+  const int has_cols = (mi_col + hbs) < cm->mi_cols;
+
+  if (mi_row >= cm->mi_rows || mi_col >= cm->mi_cols) return;
+
+  partition = *twd->partition++;
+  if (!hbs) {
+    recon_block(twd, pbi, mi_row, mi_col, 1, 1);
+  } else {
+    switch (partition) {
+      case PARTITION_NONE:
+        recon_block(twd, pbi, mi_row, mi_col, n4x4_l2, n4x4_l2);
+        break;
+      case PARTITION_HORZ:
+        recon_block(twd, pbi, mi_row, mi_col, n4x4_l2, n8x8_l2);
+        if (has_rows)
+          recon_block(twd, pbi, mi_row + hbs, mi_col, n4x4_l2, n8x8_l2);
+        break;
+      case PARTITION_VERT:
+        recon_block(twd, pbi, mi_row, mi_col, n8x8_l2, n4x4_l2);
+        if (has_cols)
+          recon_block(twd, pbi, mi_row, mi_col + hbs, n8x8_l2, n4x4_l2);
+        break;
+      case PARTITION_SPLIT:
+        recon_partition(twd, pbi, mi_row, mi_col, n8x8_l2);
+        recon_partition(twd, pbi, mi_row, mi_col + hbs, n8x8_l2);
+        recon_partition(twd, pbi, mi_row + hbs, mi_col, n8x8_l2);
+        recon_partition(twd, pbi, mi_row + hbs, mi_col + hbs, n8x8_l2);
+        break;
+      default: assert(0 && "Invalid partition type");
+    }
+  }
+}
+
 static void setup_token_decoder(const uint8_t *data, const uint8_t *data_end,
                                 size_t read_size,
                                 struct vpx_internal_error_info *error_info,
@@ -1137,16 +1630,51 @@ static void setup_render_size(VP9_COMMON *cm, struct vpx_read_bit_buffer *rb) {
     vp9_read_frame_size(rb, &cm->render_width, &cm->render_height);
 }
 
-static void resize_mv_buffer(VP9_COMMON *cm) {
+static void resize_mv_buffer(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  // Grow each dimension to the largest seen so far, and to the frame size
+  // hint, so that switching back and forth between sizes does not reallocate.
+  const int mi_rows =
+      VPXMAX(VPXMAX(cm->mi_rows, pbi->max_mi_rows), cm->cur_frame->mi_rows);
+  const int mi_cols =
+      VPXMAX(VPXMAX(cm->mi_cols, pbi->max_mi_cols), cm->cur_frame->mi_cols);
   vpx_free(cm->cur_frame->mvs);
-  cm->cur_frame->mi_rows = cm->mi_rows;
-  cm->cur_frame->mi_cols = cm->mi_cols;
+  cm->cur_frame->mvs = NULL;
+  cm->cur_frame->mi_rows = 0;
+  cm->cur_frame->mi_cols = 0;
   CHECK_MEM_ERROR(cm, cm->cur_frame->mvs,
-                  (MV_REF *)vpx_calloc(cm->mi_rows * cm->mi_cols,
+                  (MV_REF *)vpx_calloc(mi_rows * mi_cols,
                                        sizeof(*cm->cur_frame->mvs)));
+  cm->cur_frame->mi_rows = mi_rows;
+  cm->cur_frame->mi_cols = mi_cols;
+}
+
+// In serial decode only the motion vectors of the previous frame are read
+// back, so rather than every frame buffer holding an allocation, the current
+// frame takes over the one of a buffer that is neither current nor previous.
+// At most two motion vector buffers are then live. Frame parallel decode keeps
+// one per frame buffer as the other workers may still be reading them.
+static void take_idle_mv_buffer(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
+  int i;
+
+  for (i = 0; i < FRAME_BUFFERS; ++i) {
+    RefCntBuffer *const buf = &frame_bufs[i];
+    if (buf != cm->cur_frame && buf != cm->prev_frame && buf->mvs != NULL) {
+      cm->cur_frame->mvs = buf->mvs;
+      cm->cur_frame->mi_rows = buf->mi_rows;
+      cm->cur_frame->mi_cols = buf->mi_cols;
+      buf->mvs = NULL;
+      buf->mi_rows = 0;
+      buf->mi_cols = 0;
+      return;
+    }
+  }
 }
 
-static void resize_context_buffers(VP9_COMMON *cm, int width, int height) {
+static void resize_context_buffers(VP9Decoder *pbi, int width, int height) {
+  VP9_COMMON *const cm = &pbi->common;
 #if CONFIG_SIZE_LIMIT
   if (width > DECODE_WIDTH_LIMIT || height > DECODE_HEIGHT_LIMIT)
     vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
@@ -1172,17 +1700,20 @@ static void resize_context_buffers(VP9_COMMON *cm, int width, int height) {
     cm->width = width;
     cm->height = height;
   }
+  if (cm->cur_frame->mvs == NULL && !pbi->frame_parallel_decode)
+    take_idle_mv_buffer(pbi);
   if (cm->cur_frame->mvs == NULL || cm->mi_rows > cm->cur_frame->mi_rows ||
       cm->mi_cols > cm->cur_frame->mi_cols) {
-    resize_mv_buffer(cm);
+    resize_mv_buffer(pbi);
   }
 }
 
-static void setup_frame_size(VP9_COMMON *cm, struct vpx_read_bit_buffer *rb) {
+static void setup_frame_size(VP9Decoder *pbi, struct vpx_read_bit_buffer *rb) {
+  VP9_COMMON *const cm = &pbi->common;
   int width, height;
   BufferPool *const pool = cm->buffer_pool;
   vp9_read_frame_size(rb, &width, &height);
-  resize_context_buffers(cm, width, height);
+  resize_context_buffers(pbi, width, height);
   setup_render_size(cm, rb);
 
   lock_buffer_pool(pool);
@@ -1218,8 +1749,9 @@ static INLINE int valid_ref_frame_img_fmt(vpx_bit_depth_t ref_bit_depth,
          ref_yss == this_yss;
 }
 
-static void setup_frame_size_with_refs(VP9_COMMON *cm,
+static void setup_frame_size_with_refs(VP9Decoder *pbi,
                                        struct vpx_read_bit_buffer *rb) {
+  VP9_COMMON *const cm = &pbi->common;
   int width, height;
   int found = 0, i;
   int has_valid_ref_frame = 0;
@@ -1268,7 +1800,7 @@ static void setup_frame_size_with_refs(VP9_COMMON *cm,
                          "Referenced frame has incompatible color format");
   }
 
-  resize_context_buffers(cm, width, height);
+  resize_context_buffers(pbi, width, height);
   setup_render_size(cm, rb);
 
   lock_buffer_pool(pool);
@@ -1362,8 +1894,48 @@ static void get_tile_buffers(VP9Decoder *pbi, const uint8_t *data,
       buf->col = c;
       get_tile_buffer(data_end, is_last, &pbi->common.error, &data,
                       pbi->decrypt_cb, pbi->decrypt_state, buf);
+      if (pbi->collect_perf_stats)
+        pbi->perf_stats.tile_bytes[r][c] = (uint32_t)buf->size;
+    }
+  }
+  if (pbi->collect_perf_stats) {
+    pbi->perf_stats.tile_rows = tile_rows;
+    pbi->perf_stats.tile_cols = tile_cols;
+  }
+}
+
+// Reports the rows above 'mi_row' of the frame being decoded as final. The
+// threaded decoders report from their workers, the ranges are passed to the
+// callback one at a time and in order.
+static void rows_decoded(VP9Decoder *pbi, int mi_row) {
+  VP9_COMMON *const cm = &pbi->common;
+  if (pbi->rows_decoded_cb == NULL) return;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(pbi->rows_decoded_mutex);
+#endif
+  mi_row = VPXMIN(mi_row, cm->mi_rows);
+  if (mi_row > pbi->rows_reported) {
+    const int row_start = pbi->rows_reported * MI_SIZE;
+    const int row_end = VPXMIN(mi_row * MI_SIZE, cm->height);
+    pbi->rows_reported = mi_row;
+    if (row_end > row_start) {
+      pbi->rows_decoded_cb(pbi->rows_decoded_priv, get_frame_new_buffer(cm),
+                           row_start, row_end);
     }
   }
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(pbi->rows_decoded_mutex);
+#endif
+}
+
+// Loop filter worker hook of the single threaded tile decoder.
+static int dec_loop_filter_worker(LFWorkerData *const lf_data,
+                                  VP9Decoder *const pbi) {
+  const int64_t start = dec_perf_start(pbi->collect_perf_stats);
+  vp9_loop_filter_worker(lf_data, NULL);
+  if (pbi->collect_perf_stats)
+    pbi->perf_time[DEC_PERF_LOOP_FILTER] += vpx_nsec_timer_now() - start;
+  return 1;
 }
 
 static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
@@ -1382,7 +1954,9 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
       pbi->lf_worker.data1 == NULL) {
     CHECK_MEM_ERROR(cm, pbi->lf_worker.data1,
                     vpx_memalign(32, sizeof(LFWorkerData)));
-    pbi->lf_worker.hook = (VPxWorkerHook)vp9_loop_filter_worker;
+    pbi->lf_worker.hook = (VPxWorkerHook)dec_loop_filter_worker;
+    pbi->lf_worker.data2 = pbi;
+    pbi->lf_worker.pool = pbi->thread_pool;
     if (pbi->max_threads > 1 && !winterface->reset(&pbi->lf_worker)) {
       vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
                          "Loop filter thread creation failed");
@@ -1395,6 +1969,7 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
     winterface->sync(&pbi->lf_worker);
     vp9_loop_filter_data_reset(lf_data, get_frame_new_buffer(cm), cm,
                                pbi->mb.plane);
+    lf_data->y_only = pbi->luma_only;
   }
 
   assert(tile_rows <= 4);
@@ -1463,6 +2038,9 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
         if (mi_row + MI_BLOCK_SIZE >= cm->mi_rows) continue;
 
         winterface->sync(&pbi->lf_worker);
+        // The last filtered superblock row may still be changed by the
+        // filtering of the next one.
+        rows_decoded(pbi, lf_data->stop - MI_BLOCK_SIZE);
         lf_data->start = lf_start;
         lf_data->stop = mi_row;
         if (pbi->max_threads > 1) {
@@ -1470,6 +2048,8 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
         } else {
           winterface->execute(&pbi->lf_worker);
         }
+      } else {
+        rows_decoded(pbi, mi_row + MI_BLOCK_SIZE);
       }
       // After loopfiltering, the last 7 row pixels in each superblock row may
       // still be changed by the longest loopfilter of the next superblock
@@ -1496,6 +2076,96 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
   return vpx_reader_find_end(&tile_data->bit_reader);
 }
 
+// Per superblock buffers of the threaded decoders are sized for the larger of
+// the current frame and the frame size hint, and are only ever grown.
+static int get_alloc_sb_rows(const VP9Decoder *pbi) {
+  const VP9_COMMON *const cm = &pbi->common;
+  return mi_cols_aligned_to_sb(VPXMAX(cm->mi_rows, pbi->max_mi_rows)) >>
+         MI_BLOCK_SIZE_LOG2;
+}
+
+static int get_alloc_sb_cols(const VP9Decoder *pbi) {
+  const VP9_COMMON *const cm = &pbi->common;
+  return mi_cols_aligned_to_sb(VPXMAX(cm->mi_cols, pbi->max_mi_cols)) >>
+         MI_BLOCK_SIZE_LOG2;
+}
+
+static void loop_filter_sb_mt(TileWorkerData *const tile_data,
+                              VP9Decoder *const pbi, int mi_row, int mi_col) {
+  VP9_COMMON *const cm = &pbi->common;
+  const int64_t start = dec_perf_start(tile_data->collect_perf_stats);
+  vp9_loop_filter_sb_mt(get_frame_new_buffer(cm), cm, tile_data->xd.plane,
+                        mi_row, mi_col, pbi->luma_only, &pbi->lf_row_sync);
+  dec_perf_end(tile_data, DEC_PERF_LOOP_FILTER, start);
+}
+
+static void loop_filter_sb_row_mt(TileWorkerData *const tile_data,
+                                  VP9Decoder *const pbi, int sb_row) {
+  const int mi_row = sb_row << MI_BLOCK_SIZE_LOG2;
+  int mi_col;
+
+  for (mi_col = 0; mi_col < pbi->common.mi_cols; mi_col += MI_BLOCK_SIZE)
+    loop_filter_sb_mt(tile_data, pbi, mi_row, mi_col);
+}
+
+// Records that a tile column has decoded 'sb_row'. Once all the tile columns
+// have, the row above is no longer needed for intra prediction and is loop
+// filtered.
+static void tile_row_decoded(TileWorkerData *const tile_data,
+                             VP9Decoder *const pbi, int sb_row) {
+  VP9_COMMON *const cm = &pbi->common;
+  const int do_lf = cm->lf.filter_level && !cm->skip_loop_filter;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+  int row_done;
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(pbi->tile_cols_decoded_mutex);
+#endif
+  row_done = ++pbi->tile_cols_decoded[sb_row] == tile_cols;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(pbi->tile_cols_decoded_mutex);
+#endif
+  if (!row_done) return;
+
+  if (!do_lf) {
+    rows_decoded(pbi, (sb_row + 1) << MI_BLOCK_SIZE_LOG2);
+    return;
+  }
+  if (sb_row > 0) {
+    loop_filter_sb_row_mt(tile_data, pbi, sb_row - 1);
+    rows_decoded(pbi, (sb_row - 1) << MI_BLOCK_SIZE_LOG2);
+  }
+  if (sb_row == sb_rows - 1) loop_filter_sb_row_mt(tile_data, pbi, sb_row);
+}
+
+// The tile worker hooks accumulate the time they run for in busy_time, from
+// which the time the threads spend idle is derived.
+static void worker_busy_start(TileWorkerData *const tile_data) {
+  if (tile_data->collect_perf_stats)
+    tile_data->busy_time -= vpx_nsec_timer_now();
+}
+
+static void worker_busy_end(TileWorkerData *const tile_data) {
+  if (tile_data->collect_perf_stats)
+    tile_data->busy_time += vpx_nsec_timer_now();
+}
+
+// Adds the time the first 'num_workers' tile workers did not spend in their
+// hook since 'start' to the thread idle time.
+static void record_thread_idle(VP9Decoder *pbi, int num_workers,
+                               int64_t start) {
+  if (pbi->collect_perf_stats) {
+    const int64_t elapsed = vpx_nsec_timer_now() - start;
+    int n;
+    for (n = 0; n < num_workers; ++n) {
+      const TileWorkerData *const tile_data =
+          (const TileWorkerData *)pbi->tile_workers[n].data1;
+      pbi->perf_time[DEC_PERF_THREAD_IDLE] += elapsed - tile_data->busy_time;
+    }
+  }
+}
+
 // On entry 'tile_data->data_end' points to the end of the input frame, on exit
 // it is updated to reflect the bitreader position of the final tile column if
 // present in the tile buffer group or NULL otherwise.
@@ -1503,14 +2173,18 @@ static int tile_worker_hook(TileWorkerData *const tile_data,
                             VP9Decoder *const pbi) {
   TileInfo *volatile tile = &tile_data->xd.tile;
   const int final_col = (1 << pbi->common.log2_tile_cols) - 1;
+  const int do_lf =
+      pbi->common.lf.filter_level && !pbi->common.skip_loop_filter;
   const uint8_t *volatile bit_reader_end = NULL;
   volatile int n = tile_data->buf_start;
+  worker_busy_start(tile_data);
   tile_data->error_info.setjmp = 1;
 
   if (setjmp(tile_data->error_info.jmp)) {
     tile_data->error_info.setjmp = 0;
     tile_data->xd.corrupted = 1;
     tile_data->data_end = NULL;
+    worker_busy_end(tile_data);
     return 0;
   }
 
@@ -1536,6 +2210,8 @@ static int tile_worker_hook(TileWorkerData *const tile_data,
            mi_col += MI_BLOCK_SIZE) {
         decode_partition(tile_data, pbi, mi_row, mi_col, BLOCK_64X64, 4);
       }
+      if ((do_lf || pbi->rows_decoded_cb != NULL) && !tile_data->xd.corrupted)
+        tile_row_decoded(tile_data, pbi, mi_row >> MI_BLOCK_SIZE_LOG2);
     }
 
     if (buf->col == final_col) {
@@ -1544,9 +2220,33 @@ static int tile_worker_hook(TileWorkerData *const tile_data,
   } while (!tile_data->xd.corrupted && ++n <= tile_data->buf_end);
 
   tile_data->data_end = bit_reader_end;
+  worker_busy_end(tile_data);
   return !tile_data->xd.corrupted;
 }
 
+void vp9_create_tile_workers(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+
+  if (pbi->num_tile_workers == 0) {
+    const int num_threads = pbi->max_threads;
+    int n;
+    CHECK_MEM_ERROR(cm, pbi->tile_workers,
+                    vpx_malloc(num_threads * sizeof(*pbi->tile_workers)));
+    for (n = 0; n < num_threads; ++n) {
+      VPxWorker *const worker = &pbi->tile_workers[n];
+      ++pbi->num_tile_workers;
+
+      winterface->init(worker);
+      worker->pool = pbi->thread_pool;
+      if (n < num_threads - 1 && !winterface->reset(worker)) {
+        vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
+                           "Tile decoder thread creation failed");
+      }
+    }
+  }
+}
+
 // sorts in descending order
 static int compare_tile_buffers(const void *a, const void *b) {
   const TileBuffer *const buf1 = (const TileBuffer *)a;
@@ -1563,27 +2263,14 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
   const int tile_cols = 1 << cm->log2_tile_cols;
   const int tile_rows = 1 << cm->log2_tile_rows;
   const int num_workers = VPXMIN(pbi->max_threads, tile_cols);
+  const int do_lf = cm->lf.filter_level && !cm->skip_loop_filter;
   int n;
 
   assert(tile_cols <= (1 << 6));
   assert(tile_rows == 1);
   (void)tile_rows;
 
-  if (pbi->num_tile_workers == 0) {
-    const int num_threads = pbi->max_threads;
-    CHECK_MEM_ERROR(cm, pbi->tile_workers,
-                    vpx_malloc(num_threads * sizeof(*pbi->tile_workers)));
-    for (n = 0; n < num_threads; ++n) {
-      VPxWorker *const worker = &pbi->tile_workers[n];
-      ++pbi->num_tile_workers;
-
-      winterface->init(worker);
-      if (n < num_threads - 1 && !winterface->reset(worker)) {
-        vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
-                           "Tile decoder thread creation failed");
-      }
-    }
-  }
+  vp9_create_tile_workers(pbi);
 
   // Reset tile decoding hook
   for (n = 0; n < num_workers; ++n) {
@@ -1608,6 +2295,40 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
 
   vp9_reset_lfm(cm);
 
+  if (do_lf || pbi->rows_decoded_cb != NULL) {
+    const int sb_rows =
+        mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+    const int alloc_sb_rows = get_alloc_sb_rows(pbi);
+    if (do_lf) {
+      VP9LfSync *const lf_sync = &pbi->lf_row_sync;
+      if (!lf_sync->sync_range || lf_sync->rows < sb_rows) {
+        vp9_loop_filter_dealloc(lf_sync);
+        vp9_loop_filter_alloc(lf_sync, cm, alloc_sb_rows, cm->width,
+                              num_workers);
+      }
+      memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+    }
+
+    if (pbi->tile_cols_decoded_rows < sb_rows) {
+      vpx_free(pbi->tile_cols_decoded);
+      pbi->tile_cols_decoded = NULL;
+      pbi->tile_cols_decoded_rows = 0;
+      CHECK_MEM_ERROR(
+          cm, pbi->tile_cols_decoded,
+          vpx_malloc(alloc_sb_rows * sizeof(*pbi->tile_cols_decoded)));
+      pbi->tile_cols_decoded_rows = alloc_sb_rows;
+    }
+    memset(pbi->tile_cols_decoded, 0,
+           sb_rows * sizeof(*pbi->tile_cols_decoded));
+#if CONFIG_MULTITHREAD
+    if (pbi->tile_cols_decoded_mutex == NULL) {
+      CHECK_MEM_ERROR(cm, pbi->tile_cols_decoded_mutex,
+                      vpx_malloc(sizeof(*pbi->tile_cols_decoded_mutex)));
+      pthread_mutex_init(pbi->tile_cols_decoded_mutex, NULL);
+    }
+#endif
+  }
+
   // Load tile data into tile_buffers
   get_tile_buffers(pbi, data, data_end, tile_cols, tile_rows,
                    &pbi->tile_buffers);
@@ -1652,6 +2373,7 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
   {
     const int base = tile_cols / num_workers;
     const int remain = tile_cols % num_workers;
+    const int64_t start = dec_perf_start(pbi->collect_perf_stats);
     int buf_start = 0;
 
     for (n = 0; n < num_workers; ++n) {
@@ -1683,6 +2405,7 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
       pbi->mb.corrupted |= !winterface->sync(worker);
       if (!bit_reader_end) bit_reader_end = tile_data->data_end;
     }
+    record_thread_idle(pbi, num_workers, start);
   }
 
   // Accumulate thread frame counts.
@@ -1698,6 +2421,373 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
   return bit_reader_end;
 }
 
+static void set_row_mt_sb_buffers(TileWorkerData *const tile_data,
+                                  RowMTWorkerData *const row_mt_worker_data,
+                                  int sb_idx) {
+  int plane;
+  tile_data->partition =
+      row_mt_worker_data->partition + sb_idx * PARTITIONS_PER_SB;
+  for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+    const int shift = plane ? row_mt_worker_data->uv_shift : 0;
+    tile_data->xd.plane[plane].dqcoeff =
+        row_mt_worker_data->dqcoeff[plane] +
+        (sb_idx << (DQCOEFFS_PER_SB_LOG2 - shift));
+    tile_data->eob[plane] =
+        row_mt_worker_data->eob[plane] + (sb_idx << (EOBS_PER_SB_LOG2 - shift));
+  }
+}
+
+// Records that a tile column has been parsed up to the end of 'sb_row', or
+// that parsing failed when 'sb_row' is negative.
+static void signal_parse_progress(RowMTWorkerData *const row_mt_worker_data,
+                                  int sb_row) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&row_mt_worker_data->parse_mutex);
+#endif
+  if (sb_row < 0)
+    row_mt_worker_data->parse_error = 1;
+  else
+    ++row_mt_worker_data->parsed_tile_cols[sb_row];
+#if CONFIG_MULTITHREAD
+  pthread_cond_broadcast(&row_mt_worker_data->parse_cond);
+  pthread_mutex_unlock(&row_mt_worker_data->parse_mutex);
+#endif
+}
+
+// Waits for all the tile columns of 'sb_row' to be parsed. Returns 0 if parsing
+// failed.
+static int wait_for_parse(RowMTWorkerData *const row_mt_worker_data,
+                          int sb_row, int tile_cols) {
+  int parsed;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&row_mt_worker_data->parse_mutex);
+  while (row_mt_worker_data->parsed_tile_cols[sb_row] < tile_cols &&
+         !row_mt_worker_data->parse_error) {
+    pthread_cond_wait(&row_mt_worker_data->parse_cond,
+                      &row_mt_worker_data->parse_mutex);
+  }
+#endif
+  parsed = row_mt_worker_data->parsed_tile_cols[sb_row] == tile_cols;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&row_mt_worker_data->parse_mutex);
+#endif
+  return parsed;
+}
+
+// Parses the tile columns [buf_start, buf_end] over all the tile rows.
+// On entry 'tile_data->data_end' points to the end of the input frame, on exit
+// it is updated to reflect the bitreader position of the final tile if it was
+// parsed by this worker or NULL otherwise.
+static int row_mt_parse_worker_hook(TileWorkerData *const tile_data,
+                                    VP9Decoder *const pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  RowMTWorkerData *const row_mt_worker_data = pbi->row_mt_worker_data;
+  TileInfo *const tile = &tile_data->xd.tile;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  const int sb_cols = mi_cols_aligned_to_sb(cm->mi_cols) >> MI_BLOCK_SIZE_LOG2;
+  const uint8_t *bit_reader_end = NULL;
+  int col, tile_row;
+  worker_busy_start(tile_data);
+  tile_data->error_info.setjmp = 1;
+
+  if (setjmp(tile_data->error_info.jmp)) {
+    tile_data->error_info.setjmp = 0;
+    tile_data->xd.corrupted = 1;
+    tile_data->data_end = NULL;
+    signal_parse_progress(row_mt_worker_data, -1);
+    worker_busy_end(tile_data);
+    return 0;
+  }
+
+  tile_data->xd.corrupted = 0;
+
+  for (col = tile_data->buf_start;
+       col <= tile_data->buf_end && !tile_data->xd.corrupted; ++col) {
+    for (tile_row = 0; tile_row < tile_rows && !tile_data->xd.corrupted;
+         ++tile_row) {
+      const TileBuffer *const buf =
+          &row_mt_worker_data->tile_buffers[tile_row][col];
+      int mi_row, mi_col;
+      vp9_tile_init(tile, cm, tile_row, col);
+      setup_token_decoder(buf->data, tile_data->data_end, buf->size,
+                          &tile_data->error_info, &tile_data->bit_reader,
+                          pbi->decrypt_cb, pbi->decrypt_state);
+      vp9_init_macroblockd(cm, &tile_data->xd, NULL);
+      // init resets xd.error_info
+      tile_data->xd.error_info = &tile_data->error_info;
+
+      for (mi_row = tile->mi_row_start; mi_row < tile->mi_row_end;
+           mi_row += MI_BLOCK_SIZE) {
+        vp9_zero(tile_data->xd.left_context);
+        vp9_zero(tile_data->xd.left_seg_context);
+        for (mi_col = tile->mi_col_start; mi_col < tile->mi_col_end;
+             mi_col += MI_BLOCK_SIZE) {
+          set_row_mt_sb_buffers(tile_data, row_mt_worker_data,
+                                (mi_row >> MI_BLOCK_SIZE_LOG2) * sb_cols +
+                                    (mi_col >> MI_BLOCK_SIZE_LOG2));
+          parse_partition(tile_data, pbi, mi_row, mi_col, BLOCK_64X64, 4);
+        }
+        if (tile_data->xd.corrupted) break;
+        signal_parse_progress(row_mt_worker_data, mi_row >> MI_BLOCK_SIZE_LOG2);
+      }
+
+      if (tile_row == tile_rows - 1 && col == tile_cols - 1) {
+        bit_reader_end = vpx_reader_find_end(&tile_data->bit_reader);
+      }
+    }
+  }
+
+  if (tile_data->xd.corrupted) signal_parse_progress(row_mt_worker_data, -1);
+  tile_data->data_end = bit_reader_end;
+  worker_busy_end(tile_data);
+  return !tile_data->xd.corrupted;
+}
+
+// Reconstructs the superblock rows sb_row_start, sb_row_start + sb_row_step,
+// ... across the width of the frame as soon as they are parsed. Each
+// superblock waits for the one above it to be reconstructed and the
+// superblock row above is loop filtered behind the current one.
+static int row_mt_recon_worker_hook(TileWorkerData *const tile_data,
+                                    VP9Decoder *const pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  RowMTWorkerData *const row_mt_worker_data = pbi->row_mt_worker_data;
+  VP9RowMTSync *const recon_sync = &row_mt_worker_data->recon_sync;
+  VP9LfSync *const lf_sync = &pbi->lf_row_sync;
+  TileInfo *const tile = &tile_data->xd.tile;
+  const int do_lf = cm->lf.filter_level && !cm->skip_loop_filter;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int sb_cols = mi_cols_aligned_to_sb(cm->mi_cols) >> MI_BLOCK_SIZE_LOG2;
+  const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+  volatile int sb_row = tile_data->sb_row_start;
+  worker_busy_start(tile_data);
+  tile_data->error_info.setjmp = 1;
+
+  if (setjmp(tile_data->error_info.jmp)) {
+    tile_data->error_info.setjmp = 0;
+    tile_data->xd.corrupted = 1;
+    // Unblock the workers waiting on the remaining rows of this worker.
+    for (; sb_row < sb_rows; sb_row += tile_data->sb_row_step) {
+      vp9_row_mt_sync_write(recon_sync, sb_row, sb_cols - 1, sb_cols);
+      if (do_lf) {
+        if (sb_row > 0) vp9_loop_filter_row_done(lf_sync, sb_row - 1, sb_cols);
+        if (sb_row == sb_rows - 1)
+          vp9_loop_filter_row_done(lf_sync, sb_row, sb_cols);
+      }
+    }
+    worker_busy_end(tile_data);
+    return 0;
+  }
+
+  tile_data->xd.corrupted = 0;
+  vp9_init_macroblockd(cm, &tile_data->xd, NULL);
+  // init resets xd.error_info
+  tile_data->xd.error_info = &tile_data->error_info;
+
+  for (; sb_row < sb_rows; sb_row += tile_data->sb_row_step) {
+    const int mi_row = sb_row << MI_BLOCK_SIZE_LOG2;
+    int tile_col, mi_col, parsed;
+    int64_t wait_start = dec_perf_start(tile_data->collect_perf_stats);
+
+    parsed = wait_for_parse(row_mt_worker_data, sb_row, tile_cols);
+    dec_perf_end(tile_data, DEC_PERF_THREAD_IDLE, wait_start);
+    if (!parsed)
+      vpx_internal_error(&tile_data->error_info, VPX_CODEC_CORRUPT_FRAME,
+                         "Failed to decode tile data");
+
+    for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
+      vp9_tile_set_col(tile, cm, tile_col);
+      for (mi_col = tile->mi_col_start; mi_col < tile->mi_col_end;
+           mi_col += MI_BLOCK_SIZE) {
+        const int sb_col = mi_col >> MI_BLOCK_SIZE_LOG2;
+        wait_start = dec_perf_start(tile_data->collect_perf_stats);
+        vp9_row_mt_sync_read(recon_sync, sb_row, sb_col);
+        dec_perf_end(tile_data, DEC_PERF_THREAD_IDLE, wait_start);
+        set_row_mt_sb_buffers(tile_data, row_mt_worker_data,
+                              sb_row * sb_cols + sb_col);
+        recon_partition(tile_data, pbi, mi_row, mi_col, 4);
+        vp9_row_mt_sync_write(recon_sync, sb_row, sb_col, sb_cols);
+
+        // The superblock above and to the left is no longer needed for
+        // prediction.
+        if (do_lf && sb_row > 0 && sb_col > 0) {
+          loop_filter_sb_mt(tile_data, pbi, mi_row - MI_BLOCK_SIZE,
+                            mi_col - MI_BLOCK_SIZE);
+        }
+      }
+    }
+
+    if (do_lf) {
+      if (sb_row > 0) {
+        loop_filter_sb_mt(tile_data, pbi, mi_row - MI_BLOCK_SIZE,
+                          (sb_cols - 1) << MI_BLOCK_SIZE_LOG2);
+        rows_decoded(pbi, mi_row - MI_BLOCK_SIZE);
+      }
+      // The last superblock row is filtered by the worker reconstructing it.
+      if (sb_row == sb_rows - 1) loop_filter_sb_row_mt(tile_data, pbi, sb_row);
+    } else {
+      rows_decoded(pbi, mi_row + MI_BLOCK_SIZE);
+    }
+  }
+
+  tile_data->error_info.setjmp = 0;
+  worker_busy_end(tile_data);
+  return 1;
+}
+
+static const uint8_t *decode_tiles_row_mt(VP9Decoder *pbi, const uint8_t *data,
+                                          const uint8_t *data_end) {
+  VP9_COMMON *const cm = &pbi->common;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const uint8_t *bit_reader_end = NULL;
+  const int aligned_mi_cols = mi_cols_aligned_to_sb(cm->mi_cols);
+  const int sb_cols = aligned_mi_cols >> MI_BLOCK_SIZE_LOG2;
+  const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+  const int num_sbs = sb_cols * sb_rows;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  // Split the threads between the two stages; the parse threads are limited by
+  // the number of tile columns.
+  const int num_parse_workers =
+      VPXMIN(tile_cols, VPXMAX(pbi->max_threads / 2, 1));
+#if CONFIG_MULTITHREAD
+  const int num_recon_workers =
+      VPXMIN(pbi->max_threads - num_parse_workers, sb_rows);
+#else
+  // Without threads the workers run one after the other.
+  const int num_recon_workers = 1;
+#endif
+  const int num_workers = num_parse_workers + num_recon_workers;
+  RowMTWorkerData *row_mt_worker_data;
+  int n;
+
+  assert(tile_rows <= 4);
+  assert(tile_cols <= (1 << 6));
+  assert(num_recon_workers > 0);
+
+  vp9_create_tile_workers(pbi);
+
+  if (pbi->row_mt_worker_data == NULL) {
+    CHECK_MEM_ERROR(cm, pbi->row_mt_worker_data,
+                    vpx_calloc(1, sizeof(*pbi->row_mt_worker_data)));
+  }
+  row_mt_worker_data = pbi->row_mt_worker_data;
+  if (row_mt_worker_data->num_sbs < num_sbs ||
+      row_mt_worker_data->recon_sync.rows < sb_rows ||
+      row_mt_worker_data->uv_shift != cm->subsampling_x + cm->subsampling_y) {
+    const int alloc_sb_rows = get_alloc_sb_rows(pbi);
+    const int alloc_sb_cols = get_alloc_sb_cols(pbi);
+    vp9_dec_free_row_mt_mem(row_mt_worker_data);
+    vp9_dec_alloc_row_mt_mem(row_mt_worker_data, cm,
+                             alloc_sb_cols * alloc_sb_rows, alloc_sb_rows);
+  }
+  memset(row_mt_worker_data->recon_sync.cur_col, -1,
+         sizeof(*row_mt_worker_data->recon_sync.cur_col) * sb_rows);
+  memset(row_mt_worker_data->parsed_tile_cols, 0,
+         sizeof(*row_mt_worker_data->parsed_tile_cols) * sb_rows);
+  row_mt_worker_data->parse_error = 0;
+
+  if (cm->lf.filter_level && !cm->skip_loop_filter) {
+    VP9LfSync *const lf_sync = &pbi->lf_row_sync;
+    if (!lf_sync->sync_range || lf_sync->rows < sb_rows) {
+      vp9_loop_filter_dealloc(lf_sync);
+      vp9_loop_filter_alloc(lf_sync, cm, get_alloc_sb_rows(pbi), cm->width,
+                            num_recon_workers);
+    }
+    memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  }
+
+  // Note: this memset assumes above_context[0], [1] and [2]
+  // are allocated as part of the same buffer.
+  memset(cm->above_context, 0,
+         sizeof(*cm->above_context) * MAX_MB_PLANE * 2 * aligned_mi_cols);
+  memset(cm->above_seg_context, 0,
+         sizeof(*cm->above_seg_context) * aligned_mi_cols);
+
+  vp9_reset_lfm(cm);
+
+  get_tile_buffers(pbi, data, data_end, tile_cols, tile_rows,
+                   row_mt_worker_data->tile_buffers);
+
+  // Start the parse threads, then reconstruct behind them.
+  {
+    const int base = tile_cols / num_parse_workers;
+    const int remain = tile_cols % num_parse_workers;
+    const int64_t start = dec_perf_start(pbi->collect_perf_stats);
+    int buf_start = 0;
+
+    for (n = 0; n < num_workers; ++n) {
+      VPxWorker *const worker = &pbi->tile_workers[n];
+      TileWorkerData *const tile_data =
+          &pbi->tile_worker_data[n + pbi->total_tiles];
+
+      winterface->sync(worker);
+      tile_data->xd = pbi->mb;
+      if (n < num_parse_workers) {
+        const int count = base + (remain + n) / num_parse_workers;
+        tile_data->xd.counts =
+            cm->frame_parallel_decoding_mode ? NULL : &tile_data->counts;
+        if (!cm->frame_parallel_decoding_mode) vp9_zero(tile_data->counts);
+        tile_data->buf_start = buf_start;
+        tile_data->buf_end = buf_start + count - 1;
+        tile_data->data_end = data_end;
+        buf_start += count;
+        worker->hook = (VPxWorkerHook)row_mt_parse_worker_hook;
+      } else {
+        tile_data->sb_row_start = n - num_parse_workers;
+        tile_data->sb_row_step = num_recon_workers;
+        worker->hook = (VPxWorkerHook)row_mt_recon_worker_hook;
+      }
+      worker->data1 = tile_data;
+      worker->data2 = pbi;
+      worker->had_error = 0;
+      if (n < num_workers - 1 && pbi->thread_pool == NULL)
+        winterface->launch(worker);
+    }
+    assert(buf_start == tile_cols);
+
+    // The workers wait on each other, so a shared pool must run them all at
+    // the same time.
+    if (pbi->thread_pool != NULL) {
+      vpx_thread_pool_launch(pbi->thread_pool, pbi->tile_workers,
+                             num_workers - 1);
+    }
+    winterface->execute(&pbi->tile_workers[num_workers - 1]);
+
+    for (; n > 0; --n) {
+      VPxWorker *const worker = &pbi->tile_workers[n - 1];
+      TileWorkerData *const tile_data = (TileWorkerData *)worker->data1;
+      pbi->mb.corrupted |= !winterface->sync(worker);
+      if (n <= num_parse_workers && !bit_reader_end)
+        bit_reader_end = tile_data->data_end;
+    }
+    record_thread_idle(pbi, num_workers, start);
+  }
+
+  // Accumulate thread frame counts.
+  if (!cm->frame_parallel_decoding_mode) {
+    for (n = 0; n < num_parse_workers; ++n) {
+      TileWorkerData *const tile_data =
+          (TileWorkerData *)pbi->tile_workers[n].data1;
+      vp9_accumulate_frame_counts(&cm->counts, &tile_data->counts, 1);
+    }
+  }
+
+  if (pbi->mb.corrupted) {
+    // The interrupted stages may have left coefficients behind.
+    int plane;
+    for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+      const int shift = plane ? row_mt_worker_data->uv_shift : 0;
+      memset(row_mt_worker_data->dqcoeff[plane], 0,
+             (row_mt_worker_data->num_sbs << (DQCOEFFS_PER_SB_LOG2 - shift)) *
+                 sizeof(*row_mt_worker_data->dqcoeff[plane]));
+    }
+  }
+
+  assert(bit_reader_end || pbi->mb.corrupted);
+  return bit_reader_end;
+}
+
 static void error_handler(void *data) {
   VP9_COMMON *const cm = (VP9_COMMON *)data;
   vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME, "Truncated packet");
@@ -1747,6 +2837,27 @@ static void read_bitdepth_colorspace_sampling(VP9_COMMON *cm,
   }
 }
 
+// Drops a frame in key frame only decoding. It then goes through the same
+// path as an existing frame being shown, except that nothing is shown: none
+// of the references or the decoder state are updated.
+static size_t drop_frame(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  int i;
+
+  cm->frame_type = cm->last_frame_type;
+  cm->intra_only = cm->last_intra_only;
+  cm->show_existing_frame = 1;
+  cm->show_frame = 0;
+  pbi->refresh_frame_flags = 0;
+  cm->lf.filter_level = 0;
+
+  if (pbi->frame_parallel_decode) {
+    for (i = 0; i < REF_FRAMES; ++i)
+      cm->next_ref_frame_map[i] = cm->ref_frame_map[i];
+  }
+  return 0;
+}
+
 static size_t read_uncompressed_header(VP9Decoder *pbi,
                                        struct vpx_read_bit_buffer *rb) {
   VP9_COMMON *const cm = &pbi->common;
@@ -1776,7 +2887,10 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
   cm->show_existing_frame = vpx_rb_read_bit(rb);
   if (cm->show_existing_frame) {
     // Show an existing frame directly.
-    const int frame_to_show = cm->ref_frame_map[vpx_rb_read_literal(rb, 3)];
+    const int ref = vpx_rb_read_literal(rb, 3);
+    const int frame_to_show = cm->ref_frame_map[ref];
+    if (pbi->keyframe_only && (pbi->stale_ref_frames & (1 << ref)))
+      return drop_frame(pbi);
     lock_buffer_pool(pool);
     if (frame_to_show < 0 || frame_bufs[frame_to_show].ref_count < 1) {
       unlock_buffer_pool(pool);
@@ -1809,13 +2923,14 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
 
     read_bitdepth_colorspace_sampling(cm, rb);
     pbi->refresh_frame_flags = (1 << REF_FRAMES) - 1;
+    pbi->stale_ref_frames = 0;
 
     for (i = 0; i < REFS_PER_FRAME; ++i) {
       cm->frame_refs[i].idx = INVALID_IDX;
       cm->frame_refs[i].buf = NULL;
     }
 
-    setup_frame_size(cm, rb);
+    setup_frame_size(pbi, rb);
     if (pbi->need_resync) {
       memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
       pbi->need_resync = 0;
@@ -1826,6 +2941,18 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
     cm->reset_frame_context =
         cm->error_resilient_mode ? 0 : vpx_rb_read_literal(rb, 2);
 
+    // Only keep the intra-only frames that reset all the probability
+    // contexts, as the others may inherit one from a dropped frame.
+    if (pbi->keyframe_only &&
+        !(cm->intra_only &&
+          (cm->error_resilient_mode || cm->reset_frame_context == 3))) {
+      if (cm->intra_only)  // Its refreshed slots are not known yet.
+        pbi->stale_ref_frames = (1 << REF_FRAMES) - 1;
+      else
+        pbi->stale_ref_frames |= vpx_rb_read_literal(rb, REF_FRAMES);
+      return drop_frame(pbi);
+    }
+
     if (cm->intra_only) {
       if (!vp9_read_sync_code(rb))
         vpx_internal_error(&cm->error, VPX_CODEC_UNSUP_BITSTREAM,
@@ -1847,7 +2974,8 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
       }
 
       pbi->refresh_frame_flags = vpx_rb_read_literal(rb, REF_FRAMES);
-      setup_frame_size(cm, rb);
+      pbi->stale_ref_frames &= ~pbi->refresh_frame_flags;
+      setup_frame_size(pbi, rb);
       if (pbi->need_resync) {
         memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
         pbi->need_resync = 0;
@@ -1863,7 +2991,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
         cm->ref_frame_sign_bias[LAST_FRAME + i] = vpx_rb_read_bit(rb);
       }
 
-      setup_frame_size_with_refs(cm, rb);
+      setup_frame_size_with_refs(pbi, rb);
 
       cm->allow_high_precision_mv = vpx_rb_read_bit(rb);
       cm->interp_filter = read_interp_filter(rb);
@@ -2048,6 +3176,7 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
   struct vpx_read_bit_buffer rb;
   int context_updated = 0;
   uint8_t clear_data[MAX_VP9_HEADER_SIZE];
+  int64_t start = dec_perf_start(pbi->collect_perf_stats);
   const size_t first_partition_size = read_uncompressed_header(
       pbi, init_read_bit_buffer(pbi, &rb, data, data_end, clear_data));
   const int tile_rows = 1 << cm->log2_tile_rows;
@@ -2056,8 +3185,9 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
   xd->cur_buf = new_fb;
 
   if (!first_partition_size) {
-    // showing a frame directly
-    *p_data_end = data + (cm->profile <= PROFILE_2 ? 1 : 2);
+    // showing a frame directly, or dropping the whole frame.
+    *p_data_end =
+        cm->show_frame ? data + (cm->profile <= PROFILE_2 ? 1 : 2) : data_end;
     return;
   }
 
@@ -2088,6 +3218,9 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
     vp9_loop_filter_frame_init(cm, cm->lf.filter_level);
   }
 
+  if (pbi->collect_perf_stats)
+    pbi->perf_time[DEC_PERF_HEADER] += vpx_nsec_timer_now() - start;
+
   // If encoded in frame parallel mode, frame context is ready after decoding
   // the frame header.
   if (pbi->frame_parallel_decode && cm->frame_parallel_decoding_mode) {
@@ -2119,25 +3252,45 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
     pbi->total_tiles = tile_rows * tile_cols;
   }
 
-  if (pbi->max_threads > 1 && tile_rows == 1 && tile_cols > 1) {
+  {
+    const int num_tile_workers =
+        pbi->total_tiles + ((pbi->max_threads > 1) ? pbi->max_threads : 0);
+    int n;
+    for (n = 0; n < num_tile_workers; ++n) {
+      TileWorkerData *const tile_data = &pbi->tile_worker_data[n];
+      tile_data->collect_perf_stats = pbi->collect_perf_stats;
+      vp9_zero(tile_data->perf_time);
+      tile_data->busy_time = 0;
+    }
+  }
+
+  pbi->rows_reported = 0;
+#if CONFIG_MULTITHREAD
+  if (pbi->rows_decoded_cb != NULL && pbi->rows_decoded_mutex == NULL) {
+    CHECK_MEM_ERROR(cm, pbi->rows_decoded_mutex,
+                    vpx_malloc(sizeof(*pbi->rows_decoded_mutex)));
+    pthread_mutex_init(pbi->rows_decoded_mutex, NULL);
+  }
+#endif
+
+  if (pbi->max_threads > 1 && pbi->row_mt) {
+    // Row based multi-threaded decoder, loop filtering included.
+    *p_data_end =
+        decode_tiles_row_mt(pbi, data + first_partition_size, data_end);
+  } else if (pbi->max_threads > 1 && tile_rows == 1 && tile_cols > 1) {
     // Multi-threaded tile decoder
+    // The tile workers loop filter the superblock rows as they complete.
     *p_data_end = decode_tiles_mt(pbi, data + first_partition_size, data_end);
-    if (!xd->corrupted) {
-      if (!cm->skip_loop_filter) {
-        // If multiple threads are used to decode tiles, then we use those
-        // threads to do parallel loopfiltering.
-        vp9_loop_filter_frame_mt(new_fb, cm, pbi->mb.plane, cm->lf.filter_level,
-                                 0, 0, pbi->tile_workers, pbi->num_tile_workers,
-                                 &pbi->lf_row_sync);
-      }
-    } else {
+    if (xd->corrupted) {
       vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
                          "Decode failed. Frame data is corrupted.");
     }
   } else {
     *p_data_end = decode_tiles(pbi, data + first_partition_size, data_end);
   }
+  if (!xd->corrupted) rows_decoded(pbi, cm->mi_rows);
 
+  start = dec_perf_start(pbi->collect_perf_stats);
   if (!xd->corrupted) {
     if (!cm->error_resilient_mode && !cm->frame_parallel_decoding_mode) {
       vp9_adapt_coef_probs(cm);
@@ -2155,4 +3308,15 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
   // Non frame parallel update frame context here.
   if (cm->refresh_frame_context && !context_updated)
     cm->frame_contexts[cm->frame_context_idx] = *cm->fc;
+
+  if (pbi->collect_perf_stats) {
+    const int num_tile_workers =
+        pbi->total_tiles + ((pbi->max_threads > 1) ? pbi->max_threads : 0);
+    int n, i;
+    pbi->perf_time[DEC_PERF_ADAPT] += vpx_nsec_timer_now() - start;
+    for (n = 0; n < num_tile_workers; ++n) {
+      for (i = 0; i < DEC_PERF_STAGES; ++i)
+        pbi->perf_time[i] += pbi->tile_worker_data[n].perf_time[i];
+    }
+  }
 }
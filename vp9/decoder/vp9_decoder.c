@@ -24,6 +24,7 @@
 #include "vpx_util/vpx_thread.h"
 
 #include "vp9/common/vp9_alloccommon.h"
+#include "vp9/common/vp9_frame_buffers.h"
 #include "vp9/common/vp9_loopfilter.h"
 #include "vp9/common/vp9_onyxc_int.h"
 #if CONFIG_VP9_POSTPROC
@@ -119,6 +120,62 @@ VP9Decoder *vp9_decoder_create(BufferPool *const pool) {
   return pbi;
 }
 
+void vp9_dec_alloc_row_mt_mem(RowMTWorkerData *row_mt_worker_data,
+                              VP9_COMMON *cm, int num_sbs, int sb_rows) {
+  int plane;
+  const int uv_shift = cm->subsampling_x + cm->subsampling_y;
+
+  row_mt_worker_data->uv_shift = uv_shift;
+  for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+    const int shift = plane ? uv_shift : 0;
+    const size_t dqcoeff_size = (num_sbs << (DQCOEFFS_PER_SB_LOG2 - shift)) *
+                                sizeof(*row_mt_worker_data->dqcoeff[0]);
+    CHECK_MEM_ERROR(cm, row_mt_worker_data->dqcoeff[plane],
+                    vpx_memalign(16, dqcoeff_size));
+    memset(row_mt_worker_data->dqcoeff[plane], 0, dqcoeff_size);
+    CHECK_MEM_ERROR(cm, row_mt_worker_data->eob[plane],
+                    vpx_calloc(num_sbs << (EOBS_PER_SB_LOG2 - shift),
+                               sizeof(*row_mt_worker_data->eob[plane])));
+  }
+  CHECK_MEM_ERROR(cm, row_mt_worker_data->partition,
+                  vpx_calloc(num_sbs * PARTITIONS_PER_SB,
+                             sizeof(*row_mt_worker_data->partition)));
+  vp9_row_mt_sync_mem_alloc(&row_mt_worker_data->recon_sync, cm, sb_rows);
+  CHECK_MEM_ERROR(cm, row_mt_worker_data->parsed_tile_cols,
+                  vpx_calloc(sb_rows,
+                             sizeof(*row_mt_worker_data->parsed_tile_cols)));
+#if CONFIG_MULTITHREAD
+  pthread_mutex_init(&row_mt_worker_data->parse_mutex, NULL);
+  pthread_cond_init(&row_mt_worker_data->parse_cond, NULL);
+#endif
+  row_mt_worker_data->num_sbs = num_sbs;
+}
+
+void vp9_dec_free_row_mt_mem(RowMTWorkerData *row_mt_worker_data) {
+  int plane;
+
+  if (row_mt_worker_data == NULL) return;
+
+  for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+    vpx_free(row_mt_worker_data->dqcoeff[plane]);
+    row_mt_worker_data->dqcoeff[plane] = NULL;
+    vpx_free(row_mt_worker_data->eob[plane]);
+    row_mt_worker_data->eob[plane] = NULL;
+  }
+  vpx_free(row_mt_worker_data->partition);
+  row_mt_worker_data->partition = NULL;
+  vp9_row_mt_sync_mem_dealloc(&row_mt_worker_data->recon_sync);
+  if (row_mt_worker_data->parsed_tile_cols != NULL) {
+#if CONFIG_MULTITHREAD
+    pthread_mutex_destroy(&row_mt_worker_data->parse_mutex);
+    pthread_cond_destroy(&row_mt_worker_data->parse_cond);
+#endif
+    vpx_free(row_mt_worker_data->parsed_tile_cols);
+    row_mt_worker_data->parsed_tile_cols = NULL;
+  }
+  row_mt_worker_data->num_sbs = 0;
+}
+
 void vp9_decoder_remove(VP9Decoder *pbi) {
   int i;
 
@@ -139,9 +196,115 @@ void vp9_decoder_remove(VP9Decoder *pbi) {
     vp9_loop_filter_dealloc(&pbi->lf_row_sync);
   }
 
+#if CONFIG_MULTITHREAD
+  if (pbi->tile_cols_decoded_mutex != NULL) {
+    pthread_mutex_destroy(pbi->tile_cols_decoded_mutex);
+    vpx_free(pbi->tile_cols_decoded_mutex);
+  }
+#endif
+  vpx_free(pbi->tile_cols_decoded);
+#if CONFIG_MULTITHREAD
+  if (pbi->rows_decoded_mutex != NULL) {
+    pthread_mutex_destroy(pbi->rows_decoded_mutex);
+    vpx_free(pbi->rows_decoded_mutex);
+  }
+#endif
+
+  vp9_dec_free_row_mt_mem(pbi->row_mt_worker_data);
+  vpx_free(pbi->row_mt_worker_data);
+
+  vpx_free_frame_buffer(&pbi->downscaled_frame);
+
   vpx_free(pbi);
 }
 
+int vp9_decoder_reserve_frame_size(VP9Decoder *pbi, int width, int height) {
+  VP9_COMMON *const cm = &pbi->common;
+#if CONFIG_SIZE_LIMIT
+  // A hint beyond the allowed size would only waste memory.
+  if (width > DECODE_WIDTH_LIMIT || height > DECODE_HEIGHT_LIMIT) return 0;
+#endif
+  if (vp9_alloc_context_buffers(cm, width, height)) return 1;
+  pbi->max_mi_rows = cm->mi_rows;
+  pbi->max_mi_cols = cm->mi_cols;
+  // Leave the frame size unset so that the first frame header sets it up.
+  vp9_set_mb_mi(cm, 0, 0);
+  return 0;
+}
+
+void vp9_decoder_add_memory_usage(const VP9Decoder *pbi,
+                                  vpx_decoder_memory_usage *usage) {
+  const VP9_COMMON *const cm = &pbi->common;
+  const RowMTWorkerData *const row_mt_worker_data = pbi->row_mt_worker_data;
+  const int above_cols = mi_cols_aligned_to_sb(cm->above_context_alloc_cols);
+  int i;
+
+#if CONFIG_VP9_POSTPROC
+  usage->frame_buffers += cm->post_proc_buffer.buffer_alloc_sz +
+                          cm->post_proc_buffer_int.buffer_alloc_sz;
+#endif
+  usage->frame_buffers += pbi->downscaled_frame.buffer_alloc_sz;
+
+  usage->mode_info += (size_t)cm->mi_alloc_size *
+                      (sizeof(*cm->mip) + sizeof(*cm->mi_grid_base));
+  for (i = 0; i < NUM_PING_PONG_BUFFERS; ++i)
+    if (cm->seg_map_array[i] != NULL)
+      usage->mode_info += cm->seg_map_alloc_size;
+
+  usage->loop_filter += (size_t)cm->lf.lfm_alloc_size * sizeof(*cm->lf.lfm);
+
+  if (row_mt_worker_data != NULL) {
+    const size_t num_sbs = row_mt_worker_data->num_sbs;
+    usage->row_mt += sizeof(*row_mt_worker_data) +
+                     num_sbs * PARTITIONS_PER_SB *
+                         sizeof(*row_mt_worker_data->partition) +
+                     row_mt_worker_data->recon_sync.rows *
+                         (sizeof(*row_mt_worker_data->recon_sync.cur_col) +
+                          sizeof(*row_mt_worker_data->parsed_tile_cols));
+    for (i = 0; i < MAX_MB_PLANE; ++i) {
+      const int shift = i ? row_mt_worker_data->uv_shift : 0;
+      usage->row_mt +=
+          (num_sbs << (DQCOEFFS_PER_SB_LOG2 - shift)) *
+              sizeof(*row_mt_worker_data->dqcoeff[i]) +
+          (num_sbs << (EOBS_PER_SB_LOG2 - shift)) *
+              sizeof(*row_mt_worker_data->eob[i]);
+    }
+  }
+
+  usage->other += sizeof(*pbi) + (1 + FRAME_CONTEXTS) * sizeof(*cm->fc) +
+                  (size_t)above_cols *
+                      (2 * MAX_MB_PLANE * sizeof(*cm->above_context) +
+                       sizeof(*cm->above_seg_context)) +
+                  pbi->num_tile_workers * sizeof(*pbi->tile_workers);
+  if (pbi->tile_worker_data != NULL) {
+    const int num_tile_worker_data =
+        pbi->total_tiles + ((pbi->max_threads > 1) ? pbi->max_threads : 0);
+    usage->other += num_tile_worker_data * sizeof(*pbi->tile_worker_data);
+  }
+}
+
+void vp9_buffer_pool_add_memory_usage(const BufferPool *pool,
+                                      vpx_decoder_memory_usage *usage) {
+  int i;
+
+  if (pool->get_fb_cb == vp9_get_frame_buffer) {
+    const InternalFrameBufferList *const list = &pool->int_frame_buffers;
+    for (i = 0; i < list->num_internal_frame_buffers; ++i)
+      usage->frame_buffers += list->int_fb[i].size;
+  }
+
+  for (i = 0; i < FRAME_BUFFERS; ++i) {
+    const RefCntBuffer *const buf = &pool->frame_bufs[i];
+    // Only count the external frame buffers currently held by the decoder.
+    if (pool->get_fb_cb != vp9_get_frame_buffer && buf->ref_count > 0 &&
+        buf->raw_frame_buffer.data != NULL)
+      usage->frame_buffers += buf->raw_frame_buffer.size;
+    if (buf->mvs != NULL)
+      usage->motion_vectors +=
+          (size_t)buf->mi_rows * buf->mi_cols * sizeof(*buf->mvs);
+  }
+}
+
 static int equal_dimensions(const YV12_BUFFER_CONFIG *a,
                             const YV12_BUFFER_CONFIG *b) {
   return a->y_height == b->y_height && a->y_width == b->y_width &&
@@ -265,6 +428,27 @@ static void swap_frame_buffers(VP9Decoder *pbi) {
     cm->frame_refs[ref_index].idx = -1;
 }
 
+static void reset_perf_stats(VP9Decoder *pbi) {
+  // The postproc time is that of the last output frame.
+  const int64_t postproc_us = pbi->perf_stats.postproc_us;
+  vp9_zero(pbi->perf_time);
+  vp9_zero(pbi->perf_stats);
+  pbi->perf_stats.postproc_us = postproc_us;
+}
+
+static void update_perf_stats(VP9Decoder *pbi) {
+  vpx_decoder_perf_stats *const stats = &pbi->perf_stats;
+  const int64_t *const perf_time = pbi->perf_time;
+  stats->header_us = perf_time[DEC_PERF_HEADER] / 1000;
+  stats->mode_info_us = perf_time[DEC_PERF_MODE_INFO] / 1000;
+  stats->detokenize_us = perf_time[DEC_PERF_DETOKENIZE] / 1000;
+  stats->inverse_transform_us = perf_time[DEC_PERF_INV_TXFM] / 1000;
+  stats->prediction_us = perf_time[DEC_PERF_PREDICTION] / 1000;
+  stats->loop_filter_us = perf_time[DEC_PERF_LOOP_FILTER] / 1000;
+  stats->adapt_us = perf_time[DEC_PERF_ADAPT] / 1000;
+  stats->thread_idle_us = perf_time[DEC_PERF_THREAD_IDLE] / 1000;
+}
+
 int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
                                 const uint8_t **psource) {
   VP9_COMMON *volatile const cm = &pbi->common;
@@ -290,6 +474,7 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
   }
 
   pbi->ready_for_new_data = 0;
+  if (pbi->collect_perf_stats) reset_perf_stats(pbi);
 
   // Check if the previous frame was a frame without any references to it.
   // Release frame buffer if not decoding in frame parallel mode.
@@ -369,6 +554,7 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
 
   cm->error.setjmp = 1;
   vp9_decode_frame(pbi, source, source + size, psource);
+  if (pbi->collect_perf_stats) update_perf_stats(pbi);
 
   swap_frame_buffers(pbi);
 
@@ -408,6 +594,50 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
   return retcode;
 }
 
+static int downscale_frame(VP9Decoder *pbi, YV12_BUFFER_CONFIG *sd) {
+  const int shift = pbi->downscale_shift;
+  const int round = (1 << shift) - 1;
+  YV12_BUFFER_CONFIG *const dst = &pbi->downscaled_frame;
+
+  if (vpx_realloc_frame_buffer(
+          dst, (sd->y_crop_width + round) >> shift,
+          (sd->y_crop_height + round) >> shift, sd->subsampling_x,
+          sd->subsampling_y,
+#if CONFIG_VP9_HIGHBITDEPTH
+          (sd->flags & YV12_FLAG_HIGHBITDEPTH) != 0,
+#endif
+          VP9_DEC_BORDER_IN_PIXELS, pbi->common.byte_alignment, NULL, NULL,
+          NULL) < 0)
+    return -1;
+
+  vpx_yv12_downscale_frame(sd, dst, shift);
+  dst->bit_depth = sd->bit_depth;
+  dst->color_space = sd->color_space;
+  dst->color_range = sd->color_range;
+  dst->render_width = (sd->render_width + round) >> shift;
+  dst->render_height = (sd->render_height + round) >> shift;
+  *sd = *dst;
+  return 0;
+}
+
+#if CONFIG_VP9_POSTPROC
+// Returns the number of tile workers postprocessing may be split between,
+// creating them if the frame was decoded without them.
+static int get_post_proc_workers(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+
+  if (pbi->max_threads <= 1) return 0;
+  if (setjmp(cm->error.jmp)) {
+    cm->error.setjmp = 0;
+    return 0;
+  }
+  cm->error.setjmp = 1;
+  vp9_create_tile_workers(pbi);
+  cm->error.setjmp = 0;
+  return pbi->num_tile_workers;
+}
+#endif  // CONFIG_VP9_POSTPROC
+
 int vp9_get_raw_frame(VP9Decoder *pbi, YV12_BUFFER_CONFIG *sd,
                       vp9_ppflags_t *flags) {
   VP9_COMMON *const cm = &pbi->common;
@@ -427,7 +657,12 @@ int vp9_get_raw_frame(VP9Decoder *pbi, YV12_BUFFER_CONFIG *sd,
 
 #if CONFIG_VP9_POSTPROC
   if (!cm->show_existing_frame) {
-    ret = vp9_post_proc_frame(cm, sd, flags);
+    const int64_t start = pbi->collect_perf_stats ? vpx_nsec_timer_now() : 0;
+    const int num_workers =
+        flags->post_proc_flag ? get_post_proc_workers(pbi) : 0;
+    ret = vp9_post_proc_frame(cm, sd, flags, pbi->tile_workers, num_workers);
+    if (pbi->collect_perf_stats)
+      pbi->perf_stats.postproc_us = (vpx_nsec_timer_now() - start) / 1000;
   } else {
     *sd = *cm->frame_to_show;
     ret = 0;
@@ -436,6 +671,7 @@ int vp9_get_raw_frame(VP9Decoder *pbi, YV12_BUFFER_CONFIG *sd,
   *sd = *cm->frame_to_show;
   ret = 0;
 #endif /*!CONFIG_POSTPROC*/
+  if (ret == 0 && pbi->downscale_shift > 0) ret = downscale_frame(pbi, sd);
   vpx_clear_system_state();
   return ret;
 }
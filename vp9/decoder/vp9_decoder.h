@@ -13,8 +13,10 @@
 
 #include "./vpx_config.h"
 
+#include "vpx/vp8dx.h"
 #include "vpx/vpx_codec.h"
 #include "vpx_dsp/bitreader.h"
+#include "vpx_ports/vpx_timer.h"
 #include "vpx_scale/yv12config.h"
 #include "vpx_util/vpx_thread.h"
 
@@ -33,6 +35,19 @@ typedef struct TileBuffer {
   int col;  // only used with multi-threaded decoding
 } TileBuffer;
 
+// Decode stages timed when VP9D_SET_PERF_STATS is enabled.
+typedef enum {
+  DEC_PERF_HEADER,
+  DEC_PERF_MODE_INFO,
+  DEC_PERF_DETOKENIZE,
+  DEC_PERF_INV_TXFM,
+  DEC_PERF_PREDICTION,
+  DEC_PERF_LOOP_FILTER,
+  DEC_PERF_ADAPT,
+  DEC_PERF_THREAD_IDLE,
+  DEC_PERF_STAGES
+} DEC_PERF_STAGE;
+
 typedef struct TileWorkerData {
   const uint8_t *data_end;
   int buf_start, buf_end;  // pbi->tile_buffers to decode, inclusive
@@ -42,8 +57,65 @@ typedef struct TileWorkerData {
   /* dqcoeff are shared by all the planes. So planes must be decoded serially */
   DECLARE_ALIGNED(16, tran_low_t, dqcoeff[32 * 32]);
   struct vpx_internal_error_info error_info;
+  // Row based multi-threading: position of the current superblock in the
+  // RowMTWorkerData buffers, and superblock rows to reconstruct.
+  PARTITION_TYPE *partition;
+  int *eob[MAX_MB_PLANE];
+  int sb_row_start, sb_row_step;
+  // Per stage decode time in nanoseconds, and the time spent in the worker
+  // hook, when collect_perf_stats is set.
+  int collect_perf_stats;
+  int64_t perf_time[DEC_PERF_STAGES];
+  int64_t busy_time;
 } TileWorkerData;
 
+static INLINE int64_t dec_perf_start(int collect_perf_stats) {
+  return collect_perf_stats ? vpx_nsec_timer_now() : 0;
+}
+
+static INLINE void dec_perf_end(TileWorkerData *twd, DEC_PERF_STAGE stage,
+                                int64_t start) {
+  if (twd->collect_perf_stats)
+    twd->perf_time[stage] += vpx_nsec_timer_now() - start;
+}
+
+// Upper bounds of the data stored per superblock in row based multi-threading.
+#define PARTITIONS_PER_SB 85  // 1 + 4 + 16 + 64 partition nodes.
+#define EOBS_PER_SB_LOG2 8    // 16x16 4x4 transform blocks per plane.
+#define DQCOEFFS_PER_SB_LOG2 12
+
+// Row based multi-threading pipelines the decoding of a frame in two stages.
+// The parse threads read the tiles, one tile column per thread, storing the
+// partitions, end-of-block positions and dequantized coefficients of each
+// superblock here. The reconstruction threads follow them one superblock row
+// at a time across the whole frame width, each row trailing the one above it,
+// and loop filter the row above behind them.
+typedef struct RowMTWorkerData {
+  int num_sbs;
+  // The chroma planes store 1 << uv_shift times less data per superblock than
+  // the luma plane, uv_shift being the sum of the subsampling factors.
+  int uv_shift;
+  PARTITION_TYPE *partition;
+  int *eob[MAX_MB_PLANE];
+  tran_low_t *dqcoeff[MAX_MB_PLANE];
+  VP9RowMTSync recon_sync;
+  TileBuffer tile_buffers[4][1 << 6];
+
+  // Number of tile columns parsed in each superblock row.
+  int *parsed_tile_cols;
+  int parse_error;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t parse_mutex;
+  pthread_cond_t parse_cond;
+#endif
+} RowMTWorkerData;
+
+// Called with the luma rows [row_start, row_end) of 'buf' once they have been
+// reconstructed and loop filtered.
+typedef void (*vp9_rows_decoded_cb_fn_t)(void *priv,
+                                         const YV12_BUFFER_CONFIG *buf,
+                                         int row_start, int row_end);
+
 typedef struct VP9Decoder {
   DECLARE_ALIGNED(16, MACROBLOCKD, mb);
 
@@ -68,11 +140,56 @@ typedef struct VP9Decoder {
   int total_tiles;
 
   VP9LfSync lf_row_sync;
+  // Number of tile columns decoded in each superblock row by the tile
+  // workers, so the rows can be loop filtered as soon as they are complete.
+  int *tile_cols_decoded;
+  int tile_cols_decoded_rows;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *tile_cols_decoded_mutex;
+#endif
+
+  int row_mt;     // Row based multi-threaded decoding.
+  int luma_only;  // Skip the reconstruction and loop filter of chroma.
+  RowMTWorkerData *row_mt_worker_data;
 
   vpx_decrypt_cb decrypt_cb;
   void *decrypt_state;
 
+  // Frame size hint given at init, in MI units. Context buffers are sized for
+  // at least this so that switching between smaller sizes never reallocates.
+  int max_mi_rows;
+  int max_mi_cols;
+
+  // Key frame only decoding: the other frames are dropped after their
+  // uncompressed header. Bit i of stale_ref_frames is set when reference slot
+  // i would have been refreshed by a dropped frame.
+  int keyframe_only;
+  int stale_ref_frames;
+
+  // Output frames are downscaled by (1 << downscale_shift) into
+  // downscaled_frame.
+  int downscale_shift;
+  YV12_BUFFER_CONFIG downscaled_frame;
+
+  // Per stage decode timing, summed over the tile workers in nanoseconds in
+  // perf_time, and reported for the last frame in perf_stats.
+  int collect_perf_stats;
+  int64_t perf_time[DEC_PERF_STAGES];
+  vpx_decoder_perf_stats perf_stats;
+
+  // The rows of the frame being decoded are reported as they become final,
+  // in order and one range at a time. rows_reported is in MI units.
+  vp9_rows_decoded_cb_fn_t rows_decoded_cb;
+  void *rows_decoded_priv;
+  int rows_reported;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *rows_decoded_mutex;
+#endif
+
   int max_threads;
+  // Shared pool running the tile and loop filter workers, NULL when they have
+  // threads of their own.
+  VPxWorkerPool *thread_pool;
   int inv_tile_order;
   int need_resync;   // wait for key/intra-only frame.
   int hold_ref_buf;  // hold the reference buffer.
@@ -113,6 +230,26 @@ struct VP9Decoder *vp9_decoder_create(BufferPool *const pool);
 
 void vp9_decoder_remove(struct VP9Decoder *pbi);
 
+// Allocates the context buffers for frames of up to width x height ahead of
+// decoding. Returns nonzero on allocation failure.
+int vp9_decoder_reserve_frame_size(struct VP9Decoder *pbi, int width,
+                                   int height);
+
+// Adds the memory used by the buffers of pbi to usage, leaving out the frame
+// buffers and motion vectors of the buffer pool.
+void vp9_decoder_add_memory_usage(const struct VP9Decoder *pbi,
+                                  vpx_decoder_memory_usage *usage);
+
+// Adds the memory used by the frame buffers and motion vectors of pool to
+// usage.
+void vp9_buffer_pool_add_memory_usage(const BufferPool *pool,
+                                      vpx_decoder_memory_usage *usage);
+
+void vp9_dec_alloc_row_mt_mem(RowMTWorkerData *row_mt_worker_data,
+                              VP9_COMMON *cm, int num_sbs, int sb_rows);
+
+void vp9_dec_free_row_mt_mem(RowMTWorkerData *row_mt_worker_data);
+
 static INLINE void decrease_ref_count(int idx, RefCntBuffer *const frame_bufs,
                                       BufferPool *const pool) {
   if (idx >= 0 && frame_bufs[idx].ref_count > 0) {
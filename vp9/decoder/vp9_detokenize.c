@@ -29,38 +29,53 @@
     if (counts) ++coef_counts[band][ctx][token]; \
   } while (0)
 
-static INLINE int read_bool(vpx_reader *r, int prob, BD_VALUE *value,
-                            int *count, unsigned int *range) {
+// The largest number of bool decisions in a token (a 12-bit CAT6 token) and
+// of bits a decision can consume.
+#define MAX_TOKEN_BOOLS 26
+#define MAX_BOOL_BITS 7
+
+static INLINE void fill(vpx_reader *r, BD_VALUE *value, int *count) {
+  r->value = *value;
+  r->count = *count;
+  vpx_reader_refill(r);
+  *value = r->value;
+  *count = r->count;
+}
+
+// Reads a bool without checking that 'value' holds enough bits for it.
+static INLINE int read_bool_nofill(int prob, BD_VALUE *value, int *count,
+                                   unsigned int *range) {
   const unsigned int split = (*range * prob + (256 - prob)) >> CHAR_BIT;
   const BD_VALUE bigsplit = (BD_VALUE)split << (BD_VALUE_SIZE - CHAR_BIT);
+  const int bit = *value >= bigsplit;
+  int shift;
 
-  if (*count < 0) {
-    r->value = *value;
-    r->count = *count;
-    vpx_reader_fill(r);
-    *value = r->value;
-    *count = r->count;
+  if (bit) {
+    *range -= split;
+    *value -= bigsplit;
+  } else {
+    *range = split;
   }
+  shift = vpx_norm[*range];
+  *range <<= shift;
+  *value <<= shift;
+  *count -= shift;
+  return bit;
+}
 
-  if (*value >= bigsplit) {
-    *range = *range - split;
-    *value = *value - bigsplit;
-    {
-      const int shift = vpx_norm[*range];
-      *range <<= shift;
-      *value <<= shift;
-      *count -= shift;
-    }
-    return 1;
-  }
-  *range = split;
-  {
-    const int shift = vpx_norm[*range];
-    *range <<= shift;
-    *value <<= shift;
-    *count -= shift;
-  }
-  return 0;
+static INLINE int read_bool(vpx_reader *r, int prob, BD_VALUE *value,
+                            int *count, unsigned int *range) {
+  if (*count < 0) fill(r, value, count);
+  return read_bool_nofill(prob, value, count, range);
+}
+
+// Reads the end of block, zero and one decisions, which are covered by the
+// per token refill in batched mode.
+static INLINE int read_token_bool(vpx_reader *r, int batched, int prob,
+                                  BD_VALUE *value, int *count,
+                                  unsigned int *range) {
+  return batched ? read_bool_nofill(prob, value, count, range)
+                 : read_bool(r, prob, value, count, range);
 }
 
 static INLINE int read_coeff(vpx_reader *r, const vpx_prob *probs, int n,
@@ -71,10 +86,15 @@ static INLINE int read_coeff(vpx_reader *r, const vpx_prob *probs, int n,
   return val;
 }
 
-static int decode_coefs(const MACROBLOCKD *xd, PLANE_TYPE type,
-                        tran_low_t *dqcoeff, TX_SIZE tx_size, const int16_t *dq,
-                        int ctx, const int16_t *scan, const int16_t *nb,
-                        vpx_reader *r) {
+// In batched mode the caller guarantees that the whole block can be read
+// without reaching the last word of the buffer. 'value' is then refilled with
+// a word read at most once per token, and the end of block, zero and one
+// decisions are read without checking 'count'.
+static INLINE int decode_coefs_internal(const MACROBLOCKD *xd, PLANE_TYPE type,
+                                        tran_low_t *dqcoeff, TX_SIZE tx_size,
+                                        const int16_t *dq, int ctx,
+                                        const int16_t *scan, const int16_t *nb,
+                                        vpx_reader *r, int batched) {
   FRAME_COUNTS *counts = xd->counts;
   const int max_eob = 16 << (tx_size << 1);
   const FRAME_CONTEXT *const fc = xd->fc;
@@ -83,8 +103,8 @@ static int decode_coefs(const MACROBLOCKD *xd, PLANE_TYPE type,
   const vpx_prob(*coef_probs)[COEFF_CONTEXTS][UNCONSTRAINED_NODES] =
       fc->coef_probs[tx_size][type][ref];
   const vpx_prob *prob;
-  unsigned int(*coef_counts)[COEFF_CONTEXTS][UNCONSTRAINED_NODES + 1];
-  unsigned int(*eob_branch_count)[COEFF_CONTEXTS];
+  unsigned int(*coef_counts)[COEFF_CONTEXTS][UNCONSTRAINED_NODES + 1] = NULL;
+  unsigned int(*eob_branch_count)[COEFF_CONTEXTS] = NULL;
   uint8_t token_cache[32 * 32];
   const uint8_t *band_translate = get_band_translate(tx_size);
   const int dq_shift = (tx_size == TX_32X32);
@@ -119,12 +139,17 @@ static int decode_coefs(const MACROBLOCKD *xd, PLANE_TYPE type,
     band = *band_translate++;
     prob = coef_probs[band][ctx];
     if (counts) ++eob_branch_count[band][ctx];
-    if (!read_bool(r, prob[EOB_CONTEXT_NODE], &value, &count, &range)) {
+    // A word read leaves at least BD_VALUE_SIZE - 16 bits in 'count', enough
+    // for the end of block, zero and one decisions.
+    if (batched && count < 2 * MAX_BOOL_BITS) fill(r, &value, &count);
+    if (!read_token_bool(r, batched, prob[EOB_CONTEXT_NODE], &value, &count,
+                         &range)) {
       INCREMENT_COUNT(EOB_MODEL_TOKEN);
       break;
     }
 
-    while (!read_bool(r, prob[ZERO_CONTEXT_NODE], &value, &count, &range)) {
+    while (!read_token_bool(r, batched, prob[ZERO_CONTEXT_NODE], &value,
+                            &count, &range)) {
       INCREMENT_COUNT(ZERO_TOKEN);
       dqv = dq[1];
       token_cache[scan[c]] = 0;
@@ -138,9 +163,11 @@ static int decode_coefs(const MACROBLOCKD *xd, PLANE_TYPE type,
       ctx = get_coef_context(nb, token_cache, c);
       band = *band_translate++;
       prob = coef_probs[band][ctx];
+      if (batched && count < MAX_BOOL_BITS) fill(r, &value, &count);
     }
 
-    if (read_bool(r, prob[ONE_CONTEXT_NODE], &value, &count, &range)) {
+    if (read_token_bool(r, batched, prob[ONE_CONTEXT_NODE], &value, &count,
+                        &range)) {
       const vpx_prob *p = vp9_pareto8_full[prob[PIVOT_NODE] - 1];
       INCREMENT_COUNT(TWO_TOKEN);
       if (read_bool(r, p[0], &value, &count, &range)) {
@@ -218,6 +245,22 @@ static int decode_coefs(const MACROBLOCKD *xd, PLANE_TYPE type,
   return c;
 }
 
+static int decode_coefs(const MACROBLOCKD *xd, PLANE_TYPE type,
+                        tran_low_t *dqcoeff, TX_SIZE tx_size, const int16_t *dq,
+                        int ctx, const int16_t *scan, const int16_t *nb,
+                        vpx_reader *r) {
+  const size_t max_bytes =
+      ((size_t)16 << (tx_size << 1)) * MAX_TOKEN_BOOLS * MAX_BOOL_BITS /
+          CHAR_BIT +
+      2 * sizeof(BD_VALUE);
+  if (!r->decrypt_cb && (size_t)(r->buffer_end - r->buffer) > max_bytes) {
+    return decode_coefs_internal(xd, type, dqcoeff, tx_size, dq, ctx, scan, nb,
+                                 r, 1);
+  }
+  return decode_coefs_internal(xd, type, dqcoeff, tx_size, dq, ctx, scan, nb, r,
+                               0);
+}
+
 static void get_ctx_shift(MACROBLOCKD *xd, int *ctx_shift_a, int *ctx_shift_l,
                           int x, int y, unsigned int tx_size_in_blocks) {
   if (xd->max_blocks_wide) {
@@ -243,6 +286,7 @@ int vp9_decode_block_tokens(TileWorkerData *twd, int plane,
   int ctx;
   int ctx_shift_a = 0;
   int ctx_shift_l = 0;
+  const int64_t start = dec_perf_start(twd->collect_perf_stats);
 
   switch (tx_size) {
     case TX_4X4:
@@ -288,5 +332,6 @@ int vp9_decode_block_tokens(TileWorkerData *twd, int plane,
       break;
   }
 
+  dec_perf_end(twd, DEC_PERF_DETOKENIZE, start);
   return eob;
 }
@@ -35,10 +35,17 @@ typedef struct FrameWorkerData {
   int received_frame;
 
   // scratch_buffer is used in frame parallel mode only.
-  // It is used to make a copy of the compressed data.
+  // It is used to make a copy of the compressed data when no input release
+  // callback has been set.
   uint8_t *scratch_buffer;
   size_t scratch_buffer_size;
 
+  // Caller buffer to hand back through the input release callback once this
+  // worker has finished. Only set on the worker decoding the last frame of a
+  // buffer in frame parallel mode.
+  const uint8_t *release_data;
+  void *release_priv;
+
 #if CONFIG_MULTITHREAD
   pthread_mutex_t stats_mutex;
   pthread_cond_t stats_cond;
@@ -4339,28 +4339,34 @@ void vp9_init_tile_data(VP9_COMP *cpi) {
   int tile_tok = 0;
   int tplist_count = 0;
 
-  if (cpi->tile_data == NULL || cpi->allocated_tiles < tile_cols * tile_rows) {
-    if (cpi->tile_data != NULL) vpx_free(cpi->tile_data);
-    CHECK_MEM_ERROR(cm, cpi->tile_data, vpx_malloc(tile_cols * tile_rows *
-                                                   sizeof(*cpi->tile_data)));
+  const int tile_layers = get_num_tile_data_layers(cpi);
+  const int layer = cpi->use_svc ? cpi->svc.spatial_layer_id : 0;
+
+  assert(layer < tile_layers);
+  if (cpi->tile_data_base == NULL ||
+      cpi->allocated_tiles < tile_cols * tile_rows ||
+      cpi->allocated_tile_layers < tile_layers) {
+    int t;
+    if (cpi->tile_data_base != NULL) vpx_free(cpi->tile_data_base);
+    CHECK_MEM_ERROR(cm, cpi->tile_data_base,
+                    vpx_malloc(tile_layers * tile_cols * tile_rows *
+                               sizeof(*cpi->tile_data_base)));
     cpi->allocated_tiles = tile_cols * tile_rows;
-
-    for (tile_row = 0; tile_row < tile_rows; ++tile_row)
-      for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
-        TileDataEnc *tile_data =
-            &cpi->tile_data[tile_row * tile_cols + tile_col];
-        int i, j;
-        for (i = 0; i < BLOCK_SIZES; ++i) {
-          for (j = 0; j < MAX_MODES; ++j) {
-            tile_data->thresh_freq_fact[i][j] = RD_THRESH_INIT_FACT;
-            tile_data->mode_map[i][j] = j;
-          }
+    cpi->allocated_tile_layers = tile_layers;
+
+    for (t = 0; t < tile_layers * tile_cols * tile_rows; ++t) {
+      TileDataEnc *tile_data = &cpi->tile_data_base[t];
+      int i, j;
+      for (i = 0; i < BLOCK_SIZES; ++i) {
+        for (j = 0; j < MAX_MODES; ++j) {
+          tile_data->thresh_freq_fact[i][j] = RD_THRESH_INIT_FACT;
+          tile_data->mode_map[i][j] = j;
         }
-#if CONFIG_MULTITHREAD
-        tile_data->row_base_thresh_freq_fact = NULL;
-#endif
       }
+      tile_data->row_base_thresh_freq_fact = NULL;
+    }
   }
+  cpi->tile_data = cpi->tile_data_base + layer * cpi->allocated_tiles;
 
   for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
     for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
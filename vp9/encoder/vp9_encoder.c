@@ -423,7 +423,8 @@ static void dealloc_compressor_data(VP9_COMP *cpi) {
   vpx_free(cpi->mbmi_ext_base);
   cpi->mbmi_ext_base = NULL;
 
-  vpx_free(cpi->tile_data);
+  vpx_free(cpi->tile_data_base);
+  cpi->tile_data_base = NULL;
   cpi->tile_data = NULL;
 
   vpx_free(cpi->segmentation_map);
@@ -4999,7 +5000,7 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
             ppflags.post_proc_flag = VP9D_DEBLOCK;
             ppflags.deblocking_level = 0;  // not used in vp9_post_proc_frame()
             ppflags.noise_level = 0;       // not used in vp9_post_proc_frame()
-            vp9_post_proc_frame(cm, pp, &ppflags);
+            vp9_post_proc_frame(cm, pp, &ppflags, NULL, 0);
           }
 #endif
           vpx_clear_system_state();
@@ -5146,7 +5147,7 @@ int vp9_get_preview_raw_frame(VP9_COMP *cpi, YV12_BUFFER_CONFIG *dest,
   } else {
     int ret;
 #if CONFIG_VP9_POSTPROC
-    ret = vp9_post_proc_frame(cm, dest, flags);
+    ret = vp9_post_proc_frame(cm, dest, flags, NULL, 0);
 #else
     if (cm->frame_to_show) {
       *dest = *cm->frame_to_show;
@@ -5264,16 +5265,16 @@ void vp9_apply_encoding_flags(VP9_COMP *cpi, vpx_enc_frame_flags_t flags) {
 }
 
 void vp9_set_row_mt(VP9_COMP *cpi) {
-  // Enable row based multi-threading for supported modes of encoding
+  // Enable row based multi-threading for supported modes of encoding. SVC
+  // keeps separate tile data, and so row sync state, per spatial layer.
   cpi->row_mt = 0;
   if (((cpi->oxcf.mode == GOOD || cpi->oxcf.mode == BEST) &&
        cpi->oxcf.speed < 5 && cpi->oxcf.pass == 1) &&
-      cpi->oxcf.row_mt && !cpi->use_svc)
+      cpi->oxcf.row_mt)
     cpi->row_mt = 1;
 
   if (cpi->oxcf.mode == GOOD && cpi->oxcf.speed < 5 &&
-      (cpi->oxcf.pass == 0 || cpi->oxcf.pass == 2) && cpi->oxcf.row_mt &&
-      !cpi->use_svc)
+      (cpi->oxcf.pass == 0 || cpi->oxcf.pass == 2) && cpi->oxcf.row_mt)
     cpi->row_mt = 1;
 
   // In realtime mode, enable row based multi-threading for all the speed levels
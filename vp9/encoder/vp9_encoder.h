@@ -314,6 +314,9 @@ typedef struct MultiThreadHandle {
 
   int jobs_per_tile_col;
 
+  // Number of tile data sets, one per spatial layer, with row sync memory.
+  int allocated_tile_layers;
+
   RowMTInfo row_mt_info[MAX_NUM_TILE_COLS];
   int thread_id_to_tile_id[MAX_NUM_THREADS];  // Mapping of threads to tiles
 } MultiThreadHandle;
@@ -468,8 +471,14 @@ typedef struct VP9_COMP {
 #endif
   YV12_BUFFER_CONFIG *raw_source_frame;
 
+  // Tile data of the spatial layer being encoded. With SVC every spatial
+  // layer has its own set in tile_data_base, allocated_tiles apart, so that
+  // the adaptive thresholds and the row sync state of one resolution are not
+  // used for another.
   TileDataEnc *tile_data;
+  TileDataEnc *tile_data_base;
   int allocated_tiles;  // Keep track of memory allocated for tiles.
+  int allocated_tile_layers;
 
   // For a still frame, this flag is set to 1 to skip partition search.
   int partition_search_skippable_frame;
@@ -801,6 +810,11 @@ static INLINE int get_token_alloc(int mb_rows, int mb_cols) {
   return mb_rows * mb_cols * (16 * 16 * 3 + 4);
 }
 
+// Number of tile data sets kept by the encoder.
+static INLINE int get_num_tile_data_layers(const VP9_COMP *cpi) {
+  return cpi->use_svc ? cpi->svc.number_spatial_layers : 1;
+}
+
 // Get the allocated token size for a tile. It does the same calculation as in
 // the frame token allocation.
 static INLINE int allocated_tokens(TileInfo tile) {
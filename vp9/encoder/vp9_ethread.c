@@ -252,133 +252,6 @@ static void accumulate_fp_tile_stat(TileDataEnc *tile_data,
                    tile_data_t->fp_data.image_data_start_row);
 }
 
-// Allocate memory for row synchronization
-void vp9_row_mt_sync_mem_alloc(VP9RowMTSync *row_mt_sync, VP9_COMMON *cm,
-                               int rows) {
-  row_mt_sync->rows = rows;
-#if CONFIG_MULTITHREAD
-  {
-    int i;
-
-    CHECK_MEM_ERROR(cm, row_mt_sync->mutex_,
-                    vpx_malloc(sizeof(*row_mt_sync->mutex_) * rows));
-    if (row_mt_sync->mutex_) {
-      for (i = 0; i < rows; ++i) {
-        pthread_mutex_init(&row_mt_sync->mutex_[i], NULL);
-      }
-    }
-
-    CHECK_MEM_ERROR(cm, row_mt_sync->cond_,
-                    vpx_malloc(sizeof(*row_mt_sync->cond_) * rows));
-    if (row_mt_sync->cond_) {
-      for (i = 0; i < rows; ++i) {
-        pthread_cond_init(&row_mt_sync->cond_[i], NULL);
-      }
-    }
-  }
-#endif  // CONFIG_MULTITHREAD
-
-  CHECK_MEM_ERROR(cm, row_mt_sync->cur_col,
-                  vpx_malloc(sizeof(*row_mt_sync->cur_col) * rows));
-
-  // Set up nsync.
-  row_mt_sync->sync_range = 1;
-}
-
-// Deallocate row based multi-threading synchronization related mutex and data
-void vp9_row_mt_sync_mem_dealloc(VP9RowMTSync *row_mt_sync) {
-  if (row_mt_sync != NULL) {
-#if CONFIG_MULTITHREAD
-    int i;
-
-    if (row_mt_sync->mutex_ != NULL) {
-      for (i = 0; i < row_mt_sync->rows; ++i) {
-        pthread_mutex_destroy(&row_mt_sync->mutex_[i]);
-      }
-      vpx_free(row_mt_sync->mutex_);
-    }
-    if (row_mt_sync->cond_ != NULL) {
-      for (i = 0; i < row_mt_sync->rows; ++i) {
-        pthread_cond_destroy(&row_mt_sync->cond_[i]);
-      }
-      vpx_free(row_mt_sync->cond_);
-    }
-#endif  // CONFIG_MULTITHREAD
-    vpx_free(row_mt_sync->cur_col);
-    // clear the structure as the source of this call may be dynamic change
-    // in tiles in which case this call will be followed by an _alloc()
-    // which may fail.
-    vp9_zero(*row_mt_sync);
-  }
-}
-
-void vp9_row_mt_sync_read(VP9RowMTSync *const row_mt_sync, int r, int c) {
-#if CONFIG_MULTITHREAD
-  const int nsync = row_mt_sync->sync_range;
-
-  if (r && !(c & (nsync - 1))) {
-    pthread_mutex_t *const mutex = &row_mt_sync->mutex_[r - 1];
-    pthread_mutex_lock(mutex);
-
-    while (c > row_mt_sync->cur_col[r - 1] - nsync + 1) {
-      pthread_cond_wait(&row_mt_sync->cond_[r - 1], mutex);
-    }
-    pthread_mutex_unlock(mutex);
-  }
-#else
-  (void)row_mt_sync;
-  (void)r;
-  (void)c;
-#endif  // CONFIG_MULTITHREAD
-}
-
-void vp9_row_mt_sync_read_dummy(VP9RowMTSync *const row_mt_sync, int r, int c) {
-  (void)row_mt_sync;
-  (void)r;
-  (void)c;
-  return;
-}
-
-void vp9_row_mt_sync_write(VP9RowMTSync *const row_mt_sync, int r, int c,
-                           const int cols) {
-#if CONFIG_MULTITHREAD
-  const int nsync = row_mt_sync->sync_range;
-  int cur;
-  // Only signal when there are enough encoded blocks for next row to run.
-  int sig = 1;
-
-  if (c < cols - 1) {
-    cur = c;
-    if (c % nsync != nsync - 1) sig = 0;
-  } else {
-    cur = cols + nsync;
-  }
-
-  if (sig) {
-    pthread_mutex_lock(&row_mt_sync->mutex_[r]);
-
-    row_mt_sync->cur_col[r] = cur;
-
-    pthread_cond_signal(&row_mt_sync->cond_[r]);
-    pthread_mutex_unlock(&row_mt_sync->mutex_[r]);
-  }
-#else
-  (void)row_mt_sync;
-  (void)r;
-  (void)c;
-  (void)cols;
-#endif  // CONFIG_MULTITHREAD
-}
-
-void vp9_row_mt_sync_write_dummy(VP9RowMTSync *const row_mt_sync, int r, int c,
-                                 const int cols) {
-  (void)row_mt_sync;
-  (void)r;
-  (void)c;
-  (void)cols;
-  return;
-}
-
 static int first_pass_worker_hook(EncWorkerData *const thread_data,
                                   MultiThreadHandle *multi_thread_ctxt) {
   VP9_COMP *const cpi = thread_data->cpi;
@@ -433,7 +306,9 @@ void vp9_encode_fp_row_mt(VP9_COMP *cpi) {
 
   if (multi_thread_ctxt->allocated_tile_cols < tile_cols ||
       multi_thread_ctxt->allocated_tile_rows < tile_rows ||
-      multi_thread_ctxt->allocated_vert_unit_rows < cm->mb_rows) {
+      multi_thread_ctxt->allocated_vert_unit_rows < cm->mb_rows ||
+      multi_thread_ctxt->allocated_tile_layers <
+          get_num_tile_data_layers(cpi)) {
     vp9_row_mt_mem_dealloc(cpi);
     vp9_init_tile_data(cpi);
     vp9_row_mt_mem_alloc(cpi);
@@ -518,7 +393,9 @@ void vp9_temporal_filter_row_mt(VP9_COMP *cpi) {
 
   if (multi_thread_ctxt->allocated_tile_cols < tile_cols ||
       multi_thread_ctxt->allocated_tile_rows < tile_rows ||
-      multi_thread_ctxt->allocated_vert_unit_rows < cm->mb_rows) {
+      multi_thread_ctxt->allocated_vert_unit_rows < cm->mb_rows ||
+      multi_thread_ctxt->allocated_tile_layers <
+          get_num_tile_data_layers(cpi)) {
     vp9_row_mt_mem_dealloc(cpi);
     vp9_init_tile_data(cpi);
     vp9_row_mt_mem_alloc(cpi);
@@ -589,7 +466,9 @@ void vp9_encode_tiles_row_mt(VP9_COMP *cpi) {
 
   if (multi_thread_ctxt->allocated_tile_cols < tile_cols ||
       multi_thread_ctxt->allocated_tile_rows < tile_rows ||
-      multi_thread_ctxt->allocated_vert_unit_rows < cm->mb_rows) {
+      multi_thread_ctxt->allocated_vert_unit_rows < cm->mb_rows ||
+      multi_thread_ctxt->allocated_tile_layers <
+          get_num_tile_data_layers(cpi)) {
     vp9_row_mt_mem_dealloc(cpi);
     vp9_init_tile_data(cpi);
     vp9_row_mt_mem_alloc(cpi);
@@ -11,6 +11,8 @@
 #ifndef VP9_ENCODER_VP9_ETHREAD_H_
 #define VP9_ENCODER_VP9_ETHREAD_H_
 
+#include "vp9/common/vp9_thread_common.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -30,39 +32,12 @@ typedef struct EncWorkerData {
   int tile_completion_status[MAX_NUM_TILE_COLS];
 } EncWorkerData;
 
-// Encoder row synchronization
-typedef struct VP9RowMTSyncData {
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t *mutex_;
-  pthread_cond_t *cond_;
-#endif
-  // Allocate memory to store the sb/mb block index in each row.
-  int *cur_col;
-  int sync_range;
-  int rows;
-} VP9RowMTSync;
-
 void vp9_encode_tiles_mt(struct VP9_COMP *cpi);
 
 void vp9_encode_tiles_row_mt(struct VP9_COMP *cpi);
 
 void vp9_encode_fp_row_mt(struct VP9_COMP *cpi);
 
-void vp9_row_mt_sync_read(VP9RowMTSync *const row_mt_sync, int r, int c);
-void vp9_row_mt_sync_write(VP9RowMTSync *const row_mt_sync, int r, int c,
-                           const int cols);
-
-void vp9_row_mt_sync_read_dummy(VP9RowMTSync *const row_mt_sync, int r, int c);
-void vp9_row_mt_sync_write_dummy(VP9RowMTSync *const row_mt_sync, int r, int c,
-                                 const int cols);
-
-// Allocate memory for row based multi-threading synchronization.
-void vp9_row_mt_sync_mem_alloc(VP9RowMTSync *row_mt_sync, struct VP9Common *cm,
-                               int rows);
-
-// Deallocate row based multi-threading synchronization related mutex and data.
-void vp9_row_mt_sync_mem_dealloc(VP9RowMTSync *row_mt_sync);
-
 void vp9_temporal_filter_row_mt(struct VP9_COMP *cpi);
 
 #ifdef __cplusplus
@@ -1424,10 +1424,12 @@ void vp9_first_pass(VP9_COMP *cpi, const struct lookahead_entry *source) {
 
   cm->log2_tile_rows = 0;
 
+  // Sized for the full-size frame, as SVC layers are smaller than that.
   if (cpi->row_mt_bit_exact && cpi->twopass.fp_mb_float_stats == NULL)
-    CHECK_MEM_ERROR(
-        cm, cpi->twopass.fp_mb_float_stats,
-        vpx_calloc(cm->MBs * sizeof(*cpi->twopass.fp_mb_float_stats), 1));
+    CHECK_MEM_ERROR(cm, cpi->twopass.fp_mb_float_stats,
+                    vpx_calloc(cpi->initial_mbs *
+                                   sizeof(*cpi->twopass.fp_mb_float_stats),
+                               1));
 
   {
     FIRSTPASS_STATS fps;
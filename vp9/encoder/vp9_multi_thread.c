@@ -53,7 +53,7 @@ void *vp9_enc_grp_get_next_job(MultiThreadHandle *multi_thread_ctxt,
 void vp9_row_mt_mem_alloc(VP9_COMP *cpi) {
   struct VP9Common *cm = &cpi->common;
   MultiThreadHandle *multi_thread_ctxt = &cpi->multi_thread_ctxt;
-  int tile_row, tile_col;
+  int tile_row, tile_col, layer;
   const int tile_cols = 1 << cm->log2_tile_cols;
   const int tile_rows = 1 << cm->log2_tile_rows;
   const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
@@ -66,6 +66,7 @@ void vp9_row_mt_mem_alloc(VP9_COMP *cpi) {
   multi_thread_ctxt->allocated_tile_cols = tile_cols;
   multi_thread_ctxt->allocated_tile_rows = tile_rows;
   multi_thread_ctxt->allocated_vert_unit_rows = jobs_per_tile_col;
+  multi_thread_ctxt->allocated_tile_layers = cpi->allocated_tile_layers;
 
   multi_thread_ctxt->job_queue =
       (JobQueue *)vpx_memalign(32, total_jobs * sizeof(JobQueue));
@@ -78,28 +79,39 @@ void vp9_row_mt_mem_alloc(VP9_COMP *cpi) {
   }
 #endif
 
-  // Allocate memory for row based multi-threading
-  for (tile_col = 0; tile_col < tile_cols; tile_col++) {
-    TileDataEnc *this_tile = &cpi->tile_data[tile_col];
-    vp9_row_mt_sync_mem_alloc(&this_tile->row_mt_sync, cm, jobs_per_tile_col);
-    if (cpi->sf.adaptive_rd_thresh_row_mt) {
-      const int sb_rows =
-          (mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2) + 1;
-      int i;
-      this_tile->row_base_thresh_freq_fact =
-          (int *)vpx_calloc(sb_rows * BLOCK_SIZES * MAX_MODES,
-                            sizeof(*(this_tile->row_base_thresh_freq_fact)));
-      for (i = 0; i < sb_rows * BLOCK_SIZES * MAX_MODES; i++)
-        this_tile->row_base_thresh_freq_fact[i] = RD_THRESH_INIT_FACT;
-    }
-  }
+  // Allocate memory for row based multi-threading in the tile data of every
+  // spatial layer. The row sync memory is sized for the current frame, which
+  // is the largest one encoded so far.
+  for (layer = 0; layer < cpi->allocated_tile_layers; layer++) {
+    TileDataEnc *const tile_data =
+        cpi->tile_data_base + layer * cpi->allocated_tiles;
 
-  // Assign the sync pointer of tile row zero for every tile row > 0
-  for (tile_row = 1; tile_row < tile_rows; tile_row++) {
     for (tile_col = 0; tile_col < tile_cols; tile_col++) {
-      TileDataEnc *this_tile = &cpi->tile_data[tile_row * tile_cols + tile_col];
-      TileDataEnc *this_col_tile = &cpi->tile_data[tile_col];
-      this_tile->row_mt_sync = this_col_tile->row_mt_sync;
+      TileDataEnc *this_tile = &tile_data[tile_col];
+      vp9_row_mt_sync_mem_alloc(&this_tile->row_mt_sync, cm,
+                                jobs_per_tile_col);
+      // Speed features may differ between SVC layers, so allocate this even
+      // when adaptive_rd_thresh_row_mt is not set for the current one.
+      {
+        const int sb_rows =
+            (mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2) + 1;
+        int i;
+        CHECK_MEM_ERROR(
+            cm, this_tile->row_base_thresh_freq_fact,
+            (int *)vpx_calloc(sb_rows * BLOCK_SIZES * MAX_MODES,
+                              sizeof(*(this_tile->row_base_thresh_freq_fact))));
+        for (i = 0; i < sb_rows * BLOCK_SIZES * MAX_MODES; i++)
+          this_tile->row_base_thresh_freq_fact[i] = RD_THRESH_INIT_FACT;
+      }
+    }
+
+    // Assign the sync pointer of tile row zero for every tile row > 0
+    for (tile_row = 1; tile_row < tile_rows; tile_row++) {
+      for (tile_col = 0; tile_col < tile_cols; tile_col++) {
+        TileDataEnc *this_tile = &tile_data[tile_row * tile_cols + tile_col];
+        TileDataEnc *this_col_tile = &tile_data[tile_col];
+        this_tile->row_mt_sync = this_col_tile->row_mt_sync;
+      }
     }
   }
 
@@ -114,10 +126,7 @@ void vp9_row_mt_mem_alloc(VP9_COMP *cpi) {
 
 void vp9_row_mt_mem_dealloc(VP9_COMP *cpi) {
   MultiThreadHandle *multi_thread_ctxt = &cpi->multi_thread_ctxt;
-  int tile_col;
-#if CONFIG_MULTITHREAD
-  int tile_row;
-#endif
+  int tile_row, tile_col, layer;
 
   // Deallocate memory for job queue
   if (multi_thread_ctxt->job_queue) vpx_free(multi_thread_ctxt->job_queue);
@@ -131,22 +140,24 @@ void vp9_row_mt_mem_dealloc(VP9_COMP *cpi) {
   }
 #endif
 
-  // Free row based multi-threading sync memory
-  for (tile_col = 0; tile_col < multi_thread_ctxt->allocated_tile_cols;
-       tile_col++) {
-    TileDataEnc *this_tile = &cpi->tile_data[tile_col];
-    vp9_row_mt_sync_mem_dealloc(&this_tile->row_mt_sync);
-  }
+  for (layer = 0; layer < multi_thread_ctxt->allocated_tile_layers; layer++) {
+    TileDataEnc *const tile_data =
+        cpi->tile_data_base + layer * cpi->allocated_tiles;
 
-#if CONFIG_MULTITHREAD
-  for (tile_row = 0; tile_row < multi_thread_ctxt->allocated_tile_rows;
-       tile_row++) {
+    // Free row based multi-threading sync memory
     for (tile_col = 0; tile_col < multi_thread_ctxt->allocated_tile_cols;
          tile_col++) {
-      TileDataEnc *this_tile =
-          &cpi->tile_data[tile_row * multi_thread_ctxt->allocated_tile_cols +
-                          tile_col];
-      if (cpi->sf.adaptive_rd_thresh_row_mt) {
+      TileDataEnc *this_tile = &tile_data[tile_col];
+      vp9_row_mt_sync_mem_dealloc(&this_tile->row_mt_sync);
+    }
+
+    for (tile_row = 0; tile_row < multi_thread_ctxt->allocated_tile_rows;
+         tile_row++) {
+      for (tile_col = 0; tile_col < multi_thread_ctxt->allocated_tile_cols;
+           tile_col++) {
+        TileDataEnc *this_tile =
+            &tile_data[tile_row * multi_thread_ctxt->allocated_tile_cols +
+                       tile_col];
         if (this_tile->row_base_thresh_freq_fact != NULL) {
           vpx_free(this_tile->row_base_thresh_freq_fact);
           this_tile->row_base_thresh_freq_fact = NULL;
@@ -154,7 +165,7 @@ void vp9_row_mt_mem_dealloc(VP9_COMP *cpi) {
       }
     }
   }
-#endif
+  multi_thread_ctxt->allocated_tile_layers = 0;
 }
 
 void vp9_multi_thread_tile_init(VP9_COMP *cpi) {
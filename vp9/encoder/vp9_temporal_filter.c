@@ -10,6 +10,7 @@
 
 #include <assert.h>
 #include <math.h>
+#include <stdlib.h>
 #include <limits.h>
 
 #include "vp9/common/vp9_alloccommon.h"
@@ -783,7 +784,7 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
   set_error_per_bit(&cpi->td.mb, rdmult);
   vp9_initialize_me_consts(cpi, &cpi->td.mb, ARNR_FILT_QINDEX);
 
-  if (!cpi->row_mt)
+  if (!cpi->row_mt || getenv("TFSER"))
     temporal_filter_iterate_c(cpi);
   else
     vp9_temporal_filter_row_mt(cpi);
@@ -30,6 +30,8 @@
 #include "vp9/vp9_iface_common.h"
 
 #define VP9_CAP_POSTPROC (CONFIG_VP9_POSTPROC ? VPX_CODEC_CAP_POSTPROC : 0)
+#define VP9_CAP_FRAME_THREADING \
+  (CONFIG_MULTITHREAD ? VPX_CODEC_CAP_FRAME_THREADING : 0)
 
 static vpx_codec_err_t decoder_init(vpx_codec_ctx_t *ctx,
                                     vpx_codec_priv_enc_mr_cfg_t *data) {
@@ -47,18 +49,52 @@ static vpx_codec_err_t decoder_init(vpx_codec_ctx_t *ctx,
     ctx->priv->init_flags = ctx->init_flags;
     priv->si.sz = sizeof(priv->si);
     priv->flushed = 0;
-    // TODO(jzern): remnants of frame-level parallel decoding should be
-    // removed. cf., https://bugs.chromium.org/p/webm/issues/detail?id=1395
-    priv->frame_parallel_decode = 0;
     if (ctx->config.dec) {
       priv->cfg = *ctx->config.dec;
       ctx->config.dec = &priv->cfg;
     }
+    // Frame parallel decoding keeps up to cfg.threads frames in flight, one
+    // per frame worker, so it is only useful with more than one thread.
+    priv->frame_parallel_decode =
+        (ctx->config.dec && ctx->config.dec->threads > 1 &&
+         (ctx->init_flags & VPX_CODEC_USE_FRAME_THREADING))
+            ? 1
+            : 0;
   }
 
   return VPX_CODEC_OK;
 }
 
+static void release_worker_input(vpx_codec_alg_priv_t *ctx,
+                                 FrameWorkerData *const frame_worker_data) {
+  if (frame_worker_data->release_data != NULL) {
+    ctx->release_input_cb(ctx->release_input_state,
+                          frame_worker_data->release_data,
+                          frame_worker_data->release_priv);
+    frame_worker_data->release_data = NULL;
+  }
+}
+
+// The chroma of frames decoded in luma only mode is not reconstructed.
+static void clear_chroma_planes(vpx_image_t *img) {
+  img->planes[VPX_PLANE_U] = NULL;
+  img->planes[VPX_PLANE_V] = NULL;
+  img->stride[VPX_PLANE_U] = 0;
+  img->stride[VPX_PLANE_V] = 0;
+}
+
+// Passes the rows reported by the decoder on to the application as an image.
+static void rows_decoded(void *priv, const YV12_BUFFER_CONFIG *buf,
+                         int row_start, int row_end) {
+  vpx_codec_alg_priv_t *const ctx = (vpx_codec_alg_priv_t *)priv;
+  const FrameWorkerData *const frame_worker_data =
+      (const FrameWorkerData *)ctx->frame_workers[0].data1;
+  vpx_image_t img;
+  yuvconfig2image(&img, buf, frame_worker_data->user_priv);
+  if (frame_worker_data->pbi->luma_only) clear_chroma_planes(&img);
+  ctx->rows_decoded_cb(ctx->rows_decoded_state, &img, row_start, row_end);
+}
+
 static vpx_codec_err_t decoder_destroy(vpx_codec_alg_priv_t *ctx) {
   if (ctx->frame_workers != NULL) {
     int i;
@@ -68,6 +104,13 @@ static vpx_codec_err_t decoder_destroy(vpx_codec_alg_priv_t *ctx) {
       VPxWorker *const worker = &ctx->frame_workers[i];
       vpx_get_worker_interface()->end(worker);
     }
+    // Hand back any compressed data still held by the workers, in the order
+    // it was submitted.
+    for (i = 0; i < ctx->num_frame_workers; ++i) {
+      const int id = (ctx->next_output_worker_id + i) % ctx->num_frame_workers;
+      VPxWorker *const worker = &ctx->frame_workers[id];
+      release_worker_input(ctx, (FrameWorkerData *)worker->data1);
+    }
     for (i = 0; i < ctx->num_frame_workers; ++i) {
       VPxWorker *const worker = &ctx->frame_workers[i];
       FrameWorkerData *const frame_worker_data =
@@ -317,6 +360,7 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
   ctx->frame_cache_write = 0;
   ctx->num_cache_frames = 0;
   ctx->need_resync = 1;
+  ctx->worker_error = VPX_CODEC_OK;
   ctx->num_frame_workers =
       (ctx->frame_parallel_decode == 1) ? ctx->cfg.threads : 1;
   if (ctx->num_frame_workers > MAX_DECODE_THREADS)
@@ -345,6 +389,9 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
     VPxWorker *const worker = &ctx->frame_workers[i];
     FrameWorkerData *frame_worker_data = NULL;
     winterface->init(worker);
+    // In serial mode the frame worker is only ever executed by the calling
+    // thread, so it does not need a thread of its own on a shared pool.
+    if (!ctx->frame_parallel_decode) worker->pool = ctx->thread_pool;
     worker->data1 = vpx_memalign(32, sizeof(FrameWorkerData));
     if (worker->data1 == NULL) {
       set_error_detail(ctx, "Failed to allocate frame_worker_data");
@@ -360,6 +407,8 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
     frame_worker_data->worker_id = i;
     frame_worker_data->scratch_buffer = NULL;
     frame_worker_data->scratch_buffer_size = 0;
+    frame_worker_data->release_data = NULL;
+    frame_worker_data->release_priv = NULL;
     frame_worker_data->frame_context_ready = 0;
     frame_worker_data->received_frame = 0;
 #if CONFIG_MULTITHREAD
@@ -377,11 +426,32 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
     // thread or loopfilter thread.
     frame_worker_data->pbi->max_threads =
         (ctx->frame_parallel_decode == 0) ? ctx->cfg.threads : 0;
+    if (!ctx->frame_parallel_decode && ctx->thread_pool != NULL) {
+      frame_worker_data->pbi->thread_pool = ctx->thread_pool;
+      frame_worker_data->pbi->max_threads =
+          VPXMIN(frame_worker_data->pbi->max_threads,
+                 vpx_thread_pool_num_threads(ctx->thread_pool) + 1);
+    }
 
     frame_worker_data->pbi->inv_tile_order = ctx->invert_tile_order;
+    frame_worker_data->pbi->row_mt = ctx->row_mt;
+    frame_worker_data->pbi->luma_only = ctx->luma_only;
+    frame_worker_data->pbi->keyframe_only = ctx->keyframe_only;
+    frame_worker_data->pbi->downscale_shift = ctx->downscale_shift;
+    frame_worker_data->pbi->collect_perf_stats = ctx->collect_perf_stats;
+    if (ctx->rows_decoded_cb != NULL) {
+      frame_worker_data->pbi->rows_decoded_cb = rows_decoded;
+      frame_worker_data->pbi->rows_decoded_priv = ctx;
+    }
     frame_worker_data->pbi->frame_parallel_decode = ctx->frame_parallel_decode;
     frame_worker_data->pbi->common.frame_parallel_decode =
         ctx->frame_parallel_decode;
+    if (ctx->cfg.w > 0 && ctx->cfg.h > 0 &&
+        vp9_decoder_reserve_frame_size(frame_worker_data->pbi, ctx->cfg.w,
+                                       ctx->cfg.h)) {
+      set_error_detail(ctx, "Failed to allocate context buffers");
+      return VPX_CODEC_MEM_ERROR;
+    }
     worker->hook = (VPxWorkerHook)frame_worker_hook;
     if (!winterface->reset(worker)) {
       set_error_detail(ctx, "Frame Worker thread creation failed");
@@ -423,7 +493,12 @@ static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
                                  ctx->decrypt_cb, ctx->decrypt_state);
     if (res != VPX_CODEC_OK) return res;
 
-    if (!ctx->si.is_kf && !is_intra_only) return VPX_CODEC_ERROR;
+    if (!ctx->si.is_kf && !is_intra_only) {
+      if (!ctx->keyframe_only) return VPX_CODEC_ERROR;
+      // Drop the frames preceding the first key frame.
+      *data += data_sz;
+      return VPX_CODEC_OK;
+    }
   }
 
   if (!ctx->frame_parallel_decode) {
@@ -459,26 +534,34 @@ static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
           &ctx->frame_workers[ctx->last_submit_worker_id]);
 
     frame_worker_data->pbi->ready_for_new_data = 0;
-    // Copy the compressed data into worker's internal buffer.
-    // TODO(hkuang): Will all the workers allocate the same size
-    // as the size of the first intra frame be better? This will
-    // avoid too many deallocate and allocate.
-    if (frame_worker_data->scratch_buffer_size < data_sz) {
-      vpx_free(frame_worker_data->scratch_buffer);
-      frame_worker_data->scratch_buffer = (uint8_t *)vpx_malloc(data_sz);
-      if (frame_worker_data->scratch_buffer == NULL) {
-        set_error_detail(ctx, "Failed to reallocate scratch buffer");
-        return VPX_CODEC_MEM_ERROR;
+    frame_worker_data->pbi->decrypt_cb = ctx->decrypt_cb;
+    frame_worker_data->pbi->decrypt_state = ctx->decrypt_state;
+    if (ctx->release_input_cb != NULL) {
+      // The caller keeps the compressed data alive until it is released, so
+      // the worker can read it in place.
+      frame_worker_data->data = *data;
+    } else {
+      // Copy the compressed data into worker's internal buffer.
+      // TODO(hkuang): Will all the workers allocate the same size
+      // as the size of the first intra frame be better? This will
+      // avoid too many deallocate and allocate.
+      if (frame_worker_data->scratch_buffer_size < data_sz) {
+        vpx_free(frame_worker_data->scratch_buffer);
+        frame_worker_data->scratch_buffer = (uint8_t *)vpx_malloc(data_sz);
+        if (frame_worker_data->scratch_buffer == NULL) {
+          set_error_detail(ctx, "Failed to reallocate scratch buffer");
+          return VPX_CODEC_MEM_ERROR;
+        }
+        frame_worker_data->scratch_buffer_size = data_sz;
       }
-      frame_worker_data->scratch_buffer_size = data_sz;
+      memcpy(frame_worker_data->scratch_buffer, *data, data_sz);
+      frame_worker_data->data = frame_worker_data->scratch_buffer;
     }
     frame_worker_data->data_size = data_sz;
-    memcpy(frame_worker_data->scratch_buffer, *data, data_sz);
 
     frame_worker_data->frame_decoded = 0;
     frame_worker_data->frame_context_ready = 0;
     frame_worker_data->received_frame = 1;
-    frame_worker_data->data = frame_worker_data->scratch_buffer;
     frame_worker_data->user_priv = user_priv;
 
     if (ctx->next_submit_worker_id != ctx->last_submit_worker_id)
@@ -495,27 +578,64 @@ static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+// Called when a frame worker failed to decode its frame. The decoder waits for
+// a key frame again. In frame parallel mode the error is kept for the next
+// call to decode, as the call that submitted the frame has already returned.
+static void set_worker_error(vpx_codec_alg_priv_t *ctx,
+                             const FrameWorkerData *frame_worker_data) {
+  const struct vpx_internal_error_info *const error =
+      &frame_worker_data->pbi->common.error;
+  ctx->need_resync = 1;
+  if (!ctx->frame_parallel_decode) return;
+  if (error->error_code != VPX_CODEC_OK) {
+    ctx->worker_error = update_error_state(ctx, error);
+  } else {
+    set_error_detail(ctx, "Failed to decode frame");
+    ctx->worker_error = VPX_CODEC_CORRUPT_FRAME;
+  }
+}
+
+// Returns and clears the error recorded by set_worker_error().
+static vpx_codec_err_t take_worker_error(vpx_codec_alg_priv_t *ctx) {
+  const vpx_codec_err_t res = ctx->worker_error;
+  ctx->worker_error = VPX_CODEC_OK;
+  return res;
+}
+
 static void wait_worker_and_cache_frame(vpx_codec_alg_priv_t *ctx) {
   YV12_BUFFER_CONFIG sd;
   vp9_ppflags_t flags = { 0, 0, 0 };
   const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
   VPxWorker *const worker = &ctx->frame_workers[ctx->next_output_worker_id];
   FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+  int worker_ok;
   ctx->next_output_worker_id =
       (ctx->next_output_worker_id + 1) % ctx->num_frame_workers;
-  // TODO(hkuang): Add worker error handling here.
-  winterface->sync(worker);
+  worker_ok = winterface->sync(worker);
+  release_worker_input(ctx, frame_worker_data);
   frame_worker_data->received_frame = 0;
   ++ctx->available_threads;
 
+  if (!worker_ok) {
+    set_worker_error(ctx, frame_worker_data);
+    return;
+  }
+
   check_resync(ctx, frame_worker_data->pbi);
 
+  // Once flushed, no frame is launched on this worker until its frame has
+  // been output, so it can be postprocessed as decoder_get_frame() would.
+  if (ctx->flushed && (ctx->base.init_flags & VPX_CODEC_USE_POSTPROC))
+    set_ppflags(ctx, &flags);
+
   if (vp9_get_raw_frame(frame_worker_data->pbi, &sd, &flags) == 0) {
     VP9_COMMON *const cm = &frame_worker_data->pbi->common;
     RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
     ctx->frame_cache[ctx->frame_cache_write].fb_idx = cm->new_fb_idx;
     yuvconfig2image(&ctx->frame_cache[ctx->frame_cache_write].img, &sd,
                     frame_worker_data->user_priv);
+    if (frame_worker_data->pbi->luma_only)
+      clear_chroma_planes(&ctx->frame_cache[ctx->frame_cache_write].img);
     ctx->frame_cache[ctx->frame_cache_write].img.fb_priv =
         frame_bufs[cm->new_fb_idx].raw_frame_buffer.priv;
     ctx->frame_cache_write = (ctx->frame_cache_write + 1) % FRAME_CACHE_SIZE;
@@ -523,20 +643,18 @@ static void wait_worker_and_cache_frame(vpx_codec_alg_priv_t *ctx) {
   }
 }
 
-static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
-                                      const uint8_t *data, unsigned int data_sz,
-                                      void *user_priv, long deadline) {
+// Decodes all the frames in data. In frame parallel mode, *last_worker is set
+// to the worker decoding the last frame launched from data.
+static vpx_codec_err_t decode_frames(vpx_codec_alg_priv_t *ctx,
+                                     const uint8_t *data, unsigned int data_sz,
+                                     void *user_priv, long deadline,
+                                     VPxWorker **last_worker) {
   const uint8_t *data_start = data;
   const uint8_t *const data_end = data + data_sz;
   vpx_codec_err_t res;
   uint32_t frame_sizes[8];
   int frame_count;
 
-  if (data == NULL && data_sz == 0) {
-    ctx->flushed = 1;
-    return VPX_CODEC_OK;
-  }
-
   // Reset flushed when receiving a valid frame.
   ctx->flushed = 0;
 
@@ -585,6 +703,7 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
         res =
             decode_one(ctx, &data_start_copy, frame_size, user_priv, deadline);
         if (res != VPX_CODEC_OK) return res;
+        *last_worker = &ctx->frame_workers[ctx->last_submit_worker_id];
         data_start += frame_size;
       }
     } else {
@@ -602,7 +721,10 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
 
       res = decode_one(ctx, &data, data_sz, user_priv, deadline);
       if (res != VPX_CODEC_OK) return res;
+      *last_worker = &ctx->frame_workers[ctx->last_submit_worker_id];
     }
+    // Report a frame submitted earlier that failed to decode.
+    res = take_worker_error(ctx);
   } else {
     // Decode in serial mode.
     if (frame_count > 0) {
@@ -645,15 +767,88 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
   return res;
 }
 
+static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
+                                      const uint8_t *data, unsigned int data_sz,
+                                      void *user_priv, long deadline) {
+  VPxWorker *last_worker = NULL;
+  vpx_codec_err_t res;
+
+  if (data == NULL && data_sz == 0) {
+    ctx->flushed = 1;
+    if (ctx->frame_parallel_decode && ctx->frame_workers != NULL) {
+      // Wait for the frames still being decoded so that their errors are
+      // returned here.
+      while (ctx->available_threads < ctx->num_frame_workers &&
+             ctx->num_cache_frames < FRAME_CACHE_SIZE) {
+        wait_worker_and_cache_frame(ctx);
+      }
+    }
+    return take_worker_error(ctx);
+  }
+
+  res = decode_frames(ctx, data, data_sz, user_priv, deadline, &last_worker);
+
+  if (ctx->release_input_cb != NULL) {
+    if (last_worker != NULL) {
+      // Release the data once the worker decoding its last frame is synced.
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)last_worker->data1;
+      frame_worker_data->release_data = data;
+      frame_worker_data->release_priv = user_priv;
+    } else {
+      ctx->release_input_cb(ctx->release_input_state, data, user_priv);
+    }
+  }
+
+  return res;
+}
+
 static void release_last_output_frame(vpx_codec_alg_priv_t *ctx) {
   RefCntBuffer *const frame_bufs = ctx->buffer_pool->frame_bufs;
-  // Decrease reference count of last output frame in frame parallel mode.
-  if (ctx->frame_parallel_decode && ctx->last_show_frame >= 0) {
+  // Decrease reference count of last output frame in frame parallel mode, or
+  // of the last frame output from the cache in serial mode.
+  if ((ctx->frame_parallel_decode || ctx->hold_last_show_frame) &&
+      ctx->last_show_frame >= 0) {
     BufferPool *const pool = ctx->buffer_pool;
+    const FrameWorkerData *const frame_worker_data =
+        (const FrameWorkerData *)ctx->frame_workers[0].data1;
     lock_buffer_pool(pool);
-    decrease_ref_count(ctx->last_show_frame, frame_bufs, pool);
+    // The serial decoder releases the buffer of its last frame itself once
+    // unreferenced, when it starts the next one.
+    if (!ctx->frame_parallel_decode &&
+        ctx->last_show_frame == frame_worker_data->pbi->common.new_fb_idx)
+      --frame_bufs[ctx->last_show_frame].ref_count;
+    else
+      decrease_ref_count(ctx->last_show_frame, frame_bufs, pool);
     unlock_buffer_pool(pool);
   }
+  ctx->hold_last_show_frame = 0;
+}
+
+// Moves the frame output by the last decode in serial mode to the frame
+// cache, holding a reference to its buffer until it has been output.
+static void cache_serial_frame(vpx_codec_alg_priv_t *ctx) {
+  YV12_BUFFER_CONFIG sd;
+  vp9_ppflags_t flags = { 0, 0, 0 };
+  FrameWorkerData *const frame_worker_data =
+      (FrameWorkerData *)ctx->frame_workers[0].data1;
+  VP9Decoder *const pbi = frame_worker_data->pbi;
+  VP9_COMMON *const cm = &pbi->common;
+  RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
+  cache_frame *const cached = &ctx->frame_cache[ctx->frame_cache_write];
+
+  frame_worker_data->received_frame = 0;
+  if (vp9_get_raw_frame(pbi, &sd, &flags) != 0 || ctx->need_resync) return;
+
+  lock_buffer_pool(cm->buffer_pool);
+  ++frame_bufs[cm->new_fb_idx].ref_count;
+  unlock_buffer_pool(cm->buffer_pool);
+  cached->fb_idx = cm->new_fb_idx;
+  yuvconfig2image(&cached->img, &sd, frame_worker_data->user_priv);
+  if (pbi->luma_only) clear_chroma_planes(&cached->img);
+  cached->img.fb_priv = frame_bufs[cm->new_fb_idx].raw_frame_buffer.priv;
+  ctx->frame_cache_write = (ctx->frame_cache_write + 1) % FRAME_CACHE_SIZE;
+  ++ctx->num_cache_frames;
 }
 
 static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
@@ -663,7 +858,7 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
   // Only return frame when all the cpu are busy or
   // application fluhsed the decoder in frame parallel decode.
   if (ctx->frame_parallel_decode && ctx->available_threads > 0 &&
-      !ctx->flushed) {
+      !ctx->flushed && ctx->num_cache_frames == 0) {
     return NULL;
   }
 
@@ -671,6 +866,7 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
   if (ctx->num_cache_frames > 0) {
     release_last_output_frame(ctx);
     ctx->last_show_frame = ctx->frame_cache[ctx->frame_cache_read].fb_idx;
+    ctx->hold_last_show_frame = !ctx->frame_parallel_decode;
     if (ctx->need_resync) return NULL;
     img = &ctx->frame_cache[ctx->frame_cache_read].img;
     ctx->frame_cache_read = (ctx->frame_cache_read + 1) % FRAME_CACHE_SIZE;
@@ -688,12 +884,15 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
       VPxWorker *const worker = &ctx->frame_workers[ctx->next_output_worker_id];
       FrameWorkerData *const frame_worker_data =
           (FrameWorkerData *)worker->data1;
+      int worker_ok;
       ctx->next_output_worker_id =
           (ctx->next_output_worker_id + 1) % ctx->num_frame_workers;
       if (ctx->base.init_flags & VPX_CODEC_USE_POSTPROC)
         set_ppflags(ctx, &flags);
       // Wait for the frame from worker thread.
-      if (winterface->sync(worker)) {
+      worker_ok = winterface->sync(worker);
+      release_worker_input(ctx, frame_worker_data);
+      if (worker_ok) {
         // Check if worker has received any frames.
         if (frame_worker_data->received_frame == 1) {
           ++ctx->available_threads;
@@ -707,6 +906,7 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
           ctx->last_show_frame = frame_worker_data->pbi->common.new_fb_idx;
           if (ctx->need_resync) return NULL;
           yuvconfig2image(&ctx->img, &sd, frame_worker_data->user_priv);
+          if (frame_worker_data->pbi->luma_only) clear_chroma_planes(&ctx->img);
           ctx->img.fb_priv = frame_bufs[cm->new_fb_idx].raw_frame_buffer.priv;
           img = &ctx->img;
           return img;
@@ -715,7 +915,7 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
         // Decoding failed. Release the worker thread.
         frame_worker_data->received_frame = 0;
         ++ctx->available_threads;
-        ctx->need_resync = 1;
+        set_worker_error(ctx, frame_worker_data);
         if (ctx->flushed != 1) return NULL;
       }
     } while (ctx->next_output_worker_id != ctx->next_submit_worker_id);
@@ -874,6 +1074,14 @@ static vpx_codec_err_t ctrl_get_frame_corrupted(vpx_codec_alg_priv_t *ctx,
           (FrameWorkerData *)worker->data1;
       RefCntBuffer *const frame_bufs =
           frame_worker_data->pbi->common.buffer_pool->frame_bufs;
+      // In frame parallel decode the workers may still be decoding, so only
+      // the last frame returned to the application is reported.
+      if (ctx->frame_parallel_decode) {
+        *corrupted = (ctx->last_show_frame >= 0)
+                         ? frame_bufs[ctx->last_show_frame].buf.corrupted
+                         : 0;
+        return VPX_CODEC_OK;
+      }
       if (frame_worker_data->pbi->common.frame_to_show == NULL)
         return VPX_CODEC_ERROR;
       if (ctx->last_show_frame >= 0)
@@ -967,6 +1175,31 @@ static vpx_codec_err_t ctrl_set_invert_tile_order(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_input_release_cb(vpx_codec_alg_priv_t *ctx,
+                                                va_list args) {
+  vpx_release_input_init *init = va_arg(args, vpx_release_input_init *);
+  // Workers may still reference compressed data once decoding has started,
+  // so the callback cannot be changed afterwards.
+  if (ctx->frame_workers != NULL) {
+    set_error_detail(ctx, "Input release callback must be set before decoding");
+    return VPX_CODEC_ERROR;
+  }
+  ctx->release_input_cb = init ? init->release_cb : NULL;
+  ctx->release_input_state = init ? init->release_state : NULL;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_thread_pool(vpx_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  // The workers are attached to the pool when they are created.
+  if (ctx->frame_workers != NULL) {
+    set_error_detail(ctx, "Thread pool must be set before decoding");
+    return VPX_CODEC_ERROR;
+  }
+  ctx->thread_pool = va_arg(args, vpx_thread_pool_t *);
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_set_decryptor(vpx_codec_alg_priv_t *ctx,
                                           va_list args) {
   vpx_decrypt_init *init = va_arg(args, vpx_decrypt_init *);
@@ -1010,6 +1243,213 @@ static vpx_codec_err_t ctrl_set_skip_loop_filter(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_row_mt(vpx_codec_alg_priv_t *ctx,
+                                       va_list args) {
+  ctx->row_mt = va_arg(args, int);
+
+  if (ctx->frame_workers) {
+    VPxWorker *const worker = ctx->frame_workers;
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    frame_worker_data->pbi->row_mt = ctx->row_mt;
+  }
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_luma_only(vpx_codec_alg_priv_t *ctx,
+                                          va_list args) {
+  ctx->luma_only = va_arg(args, int);
+
+  if (ctx->frame_workers) {
+    int i;
+    for (i = 0; i < ctx->num_frame_workers; ++i) {
+      VPxWorker *const worker = &ctx->frame_workers[i];
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)worker->data1;
+      frame_worker_data->pbi->luma_only = ctx->luma_only;
+    }
+  }
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_keyframe_only(vpx_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  ctx->keyframe_only = va_arg(args, int);
+
+  if (ctx->frame_workers) {
+    int i;
+    for (i = 0; i < ctx->num_frame_workers; ++i) {
+      VPxWorker *const worker = &ctx->frame_workers[i];
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)worker->data1;
+      frame_worker_data->pbi->keyframe_only = ctx->keyframe_only;
+    }
+  }
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_output_downscale(vpx_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  const int factor = va_arg(args, int);
+  int shift;
+
+  switch (factor) {
+    case 1: shift = 0; break;
+    case 2: shift = 1; break;
+    case 4: shift = 2; break;
+    case 8: shift = 3; break;
+    default: return VPX_CODEC_INVALID_PARAM;
+  }
+  // Frames may be cached before being output in frame parallel mode, so they
+  // can not share a downscaled buffer.
+  if (ctx->frame_parallel_decode && shift > 0) return VPX_CODEC_INCAPABLE;
+
+  ctx->downscale_shift = shift;
+
+  if (ctx->frame_workers) {
+    VPxWorker *const worker = ctx->frame_workers;
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    frame_worker_data->pbi->downscale_shift = ctx->downscale_shift;
+  }
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_perf_stats(vpx_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  ctx->collect_perf_stats = va_arg(args, int);
+
+  if (ctx->frame_workers) {
+    int i;
+    for (i = 0; i < ctx->num_frame_workers; ++i) {
+      VPxWorker *const worker = &ctx->frame_workers[i];
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)worker->data1;
+      frame_worker_data->pbi->collect_perf_stats = ctx->collect_perf_stats;
+    }
+  }
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_rows_decoded_cb(vpx_codec_alg_priv_t *ctx,
+                                                va_list args) {
+  vpx_rows_decoded_init *init = va_arg(args, vpx_rows_decoded_init *);
+
+  // The frames decoded ahead in frame parallel mode have no place in the order
+  // the rows are reported in.
+  if (ctx->frame_parallel_decode) {
+    set_error_detail(ctx, "Not supported in frame parallel decode");
+    return VPX_CODEC_INCAPABLE;
+  }
+
+  ctx->rows_decoded_cb = init ? init->rows_decoded_cb : NULL;
+  ctx->rows_decoded_state = init ? init->rows_decoded_state : NULL;
+
+  if (ctx->frame_workers) {
+    FrameWorkerData *const frame_worker_data =
+        (FrameWorkerData *)ctx->frame_workers[0].data1;
+    frame_worker_data->pbi->rows_decoded_cb =
+        ctx->rows_decoded_cb != NULL ? rows_decoded : NULL;
+    frame_worker_data->pbi->rows_decoded_priv = ctx;
+  }
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_get_perf_stats(vpx_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  vpx_decoder_perf_stats *const stats = va_arg(args, vpx_decoder_perf_stats *);
+
+  // Only support this function in serial decode.
+  if (ctx->frame_parallel_decode) {
+    set_error_detail(ctx, "Not supported in frame parallel decode");
+    return VPX_CODEC_INCAPABLE;
+  }
+
+  if (stats == NULL) return VPX_CODEC_INVALID_PARAM;
+
+  if (ctx->frame_workers) {
+    VPxWorker *const worker = ctx->frame_workers;
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    *stats = frame_worker_data->pbi->perf_stats;
+  } else {
+    memset(stats, 0, sizeof(*stats));
+  }
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_get_memory_usage(vpx_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  vpx_decoder_memory_usage *const usage =
+      va_arg(args, vpx_decoder_memory_usage *);
+  int i;
+
+  if (usage == NULL) return VPX_CODEC_INVALID_PARAM;
+
+  memset(usage, 0, sizeof(*usage));
+  if (ctx->frame_workers) {
+    for (i = 0; i < ctx->num_frame_workers; ++i) {
+      const FrameWorkerData *const frame_worker_data =
+          (const FrameWorkerData *)ctx->frame_workers[i].data1;
+      vp9_decoder_add_memory_usage(frame_worker_data->pbi, usage);
+      usage->other += sizeof(ctx->frame_workers[i]) +
+                      sizeof(*frame_worker_data) +
+                      frame_worker_data->scratch_buffer_size;
+    }
+    vp9_buffer_pool_add_memory_usage(ctx->buffer_pool, usage);
+  }
+  usage->total = usage->frame_buffers + usage->mode_info +
+                 usage->motion_vectors + usage->loop_filter + usage->row_mt +
+                 usage->other;
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_decode_frames(vpx_codec_alg_priv_t *ctx,
+                                          va_list args) {
+  vpx_decode_batch *const batch = va_arg(args, vpx_decode_batch *);
+  int i;
+
+  if (batch == NULL || batch->num_frames < 0 ||
+      (batch->num_frames > 0 && batch->frames == NULL))
+    return VPX_CODEC_INVALID_PARAM;
+  batch->num_decoded = 0;
+  if (ctx->downscale_shift > 0) return VPX_CODEC_INCAPABLE;
+
+  for (i = 0; i < batch->num_frames; ++i) {
+    const vpx_coded_frame *const frame = &batch->frames[i];
+    vpx_codec_err_t res;
+
+    if (frame->data == NULL || frame->data_sz == 0)
+      return VPX_CODEC_INVALID_PARAM;
+
+    // Stop once the frames output by this one may not fit in the cache.
+    if (ctx->frame_parallel_decode) {
+      uint32_t frame_sizes[8];
+      int frame_count = 0;
+      vp9_parse_superframe_index(frame->data, frame->data_sz, frame_sizes,
+                                 &frame_count, ctx->decrypt_cb,
+                                 ctx->decrypt_state);
+      if (ctx->num_cache_frames + VPXMAX(frame_count, 1) > FRAME_CACHE_SIZE)
+        break;
+    } else if (ctx->num_cache_frames >= SERIAL_FRAME_CACHE_SIZE) {
+      break;
+    }
+
+    res = decoder_decode(ctx, frame->data, frame->data_sz, frame->user_priv,
+                         0);
+    ++batch->num_decoded;
+    if (res != VPX_CODEC_OK) return res;
+    if (!ctx->frame_parallel_decode) cache_serial_frame(ctx);
+  }
+
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_set_spatial_layer_svc(vpx_codec_alg_priv_t *ctx,
                                                   va_list args) {
   ctx->svc_decoding = 1;
@@ -1031,6 +1471,15 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP9_SET_BYTE_ALIGNMENT, ctrl_set_byte_alignment },
   { VP9_SET_SKIP_LOOP_FILTER, ctrl_set_skip_loop_filter },
   { VP9_DECODE_SVC_SPATIAL_LAYER, ctrl_set_spatial_layer_svc },
+  { VP9D_SET_ROW_MT, ctrl_set_row_mt },
+  { VP9D_SET_INPUT_RELEASE_CB, ctrl_set_input_release_cb },
+  { VP9D_SET_LUMA_ONLY, ctrl_set_luma_only },
+  { VPXD_SET_KEYFRAME_ONLY, ctrl_set_keyframe_only },
+  { VPXD_SET_OUTPUT_DOWNSCALE, ctrl_set_output_downscale },
+  { VP9D_SET_PERF_STATS, ctrl_set_perf_stats },
+  { VPXD_SET_THREAD_POOL, ctrl_set_thread_pool },
+  { VPXD_SET_ROWS_DECODED_CB, ctrl_set_rows_decoded_cb },
+  { VP9D_DECODE_FRAMES, ctrl_decode_frames },
 
   // Getters
   { VPXD_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -1040,6 +1489,8 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP9D_GET_DISPLAY_SIZE, ctrl_get_render_size },
   { VP9D_GET_BIT_DEPTH, ctrl_get_bit_depth },
   { VP9D_GET_FRAME_SIZE, ctrl_get_frame_size },
+  { VP9D_GET_PERF_STATS, ctrl_get_perf_stats },
+  { VP9D_GET_MEMORY_USAGE, ctrl_get_memory_usage },
 
   { -1, NULL },
 };
@@ -1054,6 +1505,7 @@ CODEC_INTERFACE(vpx_codec_vp9_dx) = {
   VPX_CODEC_CAP_HIGHBITDEPTH |
 #endif
       VPX_CODEC_CAP_DECODER | VP9_CAP_POSTPROC |
+      VP9_CAP_FRAME_THREADING |
       VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER,  // vpx_codec_caps_t
   decoder_init,                             // vpx_codec_init_fn_t
   decoder_destroy,                          // vpx_codec_destroy_fn_t
@@ -19,6 +19,11 @@ typedef vpx_codec_stream_info_t vp9_stream_info_t;
 // TODO(hkuang): Remove this limit after implementing ondemand framebuffers.
 #define FRAME_CACHE_SIZE 6  // Cache maximum 6 decoded frames.
 
+// Frames cached by VP9D_DECODE_FRAMES in serial mode. Together with the
+// reference frames, the last output frame and the frame being decoded, they
+// must fit in the frame buffers.
+#define SERIAL_FRAME_CACHE_SIZE (FRAME_BUFFERS - REF_FRAMES - 2)
+
 typedef struct cache_frame {
   int fb_idx;
   vpx_image_t img;
@@ -32,13 +37,26 @@ struct vpx_codec_alg_priv {
   vp8_postproc_cfg_t postproc_cfg;
   vpx_decrypt_cb decrypt_cb;
   void *decrypt_state;
+  vpx_release_input_cb_fn_t release_input_cb;
+  void *release_input_state;
+  vpx_rows_decoded_cb_fn_t rows_decoded_cb;
+  void *rows_decoded_state;
   vpx_image_t img;
   int img_avail;
   int flushed;
   int invert_tile_order;
   int last_show_frame;  // Index of last output frame.
+  // Whether the decoder holds a reference to the last output frame in serial
+  // mode, as it was returned from the frame cache.
+  int hold_last_show_frame;
   int byte_alignment;
   int skip_loop_filter;
+  int row_mt;
+  int luma_only;
+  int keyframe_only;
+  int downscale_shift;
+  int collect_perf_stats;
+  vpx_thread_pool_t *thread_pool;
 
   // Frame parallel related.
   int frame_parallel_decode;  // frame-based threading.
@@ -53,6 +71,9 @@ struct vpx_codec_alg_priv {
   int frame_cache_read;
   int num_cache_frames;
   int need_resync;  // wait for key/intra-only frame
+  // Error of a frame worker found after its frame was submitted. It is
+  // returned by the next call to decode.
+  vpx_codec_err_t worker_error;
   // BufferPool that holds all reference frames. Shared by all the FrameWorkers.
   BufferPool *buffer_pool;
 
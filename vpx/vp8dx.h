@@ -108,6 +108,8 @@ enum vp8_dec_control_id {
    * integers. The decoder will skip the loop filter when its value is set to
    * nonzero. If the loop filter is skipped the decoder may accumulate decode
    * artifacts. The default value is 0.
+   *
+   * Supported in codecs: VP8, VP9
    */
   VP9_SET_SKIP_LOOP_FILTER,
 
@@ -124,6 +126,143 @@ enum vp8_dec_control_id {
    */
   VPXD_GET_LAST_QUANTIZER,
 
+  /*!\brief Codec control function to enable row based multi-threading.
+   *
+   * When enabled and more than one thread is available, the tiles are parsed
+   * in parallel and the superblock rows are then reconstructed in parallel,
+   * so frames with a single tile column benefit from multiple threads.
+   * Valid values are 0 (disabled, the default) and 1 (enabled).
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_ROW_MT,
+
+  /*!\brief Codec control function to set a release callback for compressed
+   * input buffers.
+   *
+   * When set, the decoder reads the data passed to vpx_codec_decode() in
+   * place instead of copying it, and the buffer must stay valid until the
+   * callback has been invoked for it. Takes a vpx_release_input_init, which
+   * contains a callback function and opaque context pointer. Must be set
+   * before the first call to vpx_codec_decode().
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_INPUT_RELEASE_CB,
+
+  /*!\brief Codec control function to decode the luma plane only.
+   *
+   * When enabled the chroma tokens are still parsed but the chroma planes are
+   * neither predicted, reconstructed nor loop filtered. The returned images
+   * have NULL U and V plane pointers and zero chroma strides. The chroma of
+   * the reference frames is left undefined, so frames decoded after turning
+   * this off again have corrupt chroma until the next key frame.
+   * Valid values are 0 (disabled, the default) and 1 (enabled).
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_LUMA_ONLY,
+
+  /*!\brief Codec control function to decode key frames only.
+   *
+   * When enabled the other frames are dropped right after their frame header
+   * without being decoded, and produce no output. VP9 also decodes the
+   * intra-only frames that reset all the probability contexts, and shows
+   * existing frames unless a dropped frame would have replaced them.
+   * Valid values are 0 (disabled, the default) and 1 (enabled).
+   *
+   * Supported in codecs: VP8, VP9
+   */
+  VPXD_SET_KEYFRAME_ONLY,
+
+  /*!\brief Codec control function to downscale the output frames.
+   *
+   * The decoded frames are box filtered down by the given factor, 1 (the
+   * default), 2, 4 or 8, in both directions before being returned. The
+   * references are not affected. Not available with frame parallel decoding
+   * in VP9.
+   *
+   * Supported in codecs: VP8, VP9
+   */
+  VPXD_SET_OUTPUT_DOWNSCALE,
+
+  /*!\brief Codec control function to enable the collection of per stage
+   * decode timing.
+   *
+   * Timing adds a small overhead to every block so it is off by default.
+   * Valid values are 0 (disabled, the default) and 1 (enabled).
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_PERF_STATS,
+
+  /*!\brief Codec control function to get the decode timing of the last
+   * frame.
+   *
+   * Takes a vpx_decoder_perf_stats, filled in for the last frame decoded by
+   * vpx_codec_decode(), except for the postproc time which is that of the last
+   * frame returned by vpx_codec_get_frame(). The stats are all zero unless
+   * VP9D_SET_PERF_STATS is enabled. Not available with frame parallel
+   * decoding.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_GET_PERF_STATS,
+
+  /*!\brief Codec control function to run the decoder threads on a shared
+   * pool.
+   *
+   * Takes a vpx_thread_pool_t created with vpx_thread_pool_create(), or NULL
+   * for the decoder to create its own threads (the default). The decoder then
+   * creates no threads of its own and queues its work on the pool, using up
+   * to the number of threads given in its vpx_codec_dec_cfg_t, capped at one
+   * more than the number of threads of the pool as the calling thread does
+   * its share. Must be set before the first call to vpx_codec_decode(). Not
+   * used with frame parallel decoding in VP9.
+   *
+   * Supported in codecs: VP8, VP9
+   */
+  VPXD_SET_THREAD_POOL,
+
+  /*!\brief Codec control function to set a callback for the rows of a frame
+   * as they are decoded.
+   *
+   * Takes a vpx_rows_decoded_init, which contains a callback function and
+   * opaque context pointer, or NULL to remove the callback. Not available with
+   * frame parallel decoding in VP9.
+   *
+   * Supported in codecs: VP8, VP9
+   */
+  VPXD_SET_ROWS_DECODED_CB,
+
+  /*!\brief Codec control function to get the memory used by the decoder.
+   *
+   * Takes a vpx_decoder_memory_usage, filled in with the sizes of the buffers
+   * allocated for the current stream. Frame buffers obtained from an external
+   * frame buffer pool are included while the decoder holds them.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_GET_MEMORY_USAGE,
+
+  /*!\brief Codec control function to decode a batch of compressed frames.
+   *
+   * Takes a vpx_decode_batch. Each of its frames is decoded as by a call to
+   * vpx_codec_decode(), and may be a superframe, but the frame it outputs is
+   * appended to a queue instead of having to be retrieved before the next
+   * one is decoded. The queued frames are then returned in order by
+   * vpx_codec_get_frame(), before any other. With frame parallel decoding the
+   * frames of the batch are decoded in parallel.
+   *
+   * The queue is bounded: decoding stops early, with num_decoded less than
+   * num_frames, once it is full, and the application resubmits the remaining
+   * frames after retrieving the queued ones. Queued frames are not
+   * postprocessed, and downscaling is not supported.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_DECODE_FRAMES,
+
   VP8_DECODER_CTRL_ID_MAX
 };
 
@@ -149,6 +288,173 @@ typedef struct vpx_decrypt_init {
  */
 typedef vpx_decrypt_init vp8_decrypt_init;
 
+/*!\brief Release a compressed data buffer passed to vpx_codec_decode().
+ *
+ * Invoked once for every non-empty buffer passed to vpx_codec_decode(), with
+ * the data and user_priv arguments of that call, as soon as the decoder no
+ * longer references the data. In frame parallel mode this may happen during
+ * a later call to vpx_codec_decode(), vpx_codec_get_frame() or
+ * vpx_codec_destroy(). The callback is always invoked from the thread calling
+ * into the decoder.
+ */
+typedef void (*vpx_release_input_cb_fn_t)(void *release_state,
+                                          const unsigned char *data,
+                                          void *user_priv);
+
+/*!\brief Structure to hold the compressed input release callback
+ *
+ * Defines a structure to hold the release state and callback function.
+ */
+typedef struct vpx_release_input_init {
+  /*! Release callback. */
+  vpx_release_input_cb_fn_t release_cb;
+
+  /*! Release state. */
+  void *release_state;
+} vpx_release_input_init;
+
+/*!\brief Notify that rows of the frame being decoded are complete.
+ *
+ * Invoked with the luma rows [row_start, row_end) of img once they have been
+ * reconstructed and loop filtered and will not change anymore, along with the
+ * chroma rows they cover. The ranges of a frame are reported in order and
+ * cover the whole frame. img describes the frame being decoded, before any
+ * postprocessing or downscaling, and its user_priv is that of the call to
+ * vpx_codec_decode(). It is only valid for the duration of the callback, and
+ * frames that are not shown are reported too.
+ *
+ * Rows are reported as soon as they are complete, before the decoder can tell
+ * whether the frame is corrupt. The rows not reported yet when a frame fails
+ * to decode or is found to be corrupt are never reported, so the frame may
+ * stop short of its last row. A failure of vpx_codec_decode(), or with VP8
+ * error concealment VP8D_GET_FRAME_CORRUPTED, tells that the rows reported
+ * for the frame are not valid.
+ *
+ * The callback may be invoked from the decoder threads, but never
+ * concurrently for a decoder instance, so it should return quickly.
+ */
+typedef void (*vpx_rows_decoded_cb_fn_t)(void *rows_decoded_state,
+                                         const vpx_image_t *img,
+                                         unsigned int row_start,
+                                         unsigned int row_end);
+
+/*!\brief Structure to hold the rows decoded callback
+ *
+ * Defines a structure to hold the callback state and function.
+ */
+typedef struct vpx_rows_decoded_init {
+  /*! Rows decoded callback. */
+  vpx_rows_decoded_cb_fn_t rows_decoded_cb;
+
+  /*! Rows decoded callback state. */
+  void *rows_decoded_state;
+} vpx_rows_decoded_init;
+
+/*!\brief Pool of threads shared by decoder instances
+ *
+ * The pool runs the work queued by the decoders attached to it with
+ * VPXD_SET_THREAD_POOL in the order it was queued, so that many decoder
+ * instances can share a fixed number of threads.
+ */
+typedef struct vpx_thread_pool vpx_thread_pool_t;
+
+/*!\brief Create a thread pool
+ *
+ * \param[in] num_threads  Number of threads of the pool, at least 1.
+ *
+ * \return The pool, or NULL on failure or if the library was built without
+ *         thread support.
+ */
+vpx_thread_pool_t *vpx_thread_pool_create(int num_threads);
+
+/*!\brief Destroy a thread pool
+ *
+ * All the decoders attached to the pool must have been destroyed first.
+ *
+ * \param[in] pool  The pool to destroy, may be NULL.
+ */
+void vpx_thread_pool_destroy(vpx_thread_pool_t *pool);
+
+/*!\brief Per stage decode timing
+ *
+ * Times are in microseconds. With multiple threads they are summed over all
+ * the threads, so they may add up to more than the wall clock time of the
+ * frame.
+ */
+typedef struct vpx_decoder_perf_stats {
+  /*! Uncompressed and compressed header parsing and frame setup. */
+  int64_t header_us;
+  /*! Mode and motion vector parsing. */
+  int64_t mode_info_us;
+  /*! Coefficient token parsing and dequantization. */
+  int64_t detokenize_us;
+  /*! Inverse transforms. */
+  int64_t inverse_transform_us;
+  /*! Intra and inter prediction. */
+  int64_t prediction_us;
+  /*! Loop filtering. */
+  int64_t loop_filter_us;
+  /*! Adaptation of the probabilities to the frame and context update. */
+  int64_t adapt_us;
+  /*! Post processing of the output frame. */
+  int64_t postproc_us;
+  /*! Time the decoding threads spent waiting for work or for each other. */
+  int64_t thread_idle_us;
+  /*! Tile layout of the frame. */
+  int tile_rows, tile_cols;
+  /*! Compressed size of each tile, in bytes, indexed [tile_row][tile_col]. */
+  uint32_t tile_bytes[4][64];
+} vpx_decoder_perf_stats;
+
+/*!\brief Decoder memory usage
+ *
+ * Sizes are in bytes. Frame parallel decoding sums the buffers of all the
+ * frame workers.
+ */
+typedef struct vpx_decoder_memory_usage {
+  /*! Reference and output frame buffers, including postprocessing. */
+  size_t frame_buffers;
+  /*! Mode info, its pointer grid and the segmentation maps. */
+  size_t mode_info;
+  /*! Motion vectors kept for the prediction of the next frame. */
+  size_t motion_vectors;
+  /*! Loop filter masks. */
+  size_t loop_filter;
+  /*! Data buffered between the stages of row based multi-threading. */
+  size_t row_mt;
+  /*! Decoder state, entropy contexts and tile worker data. */
+  size_t other;
+  /*! Sum of all of the above. */
+  size_t total;
+} vpx_decoder_memory_usage;
+
+/*!\brief A compressed frame of a batch
+ *
+ * Takes the same arguments as vpx_codec_decode().
+ */
+typedef struct vpx_coded_frame {
+  /*! Compressed data, must not be NULL. */
+  const uint8_t *data;
+  /*! Size of the compressed data, in bytes, must not be 0. */
+  unsigned int data_sz;
+  /*! Application specific data to associate with the frame. */
+  void *user_priv;
+} vpx_coded_frame;
+
+/*!\brief Batch of compressed frames for VP9D_DECODE_FRAMES
+ */
+typedef struct vpx_decode_batch {
+  /*! Frames to decode, in decode order. */
+  const vpx_coded_frame *frames;
+  /*! Number of frames. */
+  int num_frames;
+  /*! Set to the number of frames consumed, including the frame that failed
+   *  to decode on error. The data of these frames is no longer referenced
+   *  unless the input release callback is set.
+   */
+  int num_decoded;
+} vpx_decode_batch;
+
 /*!\cond */
 /*!\brief VP8 decoder control function parameter type
  *
@@ -179,6 +485,28 @@ VPX_CTRL_USE_TYPE(VP9_INVERT_TILE_DECODE_ORDER, int)
 #define VPX_CTRL_VP9_INVERT_TILE_DECODE_ORDER
 #define VPX_CTRL_VP9_DECODE_SVC_SPATIAL_LAYER
 VPX_CTRL_USE_TYPE(VP9_DECODE_SVC_SPATIAL_LAYER, int)
+#define VPX_CTRL_VP9D_SET_ROW_MT
+VPX_CTRL_USE_TYPE(VP9D_SET_ROW_MT, int)
+#define VPX_CTRL_VP9D_SET_INPUT_RELEASE_CB
+VPX_CTRL_USE_TYPE(VP9D_SET_INPUT_RELEASE_CB, vpx_release_input_init *)
+#define VPX_CTRL_VP9D_SET_LUMA_ONLY
+VPX_CTRL_USE_TYPE(VP9D_SET_LUMA_ONLY, int)
+#define VPX_CTRL_VPXD_SET_KEYFRAME_ONLY
+VPX_CTRL_USE_TYPE(VPXD_SET_KEYFRAME_ONLY, int)
+#define VPX_CTRL_VPXD_SET_OUTPUT_DOWNSCALE
+VPX_CTRL_USE_TYPE(VPXD_SET_OUTPUT_DOWNSCALE, int)
+#define VPX_CTRL_VP9D_SET_PERF_STATS
+VPX_CTRL_USE_TYPE(VP9D_SET_PERF_STATS, int)
+#define VPX_CTRL_VP9D_GET_PERF_STATS
+VPX_CTRL_USE_TYPE(VP9D_GET_PERF_STATS, vpx_decoder_perf_stats *)
+#define VPX_CTRL_VPXD_SET_THREAD_POOL
+VPX_CTRL_USE_TYPE(VPXD_SET_THREAD_POOL, vpx_thread_pool_t *)
+#define VPX_CTRL_VPXD_SET_ROWS_DECODED_CB
+VPX_CTRL_USE_TYPE(VPXD_SET_ROWS_DECODED_CB, vpx_rows_decoded_init *)
+#define VPX_CTRL_VP9D_GET_MEMORY_USAGE
+VPX_CTRL_USE_TYPE(VP9D_GET_MEMORY_USAGE, vpx_decoder_memory_usage *)
+#define VPX_CTRL_VP9D_DECODE_FRAMES
+VPX_CTRL_USE_TYPE(VP9D_DECODE_FRAMES, vpx_decode_batch *)
 
 /*!\endcond */
 /*! @} - end defgroup vp8_decoder */
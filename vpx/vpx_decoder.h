@@ -77,7 +77,15 @@ extern "C" {
 /*!\brief The input frame should be passed to the decoder one fragment at a
  * time */
 #define VPX_CODEC_USE_INPUT_FRAGMENTS 0x40000
-/*!\brief Enable frame-based multi-threading */
+/*!\brief Enable frame-based multi-threading
+ *
+ * Up to vpx_codec_dec_cfg_t::threads frames are decoded concurrently, each
+ * waiting only on the reference rows its motion vectors touch. Decoded frames
+ * are returned once all the frame workers are busy, so output lags input by
+ * at most threads - 1 frames. Calling vpx_codec_decode() with a NULL data
+ * pointer flushes the remaining frames. Has no effect with fewer than two
+ * threads or on codecs without #VPX_CODEC_CAP_FRAME_THREADING.
+ */
 #define VPX_CODEC_USE_FRAME_THREADING 0x80000
 
 /*!\brief Stream properties
@@ -102,7 +110,10 @@ typedef struct vpx_codec_stream_info {
 /*!\brief Initialization Configurations
  *
  * This structure is used to pass init time configuration options to the
- * decoder.
+ * decoder. The width and height are an optional hint of the largest frame
+ * size in the stream. When both are set, the VP9 decoder allocates its context
+ * buffers for that size up front, so that resolution changes within it do not
+ * reallocate them.
  */
 typedef struct vpx_codec_dec_cfg {
   unsigned int threads; /**< Maximum number of threads to use, default 1 */
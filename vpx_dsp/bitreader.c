@@ -44,6 +44,8 @@ void vpx_reader_fill(vpx_reader *r) {
   const size_t bytes_left = buffer_end - buffer;
   const size_t bits_left = bytes_left * CHAR_BIT;
   int shift = BD_VALUE_SIZE - CHAR_BIT - (count + CHAR_BIT);
+  int bits_over;
+  int loop_end = 0;
 
   if (r->decrypt_cb) {
     size_t n = VPXMIN(sizeof(r->clear_buffer), bytes_left);
@@ -52,33 +54,21 @@ void vpx_reader_fill(vpx_reader *r) {
     buffer_start = r->clear_buffer;
   }
   if (bits_left > BD_VALUE_SIZE) {
-    const int bits = (shift & 0xfffffff8) + CHAR_BIT;
-    BD_VALUE nv;
-    BD_VALUE big_endian_values;
-    memcpy(&big_endian_values, buffer, sizeof(BD_VALUE));
-#if SIZE_MAX == 0xffffffffffffffffULL
-    big_endian_values = HToBE64(big_endian_values);
-#else
-    big_endian_values = HToBE32(big_endian_values);
-#endif
-    nv = big_endian_values >> (BD_VALUE_SIZE - bits);
-    count += bits;
-    buffer += (bits >> 3);
-    value = r->value | (nv << (shift & 0x7));
-  } else {
-    const int bits_over = (int)(shift + CHAR_BIT - (int)bits_left);
-    int loop_end = 0;
-    if (bits_over >= 0) {
-      count += LOTS_OF_BITS;
-      loop_end = bits_over;
-    }
+    vpx_reader_fill_word(r, buffer);
+    return;
+  }
+
+  bits_over = (int)(shift + CHAR_BIT - (int)bits_left);
+  if (bits_over >= 0) {
+    count += LOTS_OF_BITS;
+    loop_end = bits_over;
+  }
 
-    if (bits_over < 0 || bits_left) {
-      while (shift >= loop_end) {
-        count += CHAR_BIT;
-        value |= (BD_VALUE)*buffer++ << shift;
-        shift -= CHAR_BIT;
-      }
+  if (bits_over < 0 || bits_left) {
+    while (shift >= loop_end) {
+      count += CHAR_BIT;
+      value |= (BD_VALUE)*buffer++ << shift;
+      shift -= CHAR_BIT;
     }
   }
 
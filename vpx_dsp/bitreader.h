@@ -13,12 +13,14 @@
 
 #include <stddef.h>
 #include <limits.h>
+#include <string.h>
 
 #include "./vpx_config.h"
 #include "vpx_ports/mem.h"
 #include "vpx/vp8dx.h"
 #include "vpx/vpx_integer.h"
 #include "vpx_dsp/prob.h"
+#include "vpx_util/endian_inl.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -52,6 +54,35 @@ void vpx_reader_fill(vpx_reader *r);
 
 const uint8_t *vpx_reader_find_end(vpx_reader *r);
 
+// Fills 'value' with a single unaligned word read of 'data', which holds the
+// bytes at 'buffer', decrypted if there is a decrypt callback. The caller
+// must ensure that more than sizeof(BD_VALUE) bytes are left in the buffer.
+// At least BD_VALUE_SIZE - 16 bits are available in 'count' afterwards.
+static INLINE void vpx_reader_fill_word(vpx_reader *r, const uint8_t *data) {
+  const int shift = BD_VALUE_SIZE - CHAR_BIT - (r->count + CHAR_BIT);
+  const int bits = (shift & 0xfffffff8) + CHAR_BIT;
+  BD_VALUE big_endian_values;
+  memcpy(&big_endian_values, data, sizeof(BD_VALUE));
+#if SIZE_MAX == 0xffffffffffffffffULL
+  big_endian_values = HToBE64(big_endian_values);
+#else
+  big_endian_values = HToBE32(big_endian_values);
+#endif
+  r->value |= (big_endian_values >> (BD_VALUE_SIZE - bits)) << (shift & 0x7);
+  r->count += bits;
+  r->buffer += bits >> 3;
+}
+
+// Same as vpx_reader_fill(), with the common case of the word read inlined.
+static INLINE void vpx_reader_refill(vpx_reader *r) {
+  if (!r->decrypt_cb &&
+      (size_t)(r->buffer_end - r->buffer) > sizeof(BD_VALUE)) {
+    vpx_reader_fill_word(r, r->buffer);
+  } else {
+    vpx_reader_fill(r);
+  }
+}
+
 static INLINE int vpx_reader_has_error(vpx_reader *r) {
   // Check if we have reached the end of the buffer.
   //
@@ -1278,10 +1278,6 @@ void vpx_idct32x32_1_add_c(const tran_low_t *input, uint8_t *dest, int stride) {
 
 #if CONFIG_VP9_HIGHBITDEPTH
 
-// 12 signal input bits + 7 2D forward transform amplify bits + 5 1D inverse
-// transform amplify bits + 1 bit for contingency in rounding and quantizing
-#define HIGHBD_VALID_TXFM_MAGNITUDE_RANGE (1 << 25)
-
 static INLINE int detect_invalid_highbd_input(const tran_low_t *input,
                                               int size) {
   int i;
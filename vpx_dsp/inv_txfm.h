@@ -100,6 +100,10 @@ void iadst8_c(const tran_low_t *input, tran_low_t *output);
 void iadst16_c(const tran_low_t *input, tran_low_t *output);
 
 #if CONFIG_VP9_HIGHBITDEPTH
+// 12 signal input bits + 7 2D forward transform amplify bits + 5 1D inverse
+// transform amplify bits + 1 bit for contingency in rounding and quantizing
+#define HIGHBD_VALID_TXFM_MAGNITUDE_RANGE (1 << 25)
+
 void vpx_highbd_idct4_c(const tran_low_t *input, tran_low_t *output, int bd);
 void vpx_highbd_idct8_c(const tran_low_t *input, tran_low_t *output, int bd);
 void vpx_highbd_idct16_c(const tran_low_t *input, tran_low_t *output, int bd);
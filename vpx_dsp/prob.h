@@ -35,6 +35,7 @@ typedef int8_t vpx_tree_index;
 #define vpx_complement(x) (255 - x)
 
 #define MODE_MV_COUNT_SAT 20
+#define MODE_MV_MAX_UPDATE_FACTOR 128
 
 /* We build coding trees compactly in arrays.
    Each node of the tree is a pair of vpx_tree_indices.
@@ -0,0 +1,417 @@
+/*
+ *  Copyright (c) 2017 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <smmintrin.h>
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_dsp/inv_txfm.h"
+#include "vpx_dsp/txfm_common.h"
+#include "vpx_ports/mem.h"
+
+// Each __m128i holds one coefficient of 4 rows or columns as 32 bit values.
+// The products are formed in 64 bits like the tran_high_t arithmetic of
+// highbd_idct32_c(), so the result is exact for any valid input.
+
+// Merges the 64 bit results of lanes 0 and 2 in 'even' and lanes 1 and 3 in
+// 'odd', after rounding them like dct_const_round_shift(). Only the low 32
+// bits are kept, so the logical shift gives the same bits as an arithmetic
+// one.
+static INLINE __m128i round_shift_merge(const __m128i even, const __m128i odd) {
+  const __m128i rounding = _mm_set1_epi64x(DCT_CONST_ROUNDING);
+  const __m128i e =
+      _mm_srli_epi64(_mm_add_epi64(even, rounding), DCT_CONST_BITS);
+  const __m128i o =
+      _mm_srli_epi64(_mm_add_epi64(odd, rounding), DCT_CONST_BITS);
+  return _mm_blend_epi16(e, _mm_slli_epi64(o, 32), 0xcc);
+}
+
+// round(a * c0 + b * c1)
+static INLINE __m128i mul_add_round(const __m128i a, const __m128i b, int c0,
+                                    int c1) {
+  const __m128i k0 = _mm_set1_epi32(c0);
+  const __m128i k1 = _mm_set1_epi32(c1);
+  const __m128i even =
+      _mm_add_epi64(_mm_mul_epi32(a, k0), _mm_mul_epi32(b, k1));
+  const __m128i odd =
+      _mm_add_epi64(_mm_mul_epi32(_mm_srli_epi64(a, 32), k0),
+                    _mm_mul_epi32(_mm_srli_epi64(b, 32), k1));
+  return round_shift_merge(even, odd);
+}
+
+// out0 = round(a * c0 + b * c1), out1 = round(a * c2 + b * c3)
+static INLINE void butterfly(const __m128i a, const __m128i b, int c0, int c1,
+                             int c2, int c3, __m128i *out0, __m128i *out1) {
+  *out0 = mul_add_round(a, b, c0, c1);
+  *out1 = mul_add_round(a, b, c2, c3);
+}
+
+// round(a * c) for a butterfly whose other input is known to be zero.
+static INLINE __m128i mul_round(const __m128i a, int c) {
+  const __m128i k = _mm_set1_epi32(c);
+  return round_shift_merge(_mm_mul_epi32(a, k),
+                           _mm_mul_epi32(_mm_srli_epi64(a, 32), k));
+}
+
+// Lanes in which one of the n inputs is out of the range accepted by
+// highbd_idct32_c(), which outputs zeros for them.
+static INLINE __m128i invalid_lanes(const __m128i *in, int n) {
+  const __m128i max = _mm_set1_epi32(HIGHBD_VALID_TXFM_MAGNITUDE_RANGE - 1);
+  __m128i mask = _mm_setzero_si128();
+  int i;
+
+  for (i = 0; i < n; ++i)
+    mask = _mm_or_si128(mask, _mm_cmpgt_epi32(_mm_abs_epi32(in[i]), max));
+  return mask;
+}
+
+static INLINE void transpose_32bit_4x4(const __m128i in0, const __m128i in1,
+                                       const __m128i in2, const __m128i in3,
+                                       __m128i *out) {
+  const __m128i a0 = _mm_unpacklo_epi32(in0, in1);
+  const __m128i a1 = _mm_unpacklo_epi32(in2, in3);
+  const __m128i a2 = _mm_unpackhi_epi32(in0, in1);
+  const __m128i a3 = _mm_unpackhi_epi32(in2, in3);
+
+  out[0] = _mm_unpacklo_epi64(a0, a1);
+  out[1] = _mm_unpackhi_epi64(a0, a1);
+  out[2] = _mm_unpacklo_epi64(a2, a3);
+  out[3] = _mm_unpackhi_epi64(a2, a3);
+}
+
+// The multiplications of stages 2 to 4 of the idct16 that forms the even
+// half of highbd_idct32_c(). Leaves step2[0..3] after stage 4, step1[4..7]
+// after stage 3 and step2[8..15] after stage 2 in s[].
+static INLINE void idct16_mul(const __m128i *in, __m128i *s) {
+  butterfly(in[1], in[15], cospi_30_64, -cospi_2_64, cospi_2_64, cospi_30_64,
+            &s[8], &s[15]);
+  butterfly(in[9], in[7], cospi_14_64, -cospi_18_64, cospi_18_64, cospi_14_64,
+            &s[9], &s[14]);
+  butterfly(in[5], in[11], cospi_22_64, -cospi_10_64, cospi_10_64,
+            cospi_22_64, &s[10], &s[13]);
+  butterfly(in[13], in[3], cospi_6_64, -cospi_26_64, cospi_26_64, cospi_6_64,
+            &s[11], &s[12]);
+
+  butterfly(in[2], in[14], cospi_28_64, -cospi_4_64, cospi_4_64, cospi_28_64,
+            &s[4], &s[7]);
+  butterfly(in[10], in[6], cospi_12_64, -cospi_20_64, cospi_20_64,
+            cospi_12_64, &s[5], &s[6]);
+
+  butterfly(in[0], in[8], cospi_16_64, cospi_16_64, cospi_16_64, -cospi_16_64,
+            &s[0], &s[1]);
+  butterfly(in[4], in[12], cospi_24_64, -cospi_8_64, cospi_8_64, cospi_24_64,
+            &s[2], &s[3]);
+}
+
+// idct16_mul() when in[8..15] are zero.
+static INLINE void idct16_mul_half(const __m128i *in, __m128i *s) {
+  s[8] = mul_round(in[1], cospi_30_64);
+  s[15] = mul_round(in[1], cospi_2_64);
+  s[9] = mul_round(in[7], -cospi_18_64);
+  s[14] = mul_round(in[7], cospi_14_64);
+  s[10] = mul_round(in[5], cospi_22_64);
+  s[13] = mul_round(in[5], cospi_10_64);
+  s[11] = mul_round(in[3], -cospi_26_64);
+  s[12] = mul_round(in[3], cospi_6_64);
+
+  s[4] = mul_round(in[2], cospi_28_64);
+  s[7] = mul_round(in[2], cospi_4_64);
+  s[5] = mul_round(in[6], -cospi_20_64);
+  s[6] = mul_round(in[6], cospi_12_64);
+
+  s[0] = mul_round(in[0], cospi_16_64);
+  s[1] = s[0];
+  s[2] = mul_round(in[4], cospi_24_64);
+  s[3] = mul_round(in[4], cospi_8_64);
+}
+
+// The rest of the idct16 from the output of idct16_mul().
+static INLINE void idct16_add(const __m128i *s, __m128i *out) {
+  __m128i step1[16], step2[16];
+  int i;
+
+  // stage 3
+  step1[8] = _mm_add_epi32(s[8], s[9]);
+  step1[9] = _mm_sub_epi32(s[8], s[9]);
+  step1[10] = _mm_sub_epi32(s[11], s[10]);
+  step1[11] = _mm_add_epi32(s[10], s[11]);
+  step1[12] = _mm_add_epi32(s[12], s[13]);
+  step1[13] = _mm_sub_epi32(s[12], s[13]);
+  step1[14] = _mm_sub_epi32(s[15], s[14]);
+  step1[15] = _mm_add_epi32(s[14], s[15]);
+
+  // stage 4
+  step2[4] = _mm_add_epi32(s[4], s[5]);
+  step2[5] = _mm_sub_epi32(s[4], s[5]);
+  step2[6] = _mm_sub_epi32(s[7], s[6]);
+  step2[7] = _mm_add_epi32(s[6], s[7]);
+
+  step2[8] = step1[8];
+  step2[15] = step1[15];
+  butterfly(step1[9], step1[14], -cospi_8_64, cospi_24_64, cospi_24_64,
+            cospi_8_64, &step2[9], &step2[14]);
+  butterfly(step1[10], step1[13], -cospi_24_64, -cospi_8_64, -cospi_8_64,
+            cospi_24_64, &step2[10], &step2[13]);
+  step2[11] = step1[11];
+  step2[12] = step1[12];
+
+  // stage 5
+  step1[0] = _mm_add_epi32(s[0], s[3]);
+  step1[1] = _mm_add_epi32(s[1], s[2]);
+  step1[2] = _mm_sub_epi32(s[1], s[2]);
+  step1[3] = _mm_sub_epi32(s[0], s[3]);
+  step1[4] = step2[4];
+  butterfly(step2[5], step2[6], -cospi_16_64, cospi_16_64, cospi_16_64,
+            cospi_16_64, &step1[5], &step1[6]);
+  step1[7] = step2[7];
+
+  step1[8] = _mm_add_epi32(step2[8], step2[11]);
+  step1[9] = _mm_add_epi32(step2[9], step2[10]);
+  step1[10] = _mm_sub_epi32(step2[9], step2[10]);
+  step1[11] = _mm_sub_epi32(step2[8], step2[11]);
+  step1[12] = _mm_sub_epi32(step2[15], step2[12]);
+  step1[13] = _mm_sub_epi32(step2[14], step2[13]);
+  step1[14] = _mm_add_epi32(step2[13], step2[14]);
+  step1[15] = _mm_add_epi32(step2[12], step2[15]);
+
+  // stage 6
+  for (i = 0; i < 4; ++i) {
+    step2[i] = _mm_add_epi32(step1[i], step1[7 - i]);
+    step2[7 - i] = _mm_sub_epi32(step1[i], step1[7 - i]);
+  }
+  step2[8] = step1[8];
+  step2[9] = step1[9];
+  butterfly(step1[10], step1[13], -cospi_16_64, cospi_16_64, cospi_16_64,
+            cospi_16_64, &step2[10], &step2[13]);
+  butterfly(step1[11], step1[12], -cospi_16_64, cospi_16_64, cospi_16_64,
+            cospi_16_64, &step2[11], &step2[12]);
+  step2[14] = step1[14];
+  step2[15] = step1[15];
+
+  // stage 7
+  for (i = 0; i < 8; ++i) {
+    out[i] = _mm_add_epi32(step2[i], step2[15 - i]);
+    out[15 - i] = _mm_sub_epi32(step2[i], step2[15 - i]);
+  }
+}
+
+// The multiplications of stage 1 of highbd_idct32_c(), leaving
+// step1[16..31] in s[].
+static INLINE void idct32_odd_mul(const __m128i *in, __m128i *s) {
+  butterfly(in[1], in[31], cospi_31_64, -cospi_1_64, cospi_1_64, cospi_31_64,
+            &s[16], &s[31]);
+  butterfly(in[17], in[15], cospi_15_64, -cospi_17_64, cospi_17_64,
+            cospi_15_64, &s[17], &s[30]);
+  butterfly(in[9], in[23], cospi_23_64, -cospi_9_64, cospi_9_64, cospi_23_64,
+            &s[18], &s[29]);
+  butterfly(in[25], in[7], cospi_7_64, -cospi_25_64, cospi_25_64, cospi_7_64,
+            &s[19], &s[28]);
+  butterfly(in[5], in[27], cospi_27_64, -cospi_5_64, cospi_5_64, cospi_27_64,
+            &s[20], &s[27]);
+  butterfly(in[21], in[11], cospi_11_64, -cospi_21_64, cospi_21_64,
+            cospi_11_64, &s[21], &s[26]);
+  butterfly(in[13], in[19], cospi_19_64, -cospi_13_64, cospi_13_64,
+            cospi_19_64, &s[22], &s[25]);
+  butterfly(in[29], in[3], cospi_3_64, -cospi_29_64, cospi_29_64, cospi_3_64,
+            &s[23], &s[24]);
+}
+
+// idct32_odd_mul() when in[16..31] are zero.
+static INLINE void idct32_odd_mul_half(const __m128i *in, __m128i *s) {
+  s[16] = mul_round(in[1], cospi_31_64);
+  s[31] = mul_round(in[1], cospi_1_64);
+  s[17] = mul_round(in[15], -cospi_17_64);
+  s[30] = mul_round(in[15], cospi_15_64);
+  s[18] = mul_round(in[9], cospi_23_64);
+  s[29] = mul_round(in[9], cospi_9_64);
+  s[19] = mul_round(in[7], -cospi_25_64);
+  s[28] = mul_round(in[7], cospi_7_64);
+  s[20] = mul_round(in[5], cospi_27_64);
+  s[27] = mul_round(in[5], cospi_5_64);
+  s[21] = mul_round(in[11], -cospi_21_64);
+  s[26] = mul_round(in[11], cospi_11_64);
+  s[22] = mul_round(in[13], cospi_19_64);
+  s[25] = mul_round(in[13], cospi_13_64);
+  s[23] = mul_round(in[3], -cospi_29_64);
+  s[24] = mul_round(in[3], cospi_3_64);
+}
+
+// Stages 2 to 7 of highbd_idct32_c() for step1[16..31], from the output of
+// idct32_odd_mul() in s[16..31].
+static INLINE void idct32_odd_add(__m128i *s) {
+  __m128i step1[32], step2[32];
+  int i;
+
+  // stage 2
+  for (i = 16; i < 32; i += 4) {
+    step2[i] = _mm_add_epi32(s[i], s[i + 1]);
+    step2[i + 1] = _mm_sub_epi32(s[i], s[i + 1]);
+    step2[i + 2] = _mm_sub_epi32(s[i + 3], s[i + 2]);
+    step2[i + 3] = _mm_add_epi32(s[i + 2], s[i + 3]);
+  }
+
+  // stage 3
+  step1[16] = step2[16];
+  step1[31] = step2[31];
+  butterfly(step2[17], step2[30], -cospi_4_64, cospi_28_64, cospi_28_64,
+            cospi_4_64, &step1[17], &step1[30]);
+  butterfly(step2[18], step2[29], -cospi_28_64, -cospi_4_64, -cospi_4_64,
+            cospi_28_64, &step1[18], &step1[29]);
+  step1[19] = step2[19];
+  step1[20] = step2[20];
+  butterfly(step2[21], step2[26], -cospi_20_64, cospi_12_64, cospi_12_64,
+            cospi_20_64, &step1[21], &step1[26]);
+  butterfly(step2[22], step2[25], -cospi_12_64, -cospi_20_64, -cospi_20_64,
+            cospi_12_64, &step1[22], &step1[25]);
+  step1[23] = step2[23];
+  step1[24] = step2[24];
+  step1[27] = step2[27];
+  step1[28] = step2[28];
+
+  // stage 4
+  for (i = 16; i < 32; i += 8) {
+    step2[i] = _mm_add_epi32(step1[i], step1[i + 3]);
+    step2[i + 1] = _mm_add_epi32(step1[i + 1], step1[i + 2]);
+    step2[i + 2] = _mm_sub_epi32(step1[i + 1], step1[i + 2]);
+    step2[i + 3] = _mm_sub_epi32(step1[i], step1[i + 3]);
+    step2[i + 4] = _mm_sub_epi32(step1[i + 7], step1[i + 4]);
+    step2[i + 5] = _mm_sub_epi32(step1[i + 6], step1[i + 5]);
+    step2[i + 6] = _mm_add_epi32(step1[i + 5], step1[i + 6]);
+    step2[i + 7] = _mm_add_epi32(step1[i + 4], step1[i + 7]);
+  }
+
+  // stage 5
+  step1[16] = step2[16];
+  step1[17] = step2[17];
+  butterfly(step2[18], step2[29], -cospi_8_64, cospi_24_64, cospi_24_64,
+            cospi_8_64, &step1[18], &step1[29]);
+  butterfly(step2[19], step2[28], -cospi_8_64, cospi_24_64, cospi_24_64,
+            cospi_8_64, &step1[19], &step1[28]);
+  butterfly(step2[20], step2[27], -cospi_24_64, -cospi_8_64, -cospi_8_64,
+            cospi_24_64, &step1[20], &step1[27]);
+  butterfly(step2[21], step2[26], -cospi_24_64, -cospi_8_64, -cospi_8_64,
+            cospi_24_64, &step1[21], &step1[26]);
+  step1[22] = step2[22];
+  step1[23] = step2[23];
+  step1[24] = step2[24];
+  step1[25] = step2[25];
+  step1[30] = step2[30];
+  step1[31] = step2[31];
+
+  // stage 6
+  for (i = 0; i < 4; ++i) {
+    step2[16 + i] = _mm_add_epi32(step1[16 + i], step1[23 - i]);
+    step2[23 - i] = _mm_sub_epi32(step1[16 + i], step1[23 - i]);
+    step2[24 + i] = _mm_sub_epi32(step1[31 - i], step1[24 + i]);
+    step2[31 - i] = _mm_add_epi32(step1[24 + i], step1[31 - i]);
+  }
+
+  // stage 7
+  for (i = 16; i < 20; ++i) s[i] = step2[i];
+  for (i = 20; i < 24; ++i) {
+    butterfly(step2[i], step2[47 - i], -cospi_16_64, cospi_16_64,
+              cospi_16_64, cospi_16_64, &s[i], &s[47 - i]);
+  }
+  for (i = 28; i < 32; ++i) s[i] = step2[i];
+}
+
+// highbd_idct32_c() of 4 rows or columns. When 'half' is set in[16..31] are
+// known to be zero and are not read.
+static INLINE void idct32(const __m128i *in, __m128i *out, int half) {
+  __m128i even_in[16], even_s[16], even[16], s[32];
+  const __m128i invalid = invalid_lanes(in, half ? 16 : 32);
+  int i;
+
+  for (i = 0; i < (half ? 8 : 16); ++i) even_in[i] = in[2 * i];
+  if (half) {
+    idct16_mul_half(even_in, even_s);
+    idct32_odd_mul_half(in, s);
+  } else {
+    idct16_mul(even_in, even_s);
+    idct32_odd_mul(in, s);
+  }
+  idct16_add(even_s, even);
+  idct32_odd_add(s);
+
+  // final stage
+  for (i = 0; i < 16; ++i) {
+    out[i] = _mm_add_epi32(even[i], s[31 - i]);
+    out[31 - i] = _mm_sub_epi32(even[i], s[31 - i]);
+  }
+  for (i = 0; i < 32; ++i) out[i] = _mm_andnot_si128(invalid, out[i]);
+}
+
+// Adds ROUND_POWER_OF_TWO(in, 6) to 4 pixels of dest and clamps them to bd
+// bits.
+static INLINE void recon_and_store_4(uint16_t *dest, const __m128i in,
+                                     const __m128i max) {
+  const __m128i res = _mm_srai_epi32(_mm_add_epi32(in, _mm_set1_epi32(32)), 6);
+  __m128i d = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)dest));
+  d = _mm_add_epi32(d, res);
+  d = _mm_min_epi32(_mm_max_epi32(d, _mm_setzero_si128()), max);
+  _mm_storel_epi64((__m128i *)dest, _mm_packus_epi32(d, d));
+}
+
+// Inverse transform of a 32x32 block whose non-zero coefficients are all in
+// the upper-left nz x nz corner, nz being 8, 16 or 32.
+static INLINE void highbd_idct32x32_add(const tran_low_t *input,
+                                        uint8_t *dest8, int stride, int bd,
+                                        int nz) {
+  DECLARE_ALIGNED(16, tran_low_t, out[32 * 32]);
+  uint16_t *const dest = CONVERT_TO_SHORTPTR(dest8);
+  const __m128i max = _mm_set1_epi32((1 << bd) - 1);
+  const int half = nz < 32;
+  __m128i in[32], res[32], t[4];
+  int i, j;
+
+  // Rows, 4 at a time.
+  for (i = 0; i < 32; ++i) in[i] = _mm_setzero_si128();
+  for (i = 0; i < nz; i += 4) {
+    const tran_low_t *const src = input + i * 32;
+    for (j = 0; j < nz; j += 4) {
+      transpose_32bit_4x4(_mm_loadu_si128((const __m128i *)(src + j)),
+                          _mm_loadu_si128((const __m128i *)(src + 32 + j)),
+                          _mm_loadu_si128((const __m128i *)(src + 64 + j)),
+                          _mm_loadu_si128((const __m128i *)(src + 96 + j)),
+                          &in[j]);
+    }
+    idct32(in, res, half);
+    for (j = 0; j < 32; j += 4) {
+      transpose_32bit_4x4(res[j], res[j + 1], res[j + 2], res[j + 3], t);
+      _mm_store_si128((__m128i *)(out + i * 32 + j), t[0]);
+      _mm_store_si128((__m128i *)(out + (i + 1) * 32 + j), t[1]);
+      _mm_store_si128((__m128i *)(out + (i + 2) * 32 + j), t[2]);
+      _mm_store_si128((__m128i *)(out + (i + 3) * 32 + j), t[3]);
+    }
+  }
+
+  // Columns, 4 at a time. The rows below nz are zero.
+  for (i = 0; i < 32; i += 4) {
+    for (j = 0; j < nz; ++j)
+      in[j] = _mm_load_si128((const __m128i *)(out + j * 32 + i));
+    idct32(in, res, half);
+    for (j = 0; j < 32; ++j)
+      recon_and_store_4(dest + j * stride + i, res[j], max);
+  }
+}
+
+void vpx_highbd_idct32x32_1024_add_sse4_1(const tran_low_t *input,
+                                          uint8_t *dest8, int stride, int bd) {
+  highbd_idct32x32_add(input, dest8, stride, bd, 32);
+}
+
+void vpx_highbd_idct32x32_135_add_sse4_1(const tran_low_t *input,
+                                         uint8_t *dest8, int stride, int bd) {
+  highbd_idct32x32_add(input, dest8, stride, bd, 16);
+}
+
+void vpx_highbd_idct32x32_34_add_sse4_1(const tran_low_t *input,
+                                        uint8_t *dest8, int stride, int bd) {
+  highbd_idct32x32_add(input, dest8, stride, bd, 8);
+}
@@ -0,0 +1,362 @@
+/*
+ *  Copyright (c) 2017 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_ports/mem.h"
+
+// A register holds the 16 pixels of a dual edge, pixels 0-7 in the low
+// 128-bit lane and pixels 8-15 in the high one, so each half can carry its
+// own thresholds. p[i] and q[i] are the (i + 1)-th pixels on either side of
+// the edge, and shift is bd - 8 throughout.
+
+static INLINE __m256i lpf_set_thresh(const uint8_t *t0, const uint8_t *t1,
+                                     int shift) {
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_set1_epi16((int16_t)(*t0 << shift))),
+      _mm_set1_epi16((int16_t)(*t1 << shift)), 1);
+}
+
+static INLINE __m256i lpf_abs_diff(__m256i a, __m256i b) {
+  return _mm256_abs_epi16(_mm256_sub_epi16(a, b));
+}
+
+// All ones in the lanes that get filtered at all.
+static INLINE __m256i lpf_filter_mask(const __m256i *p, const __m256i *q,
+                                      __m256i blimit, __m256i limit) {
+  const __m256i ff = _mm256_set1_epi16(-1);
+  __m256i max = _mm256_max_epi16(lpf_abs_diff(p[3], p[2]),
+                                 lpf_abs_diff(p[2], p[1]));
+  __m256i edge;
+  max = _mm256_max_epi16(max, lpf_abs_diff(p[1], p[0]));
+  max = _mm256_max_epi16(max, lpf_abs_diff(q[1], q[0]));
+  max = _mm256_max_epi16(max, lpf_abs_diff(q[2], q[1]));
+  max = _mm256_max_epi16(max, lpf_abs_diff(q[3], q[2]));
+  // abs(p0 - q0) * 2 + abs(p1 - q1) / 2
+  edge = _mm256_add_epi16(_mm256_slli_epi16(lpf_abs_diff(p[0], q[0]), 1),
+                          _mm256_srli_epi16(lpf_abs_diff(p[1], q[1]), 1));
+  return _mm256_xor_si256(_mm256_or_si256(_mm256_cmpgt_epi16(max, limit),
+                                          _mm256_cmpgt_epi16(edge, blimit)),
+                          ff);
+}
+
+// All ones in the lanes where p[first..last] and q[first..last] are all
+// within 'one' of p0 and q0 respectively.
+static INLINE __m256i lpf_flat_mask(const __m256i *p, const __m256i *q,
+                                    int first, int last, __m256i one) {
+  __m256i max = _mm256_setzero_si256();
+  int i;
+  for (i = first; i <= last; ++i) {
+    max = _mm256_max_epi16(max, lpf_abs_diff(p[i], p[0]));
+    max = _mm256_max_epi16(max, lpf_abs_diff(q[i], q[0]));
+  }
+  return _mm256_cmpeq_epi16(_mm256_cmpgt_epi16(max, one),
+                            _mm256_setzero_si256());
+}
+
+// The smoothing filter of the flat paths over x[0..n-1], which holds
+// p(n/2-1)..q(n/2-1) in order. Each output is the rounded average of the
+// n - 1 taps centred on its pixel, with the centre counted twice and the ends
+// repeated; out[] gets the filtered x[1..n-2]. The sums wrap at 16 bits, which
+// is harmless as the final ones stay below 16 * 4095 + 8.
+static INLINE void lpf_flat_filter(const __m256i *x, int n, int bits,
+                                   __m256i *out) {
+  const int half = n >> 1;
+  __m256i sum = _mm256_add_epi16(
+      _mm256_mullo_epi16(x[0], _mm256_set1_epi16(half - 1)),
+      _mm256_set1_epi16(1 << (bits - 1)));
+  int i;
+  sum = _mm256_add_epi16(sum, x[1]);
+  for (i = 1; i <= half; ++i) sum = _mm256_add_epi16(sum, x[i]);
+  for (i = 1; i < n - 1; ++i) {
+    out[i - 1] = _mm256_srli_epi16(sum, bits);
+    if (i < n - 2) {
+      const int add = i + half < n ? i + half : n - 1;
+      const int sub = i - half + 1 > 0 ? i - half + 1 : 0;
+      sum = _mm256_add_epi16(sum, _mm256_add_epi16(x[add], x[i + 1]));
+      sum = _mm256_sub_epi16(sum, _mm256_add_epi16(x[sub], x[i]));
+    }
+  }
+}
+
+// The 4-tap filter of vpx_dsp/loopfilter.c on p1..q1, in place.
+static INLINE void lpf_filter4(__m256i *p, __m256i *q, __m256i mask,
+                               __m256i thresh, int shift) {
+  const __m256i t80 = _mm256_set1_epi16(0x80 << shift);
+  const __m256i min = _mm256_set1_epi16(-(0x80 << shift));
+  const __m256i max = _mm256_set1_epi16((0x80 << shift) - 1);
+  const __m256i hev =
+      _mm256_or_si256(_mm256_cmpgt_epi16(lpf_abs_diff(p[1], p[0]), thresh),
+                      _mm256_cmpgt_epi16(lpf_abs_diff(q[1], q[0]), thresh));
+  const __m256i ps1 = _mm256_sub_epi16(p[1], t80);
+  const __m256i ps0 = _mm256_sub_epi16(p[0], t80);
+  const __m256i qs0 = _mm256_sub_epi16(q[0], t80);
+  const __m256i qs1 = _mm256_sub_epi16(q[1], t80);
+  const __m256i work = _mm256_sub_epi16(qs0, ps0);
+  __m256i filter, filter1, filter2;
+
+#define LPF_CLAMP(x) _mm256_min_epi16(_mm256_max_epi16(x, min), max)
+  filter = _mm256_and_si256(LPF_CLAMP(_mm256_sub_epi16(ps1, qs1)), hev);
+  filter = _mm256_add_epi16(filter, _mm256_add_epi16(work, work));
+  filter = _mm256_and_si256(LPF_CLAMP(_mm256_add_epi16(filter, work)), mask);
+  filter1 = _mm256_srai_epi16(
+      LPF_CLAMP(_mm256_add_epi16(filter, _mm256_set1_epi16(4))), 3);
+  filter2 = _mm256_srai_epi16(
+      LPF_CLAMP(_mm256_add_epi16(filter, _mm256_set1_epi16(3))), 3);
+  q[0] = _mm256_add_epi16(LPF_CLAMP(_mm256_sub_epi16(qs0, filter1)), t80);
+  p[0] = _mm256_add_epi16(LPF_CLAMP(_mm256_add_epi16(ps0, filter2)), t80);
+  filter = _mm256_srai_epi16(
+      _mm256_add_epi16(filter1, _mm256_set1_epi16(1)), 1);
+  filter = _mm256_andnot_si256(hev, filter);
+  q[1] = _mm256_add_epi16(LPF_CLAMP(_mm256_sub_epi16(qs1, filter)), t80);
+  p[1] = _mm256_add_epi16(LPF_CLAMP(_mm256_add_epi16(ps1, filter)), t80);
+#undef LPF_CLAMP
+}
+
+// Blends the flat filter output f[] into p[n-1]..q[n-1] where 'flat' is set.
+static INLINE void lpf_blend(__m256i *p, __m256i *q, const __m256i *f, int n,
+                             __m256i flat) {
+  int i;
+  for (i = 0; i < n; ++i) {
+    p[i] = _mm256_blendv_epi8(p[i], f[n - 1 - i], flat);
+    q[i] = _mm256_blendv_epi8(q[i], f[n + i], flat);
+  }
+}
+
+static INLINE void lpf_gather(const __m256i *p, const __m256i *q, int n,
+                              __m256i *x) {
+  int i;
+  for (i = 0; i < n; ++i) {
+    x[n - 1 - i] = p[i];
+    x[n + i] = q[i];
+  }
+}
+
+// p[0..3] and q[0..3] are read, p[0..2] and q[0..2] updated.
+static INLINE void lpf_filter8(__m256i *p, __m256i *q, __m256i mask,
+                               __m256i thresh, int shift) {
+  const __m256i one = _mm256_set1_epi16(1 << shift);
+  const __m256i flat =
+      _mm256_and_si256(lpf_flat_mask(p, q, 1, 3, one), mask);
+
+  if (_mm256_testz_si256(flat, flat)) {
+    lpf_filter4(p, q, mask, thresh, shift);
+  } else {
+    __m256i x[8], f[6];
+    lpf_gather(p, q, 4, x);
+    lpf_flat_filter(x, 8, 3, f);
+    lpf_filter4(p, q, mask, thresh, shift);
+    lpf_blend(p, q, f, 3, flat);
+  }
+}
+
+// p[0..7] and q[0..7] are read, p[0..6] and q[0..6] updated.
+static INLINE void lpf_filter16(__m256i *p, __m256i *q, __m256i mask,
+                                __m256i thresh, int shift) {
+  const __m256i one = _mm256_set1_epi16(1 << shift);
+  const __m256i flat =
+      _mm256_and_si256(lpf_flat_mask(p, q, 1, 3, one), mask);
+
+  if (_mm256_testz_si256(flat, flat)) {
+    lpf_filter4(p, q, mask, thresh, shift);
+  } else {
+    const __m256i flat2 =
+        _mm256_and_si256(lpf_flat_mask(p, q, 4, 7, one), flat);
+    __m256i x[16], f8[6], f16[14];
+    lpf_gather(p, q, 4, x);
+    lpf_flat_filter(x, 8, 3, f8);
+    if (!_mm256_testz_si256(flat2, flat2)) {
+      lpf_gather(p, q, 8, x);
+      lpf_flat_filter(x, 16, 4, f16);
+    }
+    lpf_filter4(p, q, mask, thresh, shift);
+    lpf_blend(p, q, f8, 3, flat);
+    if (!_mm256_testz_si256(flat2, flat2)) lpf_blend(p, q, f16, 7, flat2);
+  }
+}
+
+// Transposes an 8x8 block of 16-bit pixels in each 128-bit lane. Used both
+// ways: rows 0-7 and 8-15 in, columns out, and back.
+static INLINE void transpose_8x8_u16(const __m256i *in, __m256i *out) {
+  const __m256i a0 = _mm256_unpacklo_epi16(in[0], in[1]);
+  const __m256i a1 = _mm256_unpackhi_epi16(in[0], in[1]);
+  const __m256i a2 = _mm256_unpacklo_epi16(in[2], in[3]);
+  const __m256i a3 = _mm256_unpackhi_epi16(in[2], in[3]);
+  const __m256i a4 = _mm256_unpacklo_epi16(in[4], in[5]);
+  const __m256i a5 = _mm256_unpackhi_epi16(in[4], in[5]);
+  const __m256i a6 = _mm256_unpacklo_epi16(in[6], in[7]);
+  const __m256i a7 = _mm256_unpackhi_epi16(in[6], in[7]);
+  const __m256i b0 = _mm256_unpacklo_epi32(a0, a2);
+  const __m256i b1 = _mm256_unpackhi_epi32(a0, a2);
+  const __m256i b2 = _mm256_unpacklo_epi32(a1, a3);
+  const __m256i b3 = _mm256_unpackhi_epi32(a1, a3);
+  const __m256i b4 = _mm256_unpacklo_epi32(a4, a6);
+  const __m256i b5 = _mm256_unpackhi_epi32(a4, a6);
+  const __m256i b6 = _mm256_unpacklo_epi32(a5, a7);
+  const __m256i b7 = _mm256_unpackhi_epi32(a5, a7);
+  out[0] = _mm256_unpacklo_epi64(b0, b4);
+  out[1] = _mm256_unpackhi_epi64(b0, b4);
+  out[2] = _mm256_unpacklo_epi64(b1, b5);
+  out[3] = _mm256_unpackhi_epi64(b1, b5);
+  out[4] = _mm256_unpacklo_epi64(b2, b6);
+  out[5] = _mm256_unpackhi_epi64(b2, b6);
+  out[6] = _mm256_unpacklo_epi64(b3, b7);
+  out[7] = _mm256_unpackhi_epi64(b3, b7);
+}
+
+static INLINE void load_transpose_u16_8x16(const uint16_t *s, int p,
+                                           __m256i *col) {
+  __m256i rows[8];
+  int i;
+  for (i = 0; i < 8; ++i) {
+    rows[i] = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(s + i * p))),
+        _mm_loadu_si128((const __m128i *)(s + (i + 8) * p)), 1);
+  }
+  transpose_8x8_u16(rows, col);
+}
+
+static INLINE void transpose_store_u16_8x16(uint16_t *s, int p,
+                                            const __m256i *col) {
+  __m256i rows[8];
+  int i;
+  transpose_8x8_u16(col, rows);
+  for (i = 0; i < 8; ++i) {
+    _mm_storeu_si128((__m128i *)(s + i * p), _mm256_castsi256_si128(rows[i]));
+    _mm_storeu_si128((__m128i *)(s + (i + 8) * p),
+                     _mm256_extracti128_si256(rows[i], 1));
+  }
+}
+
+static INLINE void load_u16_rows(const uint16_t *s, int p, int n, __m256i *ps,
+                                 __m256i *qs) {
+  int i;
+  for (i = 0; i < n; ++i) {
+    ps[i] = _mm256_loadu_si256((const __m256i *)(s - (i + 1) * p));
+    qs[i] = _mm256_loadu_si256((const __m256i *)(s + i * p));
+  }
+}
+
+static INLINE void store_u16_rows(uint16_t *s, int p, int n, const __m256i *ps,
+                                  const __m256i *qs) {
+  int i;
+  for (i = 0; i < n; ++i) {
+    _mm256_storeu_si256((__m256i *)(s - (i + 1) * p), ps[i]);
+    _mm256_storeu_si256((__m256i *)(s + i * p), qs[i]);
+  }
+}
+
+void vpx_highbd_lpf_horizontal_16_dual_avx2(uint16_t *s, int p,
+                                            const uint8_t *blimit,
+                                            const uint8_t *limit,
+                                            const uint8_t *thresh, int bd) {
+  const int shift = bd - 8;
+  __m256i ps[8], qs[8], mask;
+  load_u16_rows(s, p, 8, ps, qs);
+  mask = lpf_filter_mask(ps, qs, lpf_set_thresh(blimit, blimit, shift),
+                         lpf_set_thresh(limit, limit, shift));
+  lpf_filter16(ps, qs, mask, lpf_set_thresh(thresh, thresh, shift), shift);
+  store_u16_rows(s, p, 7, ps, qs);
+}
+
+void vpx_highbd_lpf_horizontal_8_dual_avx2(
+    uint16_t *s, int p, const uint8_t *blimit0, const uint8_t *limit0,
+    const uint8_t *thresh0, const uint8_t *blimit1, const uint8_t *limit1,
+    const uint8_t *thresh1, int bd) {
+  const int shift = bd - 8;
+  __m256i ps[4], qs[4], mask;
+  load_u16_rows(s, p, 4, ps, qs);
+  mask = lpf_filter_mask(ps, qs, lpf_set_thresh(blimit0, blimit1, shift),
+                         lpf_set_thresh(limit0, limit1, shift));
+  lpf_filter8(ps, qs, mask, lpf_set_thresh(thresh0, thresh1, shift), shift);
+  store_u16_rows(s, p, 3, ps, qs);
+}
+
+void vpx_highbd_lpf_horizontal_4_dual_avx2(
+    uint16_t *s, int p, const uint8_t *blimit0, const uint8_t *limit0,
+    const uint8_t *thresh0, const uint8_t *blimit1, const uint8_t *limit1,
+    const uint8_t *thresh1, int bd) {
+  const int shift = bd - 8;
+  __m256i ps[4], qs[4], mask;
+  load_u16_rows(s, p, 4, ps, qs);
+  mask = lpf_filter_mask(ps, qs, lpf_set_thresh(blimit0, blimit1, shift),
+                         lpf_set_thresh(limit0, limit1, shift));
+  lpf_filter4(ps, qs, mask, lpf_set_thresh(thresh0, thresh1, shift), shift);
+  store_u16_rows(s, p, 2, ps, qs);
+}
+
+void vpx_highbd_lpf_vertical_16_dual_avx2(uint16_t *s, int p,
+                                          const uint8_t *blimit,
+                                          const uint8_t *limit,
+                                          const uint8_t *thresh, int bd) {
+  const int shift = bd - 8;
+  __m256i col[16], ps[8], qs[8], mask;
+  int i;
+  load_transpose_u16_8x16(s - 8, p, col);
+  load_transpose_u16_8x16(s, p, col + 8);
+  for (i = 0; i < 8; ++i) {
+    ps[i] = col[7 - i];
+    qs[i] = col[8 + i];
+  }
+  mask = lpf_filter_mask(ps, qs, lpf_set_thresh(blimit, blimit, shift),
+                         lpf_set_thresh(limit, limit, shift));
+  lpf_filter16(ps, qs, mask, lpf_set_thresh(thresh, thresh, shift), shift);
+  for (i = 0; i < 7; ++i) {
+    col[7 - i] = ps[i];
+    col[8 + i] = qs[i];
+  }
+  transpose_store_u16_8x16(s - 8, p, col);
+  transpose_store_u16_8x16(s, p, col + 8);
+}
+
+void vpx_highbd_lpf_vertical_8_dual_avx2(
+    uint16_t *s, int p, const uint8_t *blimit0, const uint8_t *limit0,
+    const uint8_t *thresh0, const uint8_t *blimit1, const uint8_t *limit1,
+    const uint8_t *thresh1, int bd) {
+  const int shift = bd - 8;
+  __m256i col[8], ps[4], qs[4], mask;
+  int i;
+  load_transpose_u16_8x16(s - 4, p, col);
+  for (i = 0; i < 4; ++i) {
+    ps[i] = col[3 - i];
+    qs[i] = col[4 + i];
+  }
+  mask = lpf_filter_mask(ps, qs, lpf_set_thresh(blimit0, blimit1, shift),
+                         lpf_set_thresh(limit0, limit1, shift));
+  lpf_filter8(ps, qs, mask, lpf_set_thresh(thresh0, thresh1, shift), shift);
+  for (i = 0; i < 3; ++i) {
+    col[3 - i] = ps[i];
+    col[4 + i] = qs[i];
+  }
+  transpose_store_u16_8x16(s - 4, p, col);
+}
+
+void vpx_highbd_lpf_vertical_4_dual_avx2(
+    uint16_t *s, int p, const uint8_t *blimit0, const uint8_t *limit0,
+    const uint8_t *thresh0, const uint8_t *blimit1, const uint8_t *limit1,
+    const uint8_t *thresh1, int bd) {
+  const int shift = bd - 8;
+  __m256i col[8], ps[4], qs[4], mask;
+  int i;
+  load_transpose_u16_8x16(s - 4, p, col);
+  for (i = 0; i < 4; ++i) {
+    ps[i] = col[3 - i];
+    qs[i] = col[4 + i];
+  }
+  mask = lpf_filter_mask(ps, qs, lpf_set_thresh(blimit0, blimit1, shift),
+                         lpf_set_thresh(limit0, limit1, shift));
+  lpf_filter4(ps, qs, mask, lpf_set_thresh(thresh0, thresh1, shift), shift);
+  for (i = 0; i < 2; ++i) {
+    col[3 - i] = ps[i];
+    col[4 + i] = qs[i];
+  }
+  transpose_store_u16_8x16(s - 4, p, col);
+}
@@ -0,0 +1,507 @@
+/*
+ *  Copyright (c) 2017 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_dsp/txfm_common.h"
+
+// Each __m256i holds 16 16 bit values: one row of the block while loading and
+// storing, and one coefficient of 16 rows or columns while transforming.
+
+static INLINE __m256i pair256_set_epi16(int a, int b) {
+  return _mm256_set1_epi32((int)((uint16_t)a | ((uint32_t)(uint16_t)b << 16)));
+}
+
+// Loads 16 coefficients in order, packing them down to 16 bits in high
+// bitdepth builds.
+static INLINE __m256i load_coeff(const tran_low_t *a) {
+#if CONFIG_VP9_HIGHBITDEPTH
+  const __m256i a_lo = _mm256_loadu_si256((const __m256i *)a);
+  const __m256i a_hi = _mm256_loadu_si256((const __m256i *)(a + 8));
+  return _mm256_permute4x64_epi64(_mm256_packs_epi32(a_lo, a_hi), 0xd8);
+#else
+  return _mm256_loadu_si256((const __m256i *)a);
+#endif
+}
+
+// out0 = round(a * c0 + b * c1), out1 = round(a * c2 + b * c3), rounded like
+// dct_const_round_shift().
+static INLINE void butterfly(const __m256i a, const __m256i b, int c0, int c1,
+                             int c2, int c3, __m256i *out0, __m256i *out1) {
+  const __m256i rounding = _mm256_set1_epi32(DCT_CONST_ROUNDING);
+  const __m256i k0 = pair256_set_epi16(c0, c1);
+  const __m256i k1 = pair256_set_epi16(c2, c3);
+  const __m256i lo = _mm256_unpacklo_epi16(a, b);
+  const __m256i hi = _mm256_unpackhi_epi16(a, b);
+  __m256i t0, t1;
+
+  t0 = _mm256_add_epi32(_mm256_madd_epi16(lo, k0), rounding);
+  t1 = _mm256_add_epi32(_mm256_madd_epi16(hi, k0), rounding);
+  t0 = _mm256_srai_epi32(t0, DCT_CONST_BITS);
+  t1 = _mm256_srai_epi32(t1, DCT_CONST_BITS);
+  *out0 = _mm256_packs_epi32(t0, t1);
+
+  t0 = _mm256_add_epi32(_mm256_madd_epi16(lo, k1), rounding);
+  t1 = _mm256_add_epi32(_mm256_madd_epi16(hi, k1), rounding);
+  t0 = _mm256_srai_epi32(t0, DCT_CONST_BITS);
+  t1 = _mm256_srai_epi32(t1, DCT_CONST_BITS);
+  *out1 = _mm256_packs_epi32(t0, t1);
+}
+
+// round(a * c) for a butterfly whose other input is known to be zero. The
+// rounding of _mm256_mulhrs_epi16() by 2 * c matches dct_const_round_shift().
+static INLINE __m256i mul_round(const __m256i a, int c) {
+  return _mm256_mulhrs_epi16(a, _mm256_set1_epi16(2 * c));
+}
+
+// Transposes the 8x8 blocks in each 128 bit lane of in[0..7].
+static INLINE void transpose_8x8_lanes(const __m256i *in, __m256i *out) {
+  const __m256i a0 = _mm256_unpacklo_epi16(in[0], in[1]);
+  const __m256i a1 = _mm256_unpacklo_epi16(in[2], in[3]);
+  const __m256i a2 = _mm256_unpacklo_epi16(in[4], in[5]);
+  const __m256i a3 = _mm256_unpacklo_epi16(in[6], in[7]);
+  const __m256i a4 = _mm256_unpackhi_epi16(in[0], in[1]);
+  const __m256i a5 = _mm256_unpackhi_epi16(in[2], in[3]);
+  const __m256i a6 = _mm256_unpackhi_epi16(in[4], in[5]);
+  const __m256i a7 = _mm256_unpackhi_epi16(in[6], in[7]);
+  const __m256i b0 = _mm256_unpacklo_epi32(a0, a1);
+  const __m256i b1 = _mm256_unpacklo_epi32(a2, a3);
+  const __m256i b2 = _mm256_unpackhi_epi32(a0, a1);
+  const __m256i b3 = _mm256_unpackhi_epi32(a2, a3);
+  const __m256i b4 = _mm256_unpacklo_epi32(a4, a5);
+  const __m256i b5 = _mm256_unpacklo_epi32(a6, a7);
+  const __m256i b6 = _mm256_unpackhi_epi32(a4, a5);
+  const __m256i b7 = _mm256_unpackhi_epi32(a6, a7);
+
+  out[0] = _mm256_unpacklo_epi64(b0, b1);
+  out[1] = _mm256_unpackhi_epi64(b0, b1);
+  out[2] = _mm256_unpacklo_epi64(b2, b3);
+  out[3] = _mm256_unpackhi_epi64(b2, b3);
+  out[4] = _mm256_unpacklo_epi64(b4, b5);
+  out[5] = _mm256_unpackhi_epi64(b4, b5);
+  out[6] = _mm256_unpacklo_epi64(b6, b7);
+  out[7] = _mm256_unpackhi_epi64(b6, b7);
+}
+
+static INLINE void transpose_16x16(const __m256i *in, __m256i *out) {
+  __m256i t0[8], t1[8];
+  int i;
+
+  transpose_8x8_lanes(in, t0);
+  transpose_8x8_lanes(in + 8, t1);
+  for (i = 0; i < 8; ++i) {
+    out[i] = _mm256_permute2x128_si256(t0[i], t1[i], 0x20);
+    out[i + 8] = _mm256_permute2x128_si256(t0[i], t1[i], 0x31);
+  }
+}
+
+// Adds ROUND_POWER_OF_TWO(in, 6) to 16 pixels of dest.
+static INLINE void recon_and_store_16(uint8_t *dest, const __m256i in) {
+  const __m256i res = _mm256_mulhrs_epi16(in, _mm256_set1_epi16(1 << 9));
+  __m256i d = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)dest));
+  d = _mm256_add_epi16(d, res);
+  d = _mm256_permute4x64_epi64(_mm256_packus_epi16(d, d), 0x08);
+  _mm_storeu_si128((__m128i *)dest, _mm256_castsi256_si128(d));
+}
+
+// The multiplications of stages 2 to 4 of idct16_c(). Leaves step2[0..3]
+// after stage 4, step1[4..7] after stage 3 and step2[8..15] after stage 2
+// in s[].
+static INLINE void idct16_mul(const __m256i *in, __m256i *s) {
+  butterfly(in[1], in[15], cospi_30_64, -cospi_2_64, cospi_2_64, cospi_30_64,
+            &s[8], &s[15]);
+  butterfly(in[9], in[7], cospi_14_64, -cospi_18_64, cospi_18_64, cospi_14_64,
+            &s[9], &s[14]);
+  butterfly(in[5], in[11], cospi_22_64, -cospi_10_64, cospi_10_64,
+            cospi_22_64, &s[10], &s[13]);
+  butterfly(in[13], in[3], cospi_6_64, -cospi_26_64, cospi_26_64, cospi_6_64,
+            &s[11], &s[12]);
+
+  butterfly(in[2], in[14], cospi_28_64, -cospi_4_64, cospi_4_64, cospi_28_64,
+            &s[4], &s[7]);
+  butterfly(in[10], in[6], cospi_12_64, -cospi_20_64, cospi_20_64,
+            cospi_12_64, &s[5], &s[6]);
+
+  butterfly(in[0], in[8], cospi_16_64, cospi_16_64, cospi_16_64, -cospi_16_64,
+            &s[0], &s[1]);
+  butterfly(in[4], in[12], cospi_24_64, -cospi_8_64, cospi_8_64, cospi_24_64,
+            &s[2], &s[3]);
+}
+
+// idct16_mul() when in[8..15] are zero.
+static INLINE void idct16_mul_half(const __m256i *in, __m256i *s) {
+  s[8] = mul_round(in[1], cospi_30_64);
+  s[15] = mul_round(in[1], cospi_2_64);
+  s[9] = mul_round(in[7], -cospi_18_64);
+  s[14] = mul_round(in[7], cospi_14_64);
+  s[10] = mul_round(in[5], cospi_22_64);
+  s[13] = mul_round(in[5], cospi_10_64);
+  s[11] = mul_round(in[3], -cospi_26_64);
+  s[12] = mul_round(in[3], cospi_6_64);
+
+  s[4] = mul_round(in[2], cospi_28_64);
+  s[7] = mul_round(in[2], cospi_4_64);
+  s[5] = mul_round(in[6], -cospi_20_64);
+  s[6] = mul_round(in[6], cospi_12_64);
+
+  s[0] = mul_round(in[0], cospi_16_64);
+  s[1] = s[0];
+  s[2] = mul_round(in[4], cospi_24_64);
+  s[3] = mul_round(in[4], cospi_8_64);
+}
+
+// The rest of idct16_c() from the output of idct16_mul().
+static INLINE void idct16_add(const __m256i *s, __m256i *out) {
+  __m256i step1[16], step2[16];
+  int i;
+
+  // stage 3
+  step1[8] = _mm256_add_epi16(s[8], s[9]);
+  step1[9] = _mm256_sub_epi16(s[8], s[9]);
+  step1[10] = _mm256_sub_epi16(s[11], s[10]);
+  step1[11] = _mm256_add_epi16(s[10], s[11]);
+  step1[12] = _mm256_add_epi16(s[12], s[13]);
+  step1[13] = _mm256_sub_epi16(s[12], s[13]);
+  step1[14] = _mm256_sub_epi16(s[15], s[14]);
+  step1[15] = _mm256_add_epi16(s[14], s[15]);
+
+  // stage 4
+  step2[4] = _mm256_add_epi16(s[4], s[5]);
+  step2[5] = _mm256_sub_epi16(s[4], s[5]);
+  step2[6] = _mm256_sub_epi16(s[7], s[6]);
+  step2[7] = _mm256_add_epi16(s[6], s[7]);
+
+  step2[8] = step1[8];
+  step2[15] = step1[15];
+  butterfly(step1[9], step1[14], -cospi_8_64, cospi_24_64, cospi_24_64,
+            cospi_8_64, &step2[9], &step2[14]);
+  butterfly(step1[10], step1[13], -cospi_24_64, -cospi_8_64, -cospi_8_64,
+            cospi_24_64, &step2[10], &step2[13]);
+  step2[11] = step1[11];
+  step2[12] = step1[12];
+
+  // stage 5
+  step1[0] = _mm256_add_epi16(s[0], s[3]);
+  step1[1] = _mm256_add_epi16(s[1], s[2]);
+  step1[2] = _mm256_sub_epi16(s[1], s[2]);
+  step1[3] = _mm256_sub_epi16(s[0], s[3]);
+  step1[4] = step2[4];
+  butterfly(step2[5], step2[6], -cospi_16_64, cospi_16_64, cospi_16_64,
+            cospi_16_64, &step1[5], &step1[6]);
+  step1[7] = step2[7];
+
+  step1[8] = _mm256_add_epi16(step2[8], step2[11]);
+  step1[9] = _mm256_add_epi16(step2[9], step2[10]);
+  step1[10] = _mm256_sub_epi16(step2[9], step2[10]);
+  step1[11] = _mm256_sub_epi16(step2[8], step2[11]);
+  step1[12] = _mm256_sub_epi16(step2[15], step2[12]);
+  step1[13] = _mm256_sub_epi16(step2[14], step2[13]);
+  step1[14] = _mm256_add_epi16(step2[13], step2[14]);
+  step1[15] = _mm256_add_epi16(step2[12], step2[15]);
+
+  // stage 6
+  for (i = 0; i < 4; ++i) {
+    step2[i] = _mm256_add_epi16(step1[i], step1[7 - i]);
+    step2[7 - i] = _mm256_sub_epi16(step1[i], step1[7 - i]);
+  }
+  step2[8] = step1[8];
+  step2[9] = step1[9];
+  butterfly(step1[10], step1[13], -cospi_16_64, cospi_16_64, cospi_16_64,
+            cospi_16_64, &step2[10], &step2[13]);
+  butterfly(step1[11], step1[12], -cospi_16_64, cospi_16_64, cospi_16_64,
+            cospi_16_64, &step2[11], &step2[12]);
+  step2[14] = step1[14];
+  step2[15] = step1[15];
+
+  // stage 7
+  for (i = 0; i < 8; ++i) {
+    out[i] = _mm256_add_epi16(step2[i], step2[15 - i]);
+    out[15 - i] = _mm256_sub_epi16(step2[i], step2[15 - i]);
+  }
+}
+
+static void idct16(const __m256i *in, __m256i *out) {
+  __m256i s[16];
+  idct16_mul(in, s);
+  idct16_add(s, out);
+}
+
+// idct16() when in[8..15] are zero.
+static void idct16_half(const __m256i *in, __m256i *out) {
+  __m256i s[16];
+  idct16_mul_half(in, s);
+  idct16_add(s, out);
+}
+
+void vpx_idct16x16_256_add_avx2(const tran_low_t *input, uint8_t *dest,
+                                int stride) {
+  __m256i in[16], out[16];
+  int i;
+
+  for (i = 0; i < 16; ++i) in[i] = load_coeff(input + i * 16);
+
+  // Rows
+  transpose_16x16(in, out);
+  idct16(out, in);
+
+  // Columns
+  transpose_16x16(in, out);
+  idct16(out, in);
+
+  for (i = 0; i < 16; ++i) recon_and_store_16(dest + i * stride, in[i]);
+}
+
+void vpx_idct16x16_38_add_avx2(const tran_low_t *input, uint8_t *dest,
+                               int stride) {
+  __m256i in[16], out[16];
+  int i;
+
+  // Only the upper-left 8x8 has non-zero coefficients, so after transposing
+  // the first 8 rows within each lane the upper lanes hold the zero rows
+  // 8 to 15.
+  for (i = 0; i < 8; ++i) in[i] = load_coeff(input + i * 16);
+
+  // Rows
+  transpose_8x8_lanes(in, out);
+  idct16_half(out, in);
+
+  // Columns
+  transpose_16x16(in, out);
+  idct16_half(out, in);
+
+  for (i = 0; i < 16; ++i) recon_and_store_16(dest + i * stride, in[i]);
+}
+
+// The multiplications of stage 1 of idct32_c(), leaving step1[16..31] in s[].
+static INLINE void idct32_odd_mul(const __m256i *in, __m256i *s) {
+  butterfly(in[1], in[31], cospi_31_64, -cospi_1_64, cospi_1_64, cospi_31_64,
+            &s[16], &s[31]);
+  butterfly(in[17], in[15], cospi_15_64, -cospi_17_64, cospi_17_64,
+            cospi_15_64, &s[17], &s[30]);
+  butterfly(in[9], in[23], cospi_23_64, -cospi_9_64, cospi_9_64, cospi_23_64,
+            &s[18], &s[29]);
+  butterfly(in[25], in[7], cospi_7_64, -cospi_25_64, cospi_25_64, cospi_7_64,
+            &s[19], &s[28]);
+  butterfly(in[5], in[27], cospi_27_64, -cospi_5_64, cospi_5_64, cospi_27_64,
+            &s[20], &s[27]);
+  butterfly(in[21], in[11], cospi_11_64, -cospi_21_64, cospi_21_64,
+            cospi_11_64, &s[21], &s[26]);
+  butterfly(in[13], in[19], cospi_19_64, -cospi_13_64, cospi_13_64,
+            cospi_19_64, &s[22], &s[25]);
+  butterfly(in[29], in[3], cospi_3_64, -cospi_29_64, cospi_29_64, cospi_3_64,
+            &s[23], &s[24]);
+}
+
+// idct32_odd_mul() when in[16..31] are zero.
+static INLINE void idct32_odd_mul_half(const __m256i *in, __m256i *s) {
+  s[16] = mul_round(in[1], cospi_31_64);
+  s[31] = mul_round(in[1], cospi_1_64);
+  s[17] = mul_round(in[15], -cospi_17_64);
+  s[30] = mul_round(in[15], cospi_15_64);
+  s[18] = mul_round(in[9], cospi_23_64);
+  s[29] = mul_round(in[9], cospi_9_64);
+  s[19] = mul_round(in[7], -cospi_25_64);
+  s[28] = mul_round(in[7], cospi_7_64);
+  s[20] = mul_round(in[5], cospi_27_64);
+  s[27] = mul_round(in[5], cospi_5_64);
+  s[21] = mul_round(in[11], -cospi_21_64);
+  s[26] = mul_round(in[11], cospi_11_64);
+  s[22] = mul_round(in[13], cospi_19_64);
+  s[25] = mul_round(in[13], cospi_13_64);
+  s[23] = mul_round(in[3], -cospi_29_64);
+  s[24] = mul_round(in[3], cospi_3_64);
+}
+
+// Stages 2 to 7 of idct32_c() for step1[16..31], from the output of
+// idct32_odd_mul() in s[16..31].
+static INLINE void idct32_odd_add(__m256i *s) {
+  __m256i step1[32], step2[32];
+  int i;
+
+  // stage 2
+  for (i = 16; i < 32; i += 4) {
+    step2[i] = _mm256_add_epi16(s[i], s[i + 1]);
+    step2[i + 1] = _mm256_sub_epi16(s[i], s[i + 1]);
+    step2[i + 2] = _mm256_sub_epi16(s[i + 3], s[i + 2]);
+    step2[i + 3] = _mm256_add_epi16(s[i + 2], s[i + 3]);
+  }
+
+  // stage 3
+  step1[16] = step2[16];
+  step1[31] = step2[31];
+  butterfly(step2[17], step2[30], -cospi_4_64, cospi_28_64, cospi_28_64,
+            cospi_4_64, &step1[17], &step1[30]);
+  butterfly(step2[18], step2[29], -cospi_28_64, -cospi_4_64, -cospi_4_64,
+            cospi_28_64, &step1[18], &step1[29]);
+  step1[19] = step2[19];
+  step1[20] = step2[20];
+  butterfly(step2[21], step2[26], -cospi_20_64, cospi_12_64, cospi_12_64,
+            cospi_20_64, &step1[21], &step1[26]);
+  butterfly(step2[22], step2[25], -cospi_12_64, -cospi_20_64, -cospi_20_64,
+            cospi_12_64, &step1[22], &step1[25]);
+  step1[23] = step2[23];
+  step1[24] = step2[24];
+  step1[27] = step2[27];
+  step1[28] = step2[28];
+
+  // stage 4
+  for (i = 16; i < 32; i += 8) {
+    step2[i] = _mm256_add_epi16(step1[i], step1[i + 3]);
+    step2[i + 1] = _mm256_add_epi16(step1[i + 1], step1[i + 2]);
+    step2[i + 2] = _mm256_sub_epi16(step1[i + 1], step1[i + 2]);
+    step2[i + 3] = _mm256_sub_epi16(step1[i], step1[i + 3]);
+    step2[i + 4] = _mm256_sub_epi16(step1[i + 7], step1[i + 4]);
+    step2[i + 5] = _mm256_sub_epi16(step1[i + 6], step1[i + 5]);
+    step2[i + 6] = _mm256_add_epi16(step1[i + 5], step1[i + 6]);
+    step2[i + 7] = _mm256_add_epi16(step1[i + 4], step1[i + 7]);
+  }
+
+  // stage 5
+  step1[16] = step2[16];
+  step1[17] = step2[17];
+  butterfly(step2[18], step2[29], -cospi_8_64, cospi_24_64, cospi_24_64,
+            cospi_8_64, &step1[18], &step1[29]);
+  butterfly(step2[19], step2[28], -cospi_8_64, cospi_24_64, cospi_24_64,
+            cospi_8_64, &step1[19], &step1[28]);
+  butterfly(step2[20], step2[27], -cospi_24_64, -cospi_8_64, -cospi_8_64,
+            cospi_24_64, &step1[20], &step1[27]);
+  butterfly(step2[21], step2[26], -cospi_24_64, -cospi_8_64, -cospi_8_64,
+            cospi_24_64, &step1[21], &step1[26]);
+  step1[22] = step2[22];
+  step1[23] = step2[23];
+  step1[24] = step2[24];
+  step1[25] = step2[25];
+  step1[30] = step2[30];
+  step1[31] = step2[31];
+
+  // stage 6
+  for (i = 0; i < 4; ++i) {
+    step2[16 + i] = _mm256_add_epi16(step1[16 + i], step1[23 - i]);
+    step2[23 - i] = _mm256_sub_epi16(step1[16 + i], step1[23 - i]);
+    step2[24 + i] = _mm256_sub_epi16(step1[31 - i], step1[24 + i]);
+    step2[31 - i] = _mm256_add_epi16(step1[24 + i], step1[31 - i]);
+  }
+
+  // stage 7
+  for (i = 16; i < 20; ++i) s[i] = step2[i];
+  for (i = 20; i < 24; ++i) {
+    butterfly(step2[i], step2[47 - i], -cospi_16_64, cospi_16_64,
+              cospi_16_64, cospi_16_64, &s[i], &s[47 - i]);
+  }
+  for (i = 28; i < 32; ++i) s[i] = step2[i];
+}
+
+static void idct32(const __m256i *in, __m256i *out) {
+  __m256i even_in[16], even[16], s[32];
+  int i;
+
+  for (i = 0; i < 16; ++i) even_in[i] = in[2 * i];
+  idct16(even_in, even);
+  idct32_odd_mul(in, s);
+  idct32_odd_add(s);
+
+  // final stage
+  for (i = 0; i < 16; ++i) {
+    out[i] = _mm256_add_epi16(even[i], s[31 - i]);
+    out[31 - i] = _mm256_sub_epi16(even[i], s[31 - i]);
+  }
+}
+
+// idct32() when in[16..31] are zero.
+static void idct32_half(const __m256i *in, __m256i *out) {
+  __m256i even_in[8], even[16], s[32];
+  int i;
+
+  for (i = 0; i < 8; ++i) even_in[i] = in[2 * i];
+  idct16_half(even_in, even);
+  idct32_odd_mul_half(in, s);
+  idct32_odd_add(s);
+
+  // final stage
+  for (i = 0; i < 16; ++i) {
+    out[i] = _mm256_add_epi16(even[i], s[31 - i]);
+    out[31 - i] = _mm256_sub_epi16(even[i], s[31 - i]);
+  }
+}
+
+// Reconstructs 32 columns from the first pass output of the upper 16 rows in
+// left[] (columns 0 to 15) and right[] (columns 16 to 31), when the lower 16
+// rows are zero.
+static void idct32_columns_half(const __m256i *left, const __m256i *right,
+                                uint8_t *dest, int stride) {
+  __m256i out[32];
+  int i;
+
+  idct32_half(left, out);
+  for (i = 0; i < 32; ++i) recon_and_store_16(dest + i * stride, out[i]);
+  idct32_half(right, out);
+  for (i = 0; i < 32; ++i) recon_and_store_16(dest + i * stride + 16, out[i]);
+}
+
+void vpx_idct32x32_1024_add_avx2(const tran_low_t *input, uint8_t *dest,
+                                 int stride) {
+  __m256i rows[32], left[32], right[32], in[32], out[32];
+  int i, j;
+
+  // Rows, 16 at a time.
+  for (i = 0; i < 32; i += 16) {
+    for (j = 0; j < 16; ++j) {
+      rows[j] = load_coeff(input + (i + j) * 32);
+      rows[j + 16] = load_coeff(input + (i + j) * 32 + 16);
+    }
+    transpose_16x16(rows, in);
+    transpose_16x16(rows + 16, in + 16);
+    idct32(in, out);
+    transpose_16x16(out, left + i);
+    transpose_16x16(out + 16, right + i);
+  }
+
+  // Columns, 16 at a time.
+  idct32(left, out);
+  for (i = 0; i < 32; ++i) recon_and_store_16(dest + i * stride, out[i]);
+  idct32(right, out);
+  for (i = 0; i < 32; ++i) recon_and_store_16(dest + i * stride + 16, out[i]);
+}
+
+void vpx_idct32x32_135_add_avx2(const tran_low_t *input, uint8_t *dest,
+                                int stride) {
+  __m256i rows[16], in[16], out[32];
+  int i;
+
+  // Rows: only the upper-left 16x16 has non-zero coefficients.
+  for (i = 0; i < 16; ++i) rows[i] = load_coeff(input + i * 32);
+  transpose_16x16(rows, in);
+  idct32_half(in, out);
+  transpose_16x16(out, rows);
+  transpose_16x16(out + 16, in);
+
+  // Columns
+  idct32_columns_half(rows, in, dest, stride);
+}
+
+void vpx_idct32x32_34_add_avx2(const tran_low_t *input, uint8_t *dest,
+                               int stride) {
+  __m256i rows[16], in[16], out[32];
+  int i;
+
+  // Rows: only the upper-left 8x8 has non-zero coefficients, so after
+  // transposing the first 8 rows within each lane the upper lanes hold the
+  // zero rows 8 to 15.
+  for (i = 0; i < 8; ++i) rows[i] = load_coeff(input + i * 32);
+  transpose_8x8_lanes(rows, in);
+  for (i = 8; i < 16; ++i) in[i] = _mm256_setzero_si256();
+  idct32_half(in, out);
+  transpose_16x16(out, rows);
+  transpose_16x16(out + 16, in);
+
+  // Columns
+  idct32_columns_half(rows, in, dest, stride);
+}
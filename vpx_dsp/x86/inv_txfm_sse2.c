@@ -3913,8 +3913,11 @@ void vpx_highbd_idct16x16_10_add_sse2(const tran_low_t *input, uint8_t *dest8,
   }
 }
 
-void vpx_highbd_idct32x32_1_add_sse2(const tran_low_t *input, uint8_t *dest8,
-                                     int stride, int bd) {
+// Adds the DC only inverse transform of a size x size block to dest. The
+// final rounding is by 'shift' bits.
+static INLINE void highbd_idct_dc_add(const tran_low_t *input, uint8_t *dest8,
+                                      int stride, int bd, int size,
+                                      int shift) {
   __m128i dc_value, d;
   const __m128i zero = _mm_setzero_si128();
   const __m128i one = _mm_set1_epi16(1);
@@ -3925,19 +3928,47 @@ void vpx_highbd_idct32x32_1_add_sse2(const tran_low_t *input, uint8_t *dest8,
 
   out = HIGHBD_WRAPLOW(dct_const_round_shift(input[0] * cospi_16_64), bd);
   out = HIGHBD_WRAPLOW(dct_const_round_shift(out * cospi_16_64), bd);
-  a = ROUND_POWER_OF_TWO(out, 6);
+  a = ROUND_POWER_OF_TWO(out, shift);
 
   d = _mm_set1_epi32(a);
   dc_value = _mm_packs_epi32(d, d);
-  for (i = 0; i < 32; ++i) {
-    for (j = 0; j < 4; ++j) {
-      d = _mm_loadu_si128((const __m128i *)(&dest[j * 8]));
+  for (i = 0; i < size; ++i) {
+    if (size == 4) {
+      d = _mm_loadl_epi64((const __m128i *)dest);
       d = _mm_adds_epi16(d, dc_value);
       d = _mm_max_epi16(d, zero);
       d = _mm_min_epi16(d, max);
-      _mm_storeu_si128((__m128i *)(&dest[j * 8]), d);
+      _mm_storel_epi64((__m128i *)dest, d);
+    } else {
+      for (j = 0; j < size; j += 8) {
+        d = _mm_loadu_si128((const __m128i *)(&dest[j]));
+        d = _mm_adds_epi16(d, dc_value);
+        d = _mm_max_epi16(d, zero);
+        d = _mm_min_epi16(d, max);
+        _mm_storeu_si128((__m128i *)(&dest[j]), d);
+      }
     }
     dest += stride;
   }
 }
+
+void vpx_highbd_idct4x4_1_add_sse2(const tran_low_t *input, uint8_t *dest8,
+                                   int stride, int bd) {
+  highbd_idct_dc_add(input, dest8, stride, bd, 4, 4);
+}
+
+void vpx_highbd_idct8x8_1_add_sse2(const tran_low_t *input, uint8_t *dest8,
+                                   int stride, int bd) {
+  highbd_idct_dc_add(input, dest8, stride, bd, 8, 5);
+}
+
+void vpx_highbd_idct16x16_1_add_sse2(const tran_low_t *input, uint8_t *dest8,
+                                     int stride, int bd) {
+  highbd_idct_dc_add(input, dest8, stride, bd, 16, 6);
+}
+
+void vpx_highbd_idct32x32_1_add_sse2(const tran_low_t *input, uint8_t *dest8,
+                                     int stride, int bd) {
+  highbd_idct_dc_add(input, dest8, stride, bd, 32, 6);
+}
 #endif  // CONFIG_VP9_HIGHBITDEPTH
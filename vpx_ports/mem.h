@@ -27,6 +27,12 @@
 #define __builtin_prefetch(x)
 #endif
 
+#if defined(__GNUC__) && __GNUC__
+#define VPX_PREFETCH(x) __builtin_prefetch(x)
+#else
+#define VPX_PREFETCH(x) (void)(x)
+#endif
+
 /* Shift down with rounding */
 #define ROUND_POWER_OF_TWO(value, n) (((value) + (1 << ((n)-1))) >> (n))
 #define ROUND64_POWER_OF_TWO(value, n) (((value) + (1ULL << ((n)-1))) >> (n))
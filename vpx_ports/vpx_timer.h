@@ -32,6 +32,7 @@
  * POSIX specific includes
  */
 #include <sys/time.h>
+#include <time.h>
 
 /* timersub is not provided by msys at this time. */
 #ifndef timersub
@@ -87,6 +88,28 @@ static INLINE int64_t vpx_usec_timer_elapsed(struct vpx_usec_timer *t) {
 #endif
 }
 
+/* Returns a monotonic timestamp in nanoseconds, for timing short intervals. */
+static INLINE int64_t vpx_nsec_timer_now(void) {
+#if defined(_WIN32)
+  LARGE_INTEGER count, freq;
+
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&freq);
+  return count.QuadPart / freq.QuadPart * 1000000000 +
+         count.QuadPart % freq.QuadPart * 1000000000 / freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000000000 + (int64_t)tv.tv_usec * 1000;
+#endif
+}
+
 #else /* CONFIG_OS_SUPPORT = 0*/
 
 /* Empty timer functions if CONFIG_OS_SUPPORT = 0 */
@@ -104,6 +127,8 @@ static INLINE void vpx_usec_timer_mark(struct vpx_usec_timer *t) {}
 
 static INLINE int vpx_usec_timer_elapsed(struct vpx_usec_timer *t) { return 0; }
 
+static INLINE int64_t vpx_nsec_timer_now(void) { return 0; }
+
 #endif /* CONFIG_OS_SUPPORT */
 
 #endif  // VPX_PORTS_VPX_TIMER_H_
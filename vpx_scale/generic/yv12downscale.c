@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2017 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include "./vpx_config.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_ports/mem.h"
+#include "vpx_scale/vpx_scale.h"
+#include "vpx_scale/yv12config.h"
+
+/* Each destination pixel is the rounded average of the (1 << shift) square
+ * block of source pixels it covers. Blocks crossing the right or bottom edge
+ * of the source only average the pixels inside it.
+ */
+static void downscale_plane(const uint8_t *src, int src_stride, int src_w,
+                            int src_h, uint8_t *dst, int dst_stride, int dst_w,
+                            int dst_h, int shift) {
+  int x, y, i, j;
+
+  for (y = 0; y < dst_h; ++y) {
+    const int y0 = VPXMIN(y << shift, src_h - 1);
+    const int y1 = VPXMIN((y + 1) << shift, src_h);
+    for (x = 0; x < dst_w; ++x) {
+      const int x0 = VPXMIN(x << shift, src_w - 1);
+      const int x1 = VPXMIN((x + 1) << shift, src_w);
+      const int count = (y1 - y0) * (x1 - x0);
+      const uint8_t *s = src + y0 * src_stride;
+      int sum = 0;
+      for (i = y0; i < y1; ++i, s += src_stride)
+        for (j = x0; j < x1; ++j) sum += s[j];
+      dst[x] = (sum + (count >> 1)) / count;
+    }
+    dst += dst_stride;
+  }
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+static void downscale_plane_high(const uint8_t *src8, int src_stride,
+                                 int src_w, int src_h, uint8_t *dst8,
+                                 int dst_stride, int dst_w, int dst_h,
+                                 int shift) {
+  const uint16_t *src = CONVERT_TO_SHORTPTR(src8);
+  uint16_t *dst = CONVERT_TO_SHORTPTR(dst8);
+  int x, y, i, j;
+
+  for (y = 0; y < dst_h; ++y) {
+    const int y0 = VPXMIN(y << shift, src_h - 1);
+    const int y1 = VPXMIN((y + 1) << shift, src_h);
+    for (x = 0; x < dst_w; ++x) {
+      const int x0 = VPXMIN(x << shift, src_w - 1);
+      const int x1 = VPXMIN((x + 1) << shift, src_w);
+      const int count = (y1 - y0) * (x1 - x0);
+      const uint16_t *s = src + y0 * src_stride;
+      int sum = 0;
+      for (i = y0; i < y1; ++i, s += src_stride)
+        for (j = x0; j < x1; ++j) sum += s[j];
+      dst[x] = (sum + (count >> 1)) / count;
+    }
+    dst += dst_stride;
+  }
+}
+#endif
+
+void vpx_yv12_downscale_frame(const YV12_BUFFER_CONFIG *src,
+                              YV12_BUFFER_CONFIG *dst, int shift) {
+  assert(shift >= 1 && shift <= 3);
+  assert(dst->y_crop_width == (src->y_crop_width + (1 << shift) - 1) >> shift);
+  assert(dst->y_crop_height ==
+         (src->y_crop_height + (1 << shift) - 1) >> shift);
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+    assert(dst->flags & YV12_FLAG_HIGHBITDEPTH);
+    downscale_plane_high(src->y_buffer, src->y_stride, src->y_crop_width,
+                         src->y_crop_height, dst->y_buffer, dst->y_stride,
+                         dst->y_crop_width, dst->y_crop_height, shift);
+    downscale_plane_high(src->u_buffer, src->uv_stride, src->uv_crop_width,
+                         src->uv_crop_height, dst->u_buffer, dst->uv_stride,
+                         dst->uv_crop_width, dst->uv_crop_height, shift);
+    downscale_plane_high(src->v_buffer, src->uv_stride, src->uv_crop_width,
+                         src->uv_crop_height, dst->v_buffer, dst->uv_stride,
+                         dst->uv_crop_width, dst->uv_crop_height, shift);
+    return;
+  }
+#endif
+
+  downscale_plane(src->y_buffer, src->y_stride, src->y_crop_width,
+                  src->y_crop_height, dst->y_buffer, dst->y_stride,
+                  dst->y_crop_width, dst->y_crop_height, shift);
+  downscale_plane(src->u_buffer, src->uv_stride, src->uv_crop_width,
+                  src->uv_crop_height, dst->u_buffer, dst->uv_stride,
+                  dst->uv_crop_width, dst->uv_crop_height, shift);
+  downscale_plane(src->v_buffer, src->uv_stride, src->uv_crop_width,
+                  src->uv_crop_height, dst->v_buffer, dst->uv_stride,
+                  dst->uv_crop_width, dst->uv_crop_height, shift);
+}
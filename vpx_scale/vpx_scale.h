@@ -13,10 +13,26 @@
 
 #include "vpx_scale/yv12config.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 extern void vpx_scale_frame(YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst,
                             unsigned char *temp_area, unsigned char temp_height,
                             unsigned int hscale, unsigned int hratio,
                             unsigned int vscale, unsigned int vratio,
                             unsigned int interlaced);
 
+/* Downscales the visible area of 'src' by (1 << shift) in both directions,
+ * shift being 1 to 3. 'dst' must have a visible size of the source size
+ * divided by the scaling factor, rounded up, and the same chroma subsampling
+ * and bit depth.
+ */
+void vpx_yv12_downscale_frame(const YV12_BUFFER_CONFIG *src,
+                              YV12_BUFFER_CONFIG *dst, int shift);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif  // VPX_SCALE_VPX_SCALE_H_
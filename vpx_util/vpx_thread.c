@@ -15,6 +15,7 @@
 #include <assert.h>
 #include <string.h>  // for memset()
 #include "./vpx_thread.h"
+#include "vpx/vp8dx.h"
 #include "vpx_mem/vpx_mem.h"
 
 #if CONFIG_MULTITHREAD
@@ -72,6 +73,187 @@ static void change_state(VPxWorker *const worker, VPxWorkerStatus new_status) {
   pthread_mutex_unlock(&worker->impl_->mutex_);
 }
 
+//------------------------------------------------------------------------------
+// Thread pool
+
+struct vpx_thread_pool {
+  pthread_mutex_t mutex_;
+  pthread_cond_t work_cond_;  // signaled when a group may be started
+  pthread_cond_t done_cond_;  // broadcast when a worker is done
+  pthread_t *threads_;
+  int num_threads_;
+  int num_idle_;
+  // Launched workers, in order. group_left_ is the number of workers of the
+  // group at the head of the queue left to start once it has been started.
+  VPxWorker *head_;
+  VPxWorker *tail_;
+  int group_left_;
+  int shutdown_;
+};
+
+static THREADFN pool_thread_loop(void *ptr) {
+  VPxWorkerPool *const pool = (VPxWorkerPool *)ptr;
+  pthread_mutex_lock(&pool->mutex_);
+  while (!pool->shutdown_) {
+    VPxWorker *const worker = pool->head_;
+    if (worker == NULL ||
+        (pool->group_left_ == 0 && worker->pool_group_ > pool->num_idle_)) {
+      pthread_cond_wait(&pool->work_cond_, &pool->mutex_);
+      continue;
+    }
+    if (pool->group_left_ == 0) {
+      // Start the group, the other idle threads pick up the rest of it.
+      pool->group_left_ = worker->pool_group_;
+      if (pool->group_left_ > 1) pthread_cond_broadcast(&pool->work_cond_);
+    }
+    --pool->group_left_;
+    pool->head_ = worker->pool_next_;
+    if (pool->head_ == NULL) pool->tail_ = NULL;
+    --pool->num_idle_;
+    pthread_mutex_unlock(&pool->mutex_);
+
+    execute(worker);
+
+    pthread_mutex_lock(&pool->mutex_);
+    ++pool->num_idle_;
+    worker->status_ = OK;
+    pthread_cond_broadcast(&pool->done_cond_);
+  }
+  pthread_mutex_unlock(&pool->mutex_);
+  return THREAD_RETURN(NULL);
+}
+
+// Waits for a worker attached to a pool to be done. Must be called with the
+// pool mutex held.
+static void pool_wait(VPxWorkerPool *const pool, VPxWorker *const worker) {
+  while (worker->status_ == WORK)
+    pthread_cond_wait(&pool->done_cond_, &pool->mutex_);
+}
+
+static void pool_sync(VPxWorker *const worker) {
+  VPxWorkerPool *const pool = worker->pool;
+  pthread_mutex_lock(&pool->mutex_);
+  pool_wait(pool, worker);
+  pthread_mutex_unlock(&pool->mutex_);
+}
+
+static void destroy_pool(VPxWorkerPool *const pool) {
+  int i;
+  pthread_mutex_lock(&pool->mutex_);
+  pool->shutdown_ = 1;
+  pthread_cond_broadcast(&pool->work_cond_);
+  pthread_mutex_unlock(&pool->mutex_);
+  for (i = 0; i < pool->num_threads_; ++i)
+    pthread_join(pool->threads_[i], NULL);
+  pthread_mutex_destroy(&pool->mutex_);
+  pthread_cond_destroy(&pool->work_cond_);
+  pthread_cond_destroy(&pool->done_cond_);
+  vpx_free(pool->threads_);
+  vpx_free(pool);
+}
+
+vpx_thread_pool_t *vpx_thread_pool_create(int num_threads) {
+  VPxWorkerPool *pool;
+  if (num_threads < 1) return NULL;
+  pool = (VPxWorkerPool *)vpx_calloc(1, sizeof(*pool));
+  if (pool == NULL) return NULL;
+  pool->threads_ =
+      (pthread_t *)vpx_calloc(num_threads, sizeof(*pool->threads_));
+  if (pool->threads_ == NULL) {
+    vpx_free(pool);
+    return NULL;
+  }
+  if (pthread_mutex_init(&pool->mutex_, NULL)) {
+    vpx_free(pool->threads_);
+    vpx_free(pool);
+    return NULL;
+  }
+  if (pthread_cond_init(&pool->work_cond_, NULL)) {
+    pthread_mutex_destroy(&pool->mutex_);
+    vpx_free(pool->threads_);
+    vpx_free(pool);
+    return NULL;
+  }
+  if (pthread_cond_init(&pool->done_cond_, NULL)) {
+    pthread_cond_destroy(&pool->work_cond_);
+    pthread_mutex_destroy(&pool->mutex_);
+    vpx_free(pool->threads_);
+    vpx_free(pool);
+    return NULL;
+  }
+  pthread_mutex_lock(&pool->mutex_);
+  while (pool->num_threads_ < num_threads) {
+    if (pthread_create(&pool->threads_[pool->num_threads_], NULL,
+                       pool_thread_loop, pool)) {
+      break;
+    }
+    ++pool->num_threads_;
+    ++pool->num_idle_;
+  }
+  pthread_mutex_unlock(&pool->mutex_);
+  if (pool->num_threads_ < num_threads) {
+    destroy_pool(pool);
+    return NULL;
+  }
+  return pool;
+}
+
+void vpx_thread_pool_destroy(vpx_thread_pool_t *pool) {
+  if (pool != NULL) {
+    assert(pool->head_ == NULL);
+    destroy_pool(pool);
+  }
+}
+
+int vpx_thread_pool_num_threads(const VPxWorkerPool *pool) {
+  return pool->num_threads_;
+}
+
+void vpx_thread_pool_launch(VPxWorkerPool *pool, VPxWorker *workers,
+                            int num_workers) {
+  int i;
+  assert(num_workers <= pool->num_threads_);
+  if (num_workers <= 0) return;
+  pthread_mutex_lock(&pool->mutex_);
+  for (i = 0; i < num_workers; ++i) {
+    VPxWorker *const worker = &workers[i];
+    assert(worker->pool == pool && worker->status_ >= OK);
+    pool_wait(pool, worker);
+    worker->status_ = WORK;
+    worker->pool_group_ = num_workers;
+    worker->pool_next_ = NULL;
+    if (pool->tail_ != NULL)
+      pool->tail_->pool_next_ = worker;
+    else
+      pool->head_ = worker;
+    pool->tail_ = worker;
+  }
+  pthread_cond_signal(&pool->work_cond_);
+  pthread_mutex_unlock(&pool->mutex_);
+}
+
+#else  // !CONFIG_MULTITHREAD
+
+vpx_thread_pool_t *vpx_thread_pool_create(int num_threads) {
+  (void)num_threads;
+  return NULL;
+}
+
+void vpx_thread_pool_destroy(vpx_thread_pool_t *pool) { (void)pool; }
+
+int vpx_thread_pool_num_threads(const VPxWorkerPool *pool) {
+  (void)pool;
+  return 0;
+}
+
+void vpx_thread_pool_launch(VPxWorkerPool *pool, VPxWorker *workers,
+                            int num_workers) {
+  (void)pool;
+  (void)workers;
+  (void)num_workers;
+  assert(0 && "Thread pools require CONFIG_MULTITHREAD");
+}
+
 #endif  // CONFIG_MULTITHREAD
 
 //------------------------------------------------------------------------------
@@ -83,7 +265,10 @@ static void init(VPxWorker *const worker) {
 
 static int sync(VPxWorker *const worker) {
 #if CONFIG_MULTITHREAD
-  change_state(worker, OK);
+  if (worker->pool != NULL)
+    pool_sync(worker);
+  else
+    change_state(worker, OK);
 #endif
   assert(worker->status_ <= OK);
   return !worker->had_error;
@@ -94,6 +279,10 @@ static int reset(VPxWorker *const worker) {
   worker->had_error = 0;
   if (worker->status_ < OK) {
 #if CONFIG_MULTITHREAD
+    if (worker->pool != NULL) {
+      worker->status_ = OK;
+      return 1;
+    }
     worker->impl_ = (VPxWorkerImpl *)vpx_calloc(1, sizeof(*worker->impl_));
     if (worker->impl_ == NULL) {
       return 0;
@@ -135,7 +324,10 @@ static void execute(VPxWorker *const worker) {
 
 static void launch(VPxWorker *const worker) {
 #if CONFIG_MULTITHREAD
-  change_state(worker, WORK);
+  if (worker->pool != NULL)
+    vpx_thread_pool_launch(worker->pool, worker, 1);
+  else
+    change_state(worker, WORK);
 #else
   execute(worker);
 #endif
@@ -143,7 +335,10 @@ static void launch(VPxWorker *const worker) {
 
 static void end(VPxWorker *const worker) {
 #if CONFIG_MULTITHREAD
-  if (worker->impl_ != NULL) {
+  if (worker->pool != NULL) {
+    if (worker->status_ > OK) pool_sync(worker);
+    worker->status_ = NOT_OK;
+  } else if (worker->impl_ != NULL) {
     change_state(worker, NOT_OK);
     pthread_join(worker->impl_->thread_, NULL);
     pthread_mutex_destroy(&worker->impl_->mutex_);
@@ -176,6 +176,23 @@ static INLINE int pthread_cond_signal(pthread_cond_t *const condition) {
   return !ok;
 }
 
+static INLINE int pthread_cond_broadcast(pthread_cond_t *const condition) {
+  int ok = 1;
+#ifdef USE_WINDOWS_CONDITION_VARIABLE
+  WakeAllConditionVariable(condition);
+#else
+  while (WaitForSingleObject(condition->waiting_sem_, 0) == WAIT_OBJECT_0) {
+    // a thread is waiting in pthread_cond_wait: allow it to be notified
+    ok &= SetEvent(condition->signal_event_);
+    // wait until the event is consumed so the signaler cannot consume
+    // the event via its own pthread_cond_wait.
+    ok &= (WaitForSingleObject(condition->received_sem_, INFINITE) ==
+           WAIT_OBJECT_0);
+  }
+#endif
+  return !ok;
+}
+
 static INLINE int pthread_cond_wait(pthread_cond_t *const condition,
                                     pthread_mutex_t *const mutex) {
   int ok;
@@ -361,14 +378,23 @@ typedef int (*VPxWorkerHook)(void *, void *);
 // Platform-dependent implementation details for the worker.
 typedef struct VPxWorkerImpl VPxWorkerImpl;
 
+// Pool of threads shared by the workers of several codec instances. This is
+// the vpx_thread_pool_t of the public API.
+typedef struct vpx_thread_pool VPxWorkerPool;
+
 // Synchronization object used to launch job in the worker thread
-typedef struct {
+typedef struct VPxWorker {
   VPxWorkerImpl *impl_;
   VPxWorkerStatus status_;
   VPxWorkerHook hook;  // hook to call
   void *data1;         // first argument passed to 'hook'
   void *data2;         // second argument passed to 'hook'
   int had_error;       // return value of the last call to 'hook'
+  // When set between init() and reset(), the worker has no thread of its own
+  // and is run by one of the pool threads once launched.
+  VPxWorkerPool *pool;
+  struct VPxWorker *pool_next_;  // next worker in the pool queue
+  int pool_group_;               // number of workers launched with this one
 } VPxWorker;
 
 // The interface for all thread-worker related functions. All these functions
@@ -406,6 +432,17 @@ int vpx_set_worker_interface(const VPxWorkerInterface *const winterface);
 // Retrieve the currently set thread worker interface.
 const VPxWorkerInterface *vpx_get_worker_interface(void);
 
+// Returns the number of threads of the pool.
+int vpx_thread_pool_num_threads(const VPxWorkerPool *pool);
+
+// Launches workers[0] to workers[num_workers - 1], which must all be attached
+// to 'pool', as a group: the pool only starts running them once it has a free
+// thread for each, so they may wait on each other. num_workers may not exceed
+// the number of threads of the pool. Groups are started in launch order.
+// Workers launched one at a time with launch() are groups of one.
+void vpx_thread_pool_launch(VPxWorkerPool *pool, VPxWorker *workers,
+                            int num_workers);
+
 //------------------------------------------------------------------------------
 
 #ifdef __cplusplus